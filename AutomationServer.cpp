@@ -0,0 +1,448 @@
+/*!
+ * @file AutomationServer.cpp
+ * @brief Implements the local control API for line-management software
+ *
+ * Every request is one JSON object on one line; every response is one
+ * JSON object on one line carrying the request's "id" (if any) and "ok".
+ *
+ *   {"op":"start", "serial":"SG12345", "operator":"jgp"}
+ *       queues a calibration, returns {"job":N, "position":P}
+ *   {"op":"status"}              returns the queue and the running job
+ *   {"op":"status", "job":N}     returns the state of one job
+ *   {"op":"result", "job":N}     returns the result of a finished job
+ *   {"op":"subscribe"}           the connection then also receives events:
+ *       {"event":"started",  "job":N}
+ *       {"event":"status",   "job":N, "text":"..."}
+ *       {"event":"finished", "job":N, "result":{...}}
+ *
+ * A queued calibration starts when the scope is detected in the fixture
+ * and the previous unit has been removed, as in production mode.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include "AutomationServer.h"
+
+//
+// Finished jobs kept for "result" requests
+//
+const int c_maxFinishedJobs = 100;
+
+//
+// Names of the job states, in the order of CAutomationJob::State
+//
+static const char *c_stateName[] = { "queued", "running", "passed", "failed" };
+
+
+CAutomationJob::CAutomationJob()
+{
+    m_id = 0;
+    m_state = State_Queued;
+}
+
+
+/*!
+ * @brief constructor
+ *
+ * @param[in] serverName - name of the local server, e.g. "LED_cal"
+ * @param[in] parent - owner of the server
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CAutomationServer::CAutomationServer(QString serverName, QObject *parent) :
+    QObject(parent)
+{
+    m_nextId = 1;
+    m_runningJob = 0;
+
+    m_server = new QLocalServer(this);
+    connect(m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    QLocalServer::removeServer(serverName);
+    m_server->listen(serverName);
+}
+
+
+CAutomationServer::~CAutomationServer()
+{
+}
+
+
+bool CAutomationServer::isListening() const
+{
+    return(m_server->isListening());
+}
+
+
+bool CAutomationServer::hasPendingJob() const
+{
+    if (m_runningJob != 0)
+    {
+        return(false);
+    }
+    for (int i=0; i<m_jobs.size(); i++)
+    {
+        if (m_jobs[i].m_state == CAutomationJob::State_Queued)
+        {
+            return(true);
+        }
+    }
+    return(false);
+}
+
+
+/*!
+ * @brief hands the oldest queued job to the caller, which must run it
+ *
+ * @param[out] id - id of the job
+ * @param[out] serialNumber - unit to calibrate
+ * @param[out] operatorName - operator, empty if not given in the request
+ * @return false if there is no queued job or a job is still running
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CAutomationServer::takeNextJob(int *id, QString *serialNumber, QString *operatorName)
+{
+    if (m_runningJob != 0)
+    {
+        return(false);
+    }
+    for (int i=0; i<m_jobs.size(); i++)
+    {
+        CAutomationJob &job = m_jobs[i];
+        if (job.m_state == CAutomationJob::State_Queued)
+        {
+            job.m_state = CAutomationJob::State_Running;
+            m_runningJob = job.m_id;
+            *id = job.m_id;
+            *serialNumber = job.m_serialNumber;
+            *operatorName = job.m_operator;
+
+            QJsonObject event;
+            event["event"] = QString("started");
+            event["job"] = job.m_id;
+            event["serial"] = job.m_serialNumber;
+            broadcast(event);
+            return(true);
+        }
+    }
+    return(false);
+}
+
+
+/*!
+ * @brief forwards a status message of the engine to the subscribers
+ *
+ * Messages that arrive while no job is running, e.g. from a calibration
+ * started with the Start button, are ignored.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CAutomationServer::jobStatusChanged(QString text)
+{
+    CAutomationJob *job = findJob(m_runningJob);
+    if (!job)
+    {
+        return;
+    }
+    job->m_status = text;
+
+    QJsonObject event;
+    event["event"] = QString("status");
+    event["job"] = job->m_id;
+    event["text"] = text;
+    broadcast(event);
+}
+
+
+void CAutomationServer::jobFinished(CCalibrationResult result)
+{
+    CAutomationJob *job = findJob(m_runningJob);
+    m_runningJob = 0;
+    if (!job)
+    {
+        return;
+    }
+    job->m_state = result.m_success ? CAutomationJob::State_Passed : CAutomationJob::State_Failed;
+    job->m_result = result;
+
+    QJsonObject event;
+    event["event"] = QString("finished");
+    event["job"] = job->m_id;
+    event["result"] = result.toJson();
+    broadcast(event);
+
+    expireJobs();
+}
+
+
+void CAutomationServer::onNewConnection()
+{
+    QLocalSocket *socket;
+    while ((socket = m_server->nextPendingConnection()) != 0)
+    {
+        connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    }
+}
+
+
+void CAutomationServer::onReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket)
+    {
+        return;
+    }
+
+    while (socket->canReadLine())
+    {
+        QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty())
+        {
+            continue;
+        }
+
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (!doc.isObject())
+        {
+            QJsonObject response;
+            response["ok"] = false;
+            response["error"] = QString("request is not a JSON object: %1").arg(error.errorString());
+            send(socket, response);
+            continue;
+        }
+
+        QJsonObject request = doc.object();
+        QJsonObject response = handleRequest(socket, request);
+        if (request.contains("id"))
+        {
+            response["id"] = request["id"];
+        }
+        send(socket, response);
+    }
+}
+
+
+void CAutomationServer::onDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    m_subscribers.removeAll(socket);
+    if (socket)
+    {
+        socket->deleteLater();
+    }
+}
+
+
+/*!
+ * @brief carries out one request
+ *
+ * @param[in] socket - connection the request came from
+ * @param[in] request - the request
+ * @return the response, without the request id
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QJsonObject CAutomationServer::handleRequest(QLocalSocket *socket, const QJsonObject &request)
+{
+    QJsonObject response;
+    QString op = request["op"].toString();
+    response["ok"] = true;
+
+    if (op == "start")
+    {
+        QString serialNumber = request["serial"].toString().trimmed();
+        if (serialNumber.isEmpty())
+        {
+            response["ok"] = false;
+            response["error"] = QString("\"serial\" is required");
+            return(response);
+        }
+
+        CAutomationJob job;
+        job.m_id = m_nextId++;
+        job.m_serialNumber = serialNumber;
+        job.m_operator = request["operator"].toString().trimmed();
+        m_jobs.append(job);
+
+        response["job"] = job.m_id;
+        response["position"] = queuePosition(job.m_id);
+    }
+    else if (op == "status")
+    {
+        if (request.contains("job"))
+        {
+            CAutomationJob *job = findJob(request["job"].toInt());
+            if (!job)
+            {
+                response["ok"] = false;
+                response["error"] = QString("unknown job");
+                return(response);
+            }
+            response["job"] = jobToJson(*job);
+        }
+        else
+        {
+            QJsonArray queued;
+            for (int i=0; i<m_jobs.size(); i++)
+            {
+                if (m_jobs[i].m_state == CAutomationJob::State_Queued)
+                {
+                    queued.append(jobToJson(m_jobs[i]));
+                }
+            }
+            response["queued"] = queued;
+            CAutomationJob *running = findJob(m_runningJob);
+            if (running)
+            {
+                response["running"] = jobToJson(*running);
+            }
+        }
+    }
+    else if (op == "result")
+    {
+        CAutomationJob *job = findJob(request["job"].toInt());
+        if (!job)
+        {
+            response["ok"] = false;
+            response["error"] = QString("unknown job");
+        }
+        else if ((job->m_state != CAutomationJob::State_Passed) && (job->m_state != CAutomationJob::State_Failed))
+        {
+            response["ok"] = false;
+            response["error"] = QString("job has not finished");
+            response["state"] = QString(c_stateName[job->m_state]);
+        }
+        else
+        {
+            response["result"] = job->m_result.toJson();
+        }
+    }
+    else if (op == "subscribe")
+    {
+        if (!m_subscribers.contains(socket))
+        {
+            m_subscribers.append(socket);
+        }
+    }
+    else
+    {
+        response["ok"] = false;
+        response["error"] = QString("unknown op \"%1\"").arg(op);
+    }
+
+    return(response);
+}
+
+
+QJsonObject CAutomationServer::jobToJson(const CAutomationJob &job) const
+{
+    QJsonObject json;
+    json["id"] = job.m_id;
+    json["serial"] = job.m_serialNumber;
+    json["state"] = QString(c_stateName[job.m_state]);
+    if (job.m_state == CAutomationJob::State_Queued)
+    {
+        json["position"] = queuePosition(job.m_id);
+    }
+    if (!job.m_status.isEmpty())
+    {
+        json["status"] = job.m_status;
+    }
+    return(json);
+}
+
+
+CAutomationJob *CAutomationServer::findJob(int id)
+{
+    for (int i=0; i<m_jobs.size(); i++)
+    {
+        if (m_jobs[i].m_id == id)
+        {
+            return(&m_jobs[i]);
+        }
+    }
+    return(0);
+}
+
+
+/*!
+ * @brief returns the number of queued jobs ahead of a job
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CAutomationServer::queuePosition(int id) const
+{
+    int position = 0;
+    for (int i=0; i<m_jobs.size(); i++)
+    {
+        if (m_jobs[i].m_id == id)
+        {
+            break;
+        }
+        if (m_jobs[i].m_state == CAutomationJob::State_Queued)
+        {
+            position++;
+        }
+    }
+    return(position);
+}
+
+
+void CAutomationServer::send(QLocalSocket *socket, const QJsonObject &message)
+{
+    QByteArray line = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    socket->write(line);
+}
+
+
+void CAutomationServer::broadcast(const QJsonObject &event)
+{
+    for (int i=0; i<m_subscribers.size(); i++)
+    {
+        send(m_subscribers[i], event);
+    }
+}
+
+
+/*!
+ * @brief drops the oldest finished jobs beyond c_maxFinishedJobs
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CAutomationServer::expireJobs()
+{
+    int finished = 0;
+    for (int i=m_jobs.size()-1; i>=0; i--)
+    {
+        if ((m_jobs[i].m_state == CAutomationJob::State_Passed) || (m_jobs[i].m_state == CAutomationJob::State_Failed))
+        {
+            finished++;
+            if (finished > c_maxFinishedJobs)
+            {
+                m_jobs.removeAt(i);
+            }
+        }
+    }
+}
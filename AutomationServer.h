@@ -0,0 +1,106 @@
+/*!
+ * @file AutomationServer.h
+ * @brief Declares the local control API for line-management software
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef AUTOMATIONSERVER_H
+#define AUTOMATIONSERVER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QJsonObject>
+#include "CalibrationEngine.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+
+/*!
+ * A calibration requested through the API.
+ */
+class CAutomationJob
+{
+public:
+    enum State
+    {
+        State_Queued,
+        State_Running,
+        State_Passed,
+        State_Failed
+    };
+
+public:
+    CAutomationJob();
+
+public:
+    int     m_id;
+    QString m_serialNumber;
+    QString m_operator;         // empty to use the operator entered in the main window
+    State   m_state;
+    QString m_status;           // last status reported by the engine
+    CCalibrationResult m_result;    // valid when passed or failed
+};
+
+
+/*!
+ * Request/response API on a QLocalServer (a Unix-domain socket on Linux,
+ * a named pipe on Windows).  Requests and responses are single-line JSON
+ * objects; see AutomationServer.cpp for the operations.
+ *
+ * The server only queues the requests.  The main window takes them with
+ * takeNextJob() and runs them with its own engine, exactly like a
+ * calibration started with the Start button, and reports back through
+ * jobStatusChanged() and jobFinished().
+ */
+class CAutomationServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CAutomationServer(QString serverName, QObject *parent = 0);
+    ~CAutomationServer();
+
+    bool    isListening() const;
+    bool    hasPendingJob() const;
+    bool    takeNextJob(int *id, QString *serialNumber, QString *operatorName);
+    int     runningJob() const { return(m_runningJob); }
+
+public slots:
+    void    jobStatusChanged(QString text);
+    void    jobFinished(CCalibrationResult result);
+
+private slots:
+    void    onNewConnection();
+    void    onReadyRead();
+    void    onDisconnected();
+
+private:
+    QJsonObject handleRequest(QLocalSocket *socket, const QJsonObject &request);
+    QJsonObject jobToJson(const CAutomationJob &job) const;
+    CAutomationJob *findJob(int id);
+    int     queuePosition(int id) const;
+    void    send(QLocalSocket *socket, const QJsonObject &message);
+    void    broadcast(const QJsonObject &event);
+    void    expireJobs();
+
+private:
+    QLocalServer          *m_server;
+    QList<CAutomationJob>  m_jobs;          // queued, running and recently finished
+    QList<QLocalSocket *>  m_subscribers;   // clients receiving progress events
+    int                    m_nextId;
+    int                    m_runningJob;    // id of the job being run, 0 if none
+};
+
+#endif // AUTOMATIONSERVER_H
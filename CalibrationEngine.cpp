@@ -0,0 +1,2523 @@
+/*!
+ * @file CalibrationEngine.cpp
+ * @brief Implements the calibration sequence for a single controller
+ *
+ * This code used to live in the MainWindow class.  It was moved here so that
+ * several controllers can be calibrated at the same time, each by its own
+ * engine.  The sequence is a state machine run by the event loop of the
+ * engine's thread.  It never waits on the controller, but the run history,
+ * the drift check and the journal still go to the disk, so every station's
+ * engine is given a thread of its own.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version, moved out of MainWindow
+ *   2      | agent        | 10/18/2026  | calibration sequence as a non-blocking state machine
+ *   3      | agent        | 10/18/2026  | search windows, current limit, delays and timeouts from the calibration profile
+ *   4      | agent        | 10/18/2026  | any number of LED channels, high thresholds searched together
+ *   5      | agent        | 10/18/2026  | commands and responses through the controller protocol
+ *   6      | agent        | 10/18/2026  | check of the saved calibration
+ *   7      | agent        | 10/18/2026  | binary trace of the serial traffic and the measurements
+ *   8      | agent        | 10/18/2026  | precise settle delays in real-time mode, settle wakeup latency
+ *
+*/
+
+#include <QJsonArray>
+#include <QFileInfo>
+#include <QRegExp>
+#include "CalibrationEngine.h"
+#include "Metrics.h"
+
+//
+// Names of the timed steps, as used in the reports
+//
+const char *c_timingName[TIMING_PHASES] =
+{
+    "connect", "version", "scope", "searchLow", "searchHigh", "save", "check"
+};
+
+/*!
+ * @brief constructor for the CCalibrationResult class
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CCalibrationResult::CCalibrationResult()
+{
+    m_channels = LED_CHANNELS_DEFAULT;
+    for (int c=0; c<LED_CHANNELS_MAX; c++)
+    {
+        m_oldLow[c] = m_oldHigh[c] = -1;
+        m_low[c] = m_high[c] = -1;
+        m_I[c] = m_V[c] = 0.0;
+    }
+    m_totalExposure = 0;
+    m_success = false;
+    m_saveCheck = -1;
+    m_failedPhase = -1;
+    m_durationMs = 0;
+    for (int i=0; i<TIMING_PHASES; i++)
+    {
+        m_phaseMs[i] = -1;
+    }
+}
+
+
+/*!
+ * @brief returns the result as a JSON object
+ *
+ * This is the machine-readable form used by the command line mode.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QJsonObject CCalibrationResult::toJson() const
+{
+    QJsonObject firmware;
+    firmware["ARM"] = m_versionARM;
+    firmware["DSP"] = m_versionDSP;
+    firmware["FPGA"] = m_versionFPGA;
+
+    QJsonObject before;
+    QJsonObject after;
+    for (int c=0; c<m_channels; c++)
+    {
+        before[QString("low%1").arg(c+1)] = m_oldLow[c];
+        before[QString("high%1").arg(c+1)] = m_oldHigh[c];
+        after[QString("low%1").arg(c+1)] = m_low[c];
+        after[QString("high%1").arg(c+1)] = m_high[c];
+    }
+
+    QJsonObject json;
+    json["station"] = m_station;
+    json["operator"] = m_operator;
+    json["serialNumber"] = m_serialNumber;
+    json["profile"] = m_profile;
+    json["protocol"] = m_protocol;
+    json["firmware"] = firmware;
+    json["ledCalBefore"] = before;
+    json["ledCalAfter"] = after;
+    json["channels"] = m_channels;
+    for (int c=0; c<m_channels; c++)
+    {
+        json[QString("I%1").arg(c+1)] = m_I[c];
+        json[QString("V%1").arg(c+1)] = m_V[c];
+    }
+    json["totalExposure"] = m_totalExposure;
+    json["success"] = m_success;
+    if (m_saveCheck >= 0)
+    {
+        json["saveCheck"] = (m_saveCheck == 1);
+    }
+    json["error"] = m_error;
+    if (m_failedPhase >= 0)
+    {
+        json["failedPhase"] = c_timingName[m_failedPhase];
+    }
+    json["alerts"] = QJsonArray::fromStringList(m_alerts);
+
+    QJsonObject phases;
+    for (int i=0; i<TIMING_PHASES; i++)
+    {
+        if (m_phaseMs[i] >= 0)
+        {
+            phases[c_timingName[i]] = (double)m_phaseMs[i];
+        }
+    }
+    json["startTime"] = m_startTime.toString(Qt::ISODate);
+    json["durationMs"] = (double)m_durationMs;
+    json["phaseMs"] = phases;
+    return(json);
+}
+
+
+/*!
+ * @brief constructor for the calibration engine
+ *
+ * @param[in] settings - application settings, must outlive the engine
+ * @param[in] parent - owner of the engine
+ * @return none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CCalibrationEngine::CCalibrationEngine(CSettings *settings, QObject *parent) :
+    QObject(parent),
+    m_settings(settings),
+    m_serialBuffer(this),
+    m_waitTimer(this)
+{
+    qRegisterMetaType<CCalibrationResult>("CCalibrationResult");
+    qRegisterMetaType< QVector<double> >("QVector<double>");
+    qRegisterMetaType< QVector<int> >("QVector<int>");
+
+    m_profile = m_settings->profile();
+    m_channels = m_profile.m_channels;
+    m_protocol = CControllerProtocol::select(m_settings->m_protocol);
+    if (!m_protocol)
+    {
+        m_protocol = CControllerProtocol::select(PROTOCOL_AUTO);
+    }
+    m_stream.setProtocol(m_protocol);
+    m_exposure.setDepth(m_settings->m_exposureFrames);
+    m_serialBuffer.setLinkParameters(CLinkParameters::fromSettings(m_settings));
+    m_serialBuffer.setTimeout(m_profile.m_responseTimeoutMS);
+
+    m_totalExposure = 0;
+    m_streaming = false;
+    m_streamExposureSeen = 0;
+    m_streamVoltageSeen = 0;
+    m_monitoring = false;
+    m_monitorOk = true;
+    m_pollState = Poll_NoSerialPort;
+    resetMonitor();
+
+    m_state = Run_Idle;
+    m_waiting = false;
+    m_streamWait = Wait_None;
+    m_replyOk = false;
+    m_confirmPending = false;
+    m_phase = 0;
+    m_searchValue = -1;
+    m_X1 = m_X2 = m_M = 0;
+    m_batchRound = 0;
+    m_saveChannel = 0;
+    m_checkChannel = -1;
+    m_verifyLow = m_verifyHigh = 0;
+    m_verifySkipHigh = m_verifyBelow = m_verifyOk = m_verifyHolds = false;
+    m_verifyReturn = Run_Idle;
+    m_probeOk = m_probeBelow = false;
+    m_probeReturn = Run_Idle;
+    for (int c=0; c<LED_CHANNELS_MAX; c++)
+    {
+        m_measureDac[c] = 0;
+    }
+    m_measureFrame = 0;
+    m_measureOk = false;
+    m_measureReturn = Run_Idle;
+    m_commandIndex = 0;
+    m_commandsOk = false;
+    m_commandsReturn = Run_Idle;
+    m_linkOk = false;
+    m_linkIndex = 0;
+    m_linkRate = m_linkPrevious = 0;
+    m_linkChecks = 0;
+    m_linkReturn = Run_Idle;
+
+    m_settleMS = -1;
+    m_waitTimer.setSingleShot(true);
+    m_waitTimer.setTimerType(m_settings->m_realTimeEnabled ? Qt::PreciseTimer : Qt::CoarseTimer);
+    connect(&m_waitTimer, SIGNAL(timeout()), this, SLOT(onWaitTimeout()));
+    connect(&m_serialBuffer, SIGNAL(transactionFinished(bool,QStringList)),
+            this, SLOT(onTransactionFinished(bool,QStringList)));
+    connect(&m_serialBuffer, SIGNAL(eventsReceived()), this, SLOT(onStreamEvents()));
+}
+
+
+void CCalibrationEngine::setSerialPortName(QString name)
+{
+    if (name != m_serialPortName)
+    {
+        cancelMonitor();
+        resetMonitor();
+        m_trace.close();
+    }
+    m_serialPortName = name;
+}
+
+/*!
+ * @brief destructor
+ *
+ * A run still in progress is abandoned with the LEDs turned off; its
+ * journal lets the next calibration of the unit resume.  A controller
+ * switched to a faster rate is told to go back to its default rate so
+ * other programs can talk to it.  None of the commands waits for its
+ * echo; they go out as the port is closed.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CCalibrationEngine::~CCalibrationEngine()
+{
+    bool running = isRunning();
+    cancelMonitor();
+    if (running)
+    {
+        m_state = Run_Idle;
+        m_waitTimer.stop();
+        m_serialBuffer.cancelTransaction();
+        m_journal.close();
+        m_serialBuffer.writeCommand("led=0");
+    }
+
+    if (    m_serialBuffer.isOpen()
+         && !m_settings->m_linkBaudCommand.isEmpty()
+         && (m_serialBuffer.baudRate() != m_settings->m_linkBaudRate) )
+    {
+        if (m_streaming)
+        {
+            QStringList commands = m_settings->m_streamStopCommands;
+            for (int i=0; i<commands.size(); i++)
+            {
+                m_serialBuffer.writeCommand(commands[i]);
+            }
+        }
+        m_serialBuffer.writeCommand(m_settings->m_linkBaudCommand.arg(m_settings->m_linkBaudRate));
+    }
+}
+
+
+/*!
+ * @brief reports an error and records it in the result
+ *
+ * The step that failed is the first one that has not ended yet.
+ *
+ * @param[in] msg - message for the operator
+ * @return none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::fail(QString msg)
+{
+    m_result.m_error = msg;
+    m_result.m_failedPhase = TIMING_PHASES - 1;
+    for (int i=0; i<TIMING_PHASES; i++)
+    {
+        if (m_result.m_phaseMs[i] < 0)
+        {
+            m_result.m_failedPhase = i;
+            break;
+        }
+    }
+    emit errorOccurred(msg);
+}
+
+
+/*!
+ * @brief takes the controller protocol named in the settings for the run
+ *
+ * With "auto" the first compiled-in protocol is used until the response
+ * to the version command tells which one the controller speaks.
+ *
+ * @return false if no protocol of that name is compiled in
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::selectProtocol()
+{
+    const CControllerProtocol *protocol = CControllerProtocol::select(m_settings->m_protocol);
+    if (!protocol)
+    {
+        fail(QString("Unknown controller protocol \"%1\".\n\nKnown protocols: %2, or %3.")
+             .arg(m_settings->m_protocol)
+             .arg(CControllerProtocol::names().join(", "))
+             .arg(PROTOCOL_AUTO));
+        return(false);
+    }
+    setProtocol(protocol);
+    return(true);
+}
+
+
+/*!
+ * @brief speaks the given protocol to the controller from now on
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::setProtocol(const CControllerProtocol *protocol)
+{
+    m_protocol = protocol;
+    m_stream.setProtocol(protocol);
+    m_result.m_protocol = protocol->m_name;
+}
+
+
+/*!
+ * @brief records the time spent in a step of the calibration
+ *
+ * @param[in] timing - one of the CalibrationTiming values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::endTiming(int timing)
+{
+    m_result.m_phaseMs[timing] = m_phaseTimer.restart();
+}
+
+
+/*!
+ * @brief forgets the monitor's connection and cached data
+ *
+ * The next pass of the monitor reopens the port and reads the static data
+ * again.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::resetMonitor()
+{
+    m_monitorConnected = false;
+    m_monitorScope = false;
+    m_monitorVoltage.invalidate();
+    m_monitorExposure.invalidate();
+    m_monitorDac.invalidate();
+
+    //
+    // The events stop being read with the connection; whoever reopens the
+    // port initializes the controller again.
+    //
+    m_serialBuffer.setEventFilter(0);
+    m_serialBuffer.setEventNotification(false);
+    m_streaming = false;
+}
+
+
+/*!
+ * @brief checks whether a quantity of the idle monitor is due to be read
+ *
+ * @param[in,out] last - time of the last reading, restarted if due
+ * @param[in] intervalMS - interval between readings
+ * @return true if the quantity should be read now
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::monitorDue(QElapsedTimer &last, int intervalMS)
+{
+    if (last.isValid() && !last.hasExpired(intervalMS))
+    {
+        return(false);
+    }
+    last.start();
+    return(true);
+}
+
+
+/*!
+ * @brief starts a pass of the idle monitor
+ *
+ * Does nothing while a calibration or another pass is in progress.  The
+ * pass runs from the event loop like a calibration (see stepMonitor()) and
+ * ends with monitorStateChanged(), never from within this call.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::poll()
+{
+    if (m_state != Run_Idle)
+    {
+        return;
+    }
+
+    m_monitoring = true;
+    m_state = Monitor_Begin;
+    m_streamWait = Wait_None;
+    m_waiting = true;
+    m_settleMS = -1;
+    m_waitTimer.start(0);
+}
+
+
+/*!
+ * @brief ends the pass of the idle monitor and reports the state of the controller
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::endMonitor(PollState state)
+{
+    m_pollState = state;
+    m_monitoring = false;
+    m_state = Run_Idle;
+
+    //
+    // Idle before the signal, so a receiver can start a calibration from it
+    //
+    emit monitorStateChanged(state);
+}
+
+
+/*!
+ * @brief abandons the pass of the idle monitor in progress, if any
+ *
+ * Nothing is reported; the next pass starts over where this one was.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::cancelMonitor()
+{
+    if (!m_monitoring)
+    {
+        return;
+    }
+
+    m_serialBuffer.cancelTransaction();
+    m_waitTimer.stop();
+    m_settleMS = -1;
+    m_streamWait = Wait_None;
+    m_waiting = false;
+    m_monitoring = false;
+    m_state = Run_Idle;
+}
+
+
+/*!
+ * @brief checks that the controller echoes
+ *
+ * If it does not, it may have been left at a faster rate by an earlier
+ * session, so the negotiable rates and the default rate are tried as well.
+ * m_linkOk tells whether the controller echoed when the run resumes at
+ * next; the port is left at the rate it echoed at.
+ *
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::connectLink(int next)
+{
+    m_linkOk = false;
+    m_linkRates = CLinkParameters::fastRates(m_settings);
+    m_linkRates.append(m_settings->m_linkBaudRate);
+    m_linkIndex = 0;
+    m_linkPrevious = m_serialBuffer.baudRate();
+    m_linkReturn = next;
+    send("", 0, Link_Echo);
+}
+
+
+/*!
+ * @brief moves the link to the fastest rate that works
+ *
+ * Does nothing unless a command to change the rate is configured.  A rate
+ * that fails falls back to the current one, so this never loses the
+ * controller.
+ *
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::negotiateLink(int next)
+{
+    m_state = next;
+    QList<qint32> rates = CLinkParameters::fastRates(m_settings);
+    if (rates.isEmpty() || (m_serialBuffer.baudRate() >= rates.first()))
+    {
+        return;
+    }
+
+    emit statusChanged("Negotiating link speed...");
+    m_linkRates = rates;
+    m_linkIndex = 0;
+    m_linkPrevious = m_serialBuffer.baudRate();
+    m_linkReturn = next;
+    m_state = Negotiate_Next;
+}
+
+
+/*!
+ * @brief turns the controller's events on and reads them into m_stream
+ *
+ * m_commandsOk tells whether the controller accepted the commands when the
+ * run resumes at next.
+ *
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::startStream(int next)
+{
+    m_stream.clear();
+    m_serialBuffer.setEventFilter(&m_stream);
+    m_streaming = true;
+    m_streamExposureSeen = m_stream.exposureCount();
+    m_streamVoltageSeen = m_stream.voltageCount();
+    sendCommands(m_settings->m_streamStartCommands, next);
+}
+
+
+/*!
+ * @brief parses the response to "led_cal" and reports the stored values
+ *
+ * @param[in] calString - the response line
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+void CCalibrationEngine::parseCalibrationValues(QString calString)
+{
+    int storedLow[LED_CHANNELS_MAX];
+    int storedHigh[LED_CHANNELS_MAX];
+    int found = m_protocol->parseCalibration(calString, storedLow, storedHigh);
+
+    QVector<int> low(m_channels, -1);
+    QVector<int> high(m_channels, -1);
+    for (int c=0; (c<m_channels) && (c<found); c++)
+    {
+        low[c] = storedLow[c];
+        high[c] = storedHigh[c];
+    }
+
+    for (int c=0; c<m_channels; c++)
+    {
+        m_result.m_oldLow[c] = low[c];
+        m_result.m_oldHigh[c] = high[c];
+    }
+    emit storedCalibrationChanged(low, high);
+}
+
+
+/*!
+ * @brief returns the name of a search phase for the operator, e.g. "LED 2 high"
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QString CCalibrationEngine::phaseName(int phase) const
+{
+    return(QString("LED %1 %2").arg(phaseChannel(phase)+1).arg(highPhase(phase) ? "high" : "low"));
+}
+
+
+/*!
+ * @brief returns the DAC codes searched in a phase, lowest first
+ *
+ * @param[in] phase - search phase
+ * @return the two ends of the window of the run's profile
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+const int *CCalibrationEngine::searchWindow(int phase) const
+{
+    return(highPhase(phase) ? m_profile.m_highWindow : m_profile.m_lowWindow);
+}
+
+
+/*!
+ * @brief checks the last measurement against the threshold of a phase
+ *
+ * The low threshold is the highest code that gives no exposure, the high
+ * threshold the highest code that draws no more than the profile's
+ * current limit.
+ *
+ * @param[in] phase - search phase
+ * @return true if the current DAC code is at or below the threshold
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::belowThreshold(int phase)
+{
+    if (!highPhase(phase))
+    {
+        return(m_totalExposure == 0);
+    }
+    return(m_channel[phaseChannel(phase)].m_I <= m_profile.m_currentLimit);
+}
+
+
+/*!
+ * @brief reports the thresholds found so far, -1 for those not found yet
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::emitNewCalibration()
+{
+    QVector<int> low(m_channels);
+    QVector<int> high(m_channels);
+    for (int c=0; c<m_channels; c++)
+    {
+        low[c] = m_channel[c].m_low;
+        high[c] = m_channel[c].m_high;
+    }
+    emit newCalibrationChanged(low, high);
+}
+
+
+/*!
+ * @brief returns the firmware versions of the controller as "ARM/DSP/FPGA"
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QString CCalibrationEngine::firmware() const
+{
+    return(QString("%1/%2/%3").arg(m_result.m_versionARM)
+                              .arg(m_result.m_versionDSP)
+                              .arg(m_result.m_versionFPGA));
+}
+
+
+QString CCalibrationEngine::fixtureName() const
+{
+    return(m_settings->m_fixtureName.isEmpty() ? m_serialPortName : m_settings->m_fixtureName);
+}
+
+
+/*!
+ * @brief opens the history on first use
+ *
+ * The history is opened from the thread the engine runs in so the database
+ * connection belongs to that thread.  The drift monitor is primed with the
+ * recent results of this fixture so it does not start cold every session.
+ *
+ * @return true if the history is open
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::openHistory()
+{
+    if (m_history.isOpen())
+    {
+        return(true);
+    }
+    if (m_settings->m_historyFile.isEmpty() || !m_history.open(m_settings->m_historyFile))
+    {
+        return(false);
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+    QList<CCalibrationResult> recent = m_history.findByTime(now.addDays(-7), now, 5000);
+    QString fixture = fixtureName();
+    m_drift.clear();
+    for (int i=0; i<recent.size(); i++)
+    {
+        if (recent[i].m_station == fixture)
+        {
+            m_drift.update(recent[i]);
+        }
+    }
+    return(true);
+}
+
+
+/*!
+ * @brief opens the trace of this station on first use
+ *
+ * Each station gets its own file, named after the trace file with the
+ * port name appended as for the report file.  A file that can not be
+ * opened, or is not a trace, leaves the station untraced.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::openTrace()
+{
+    if (m_trace.isOpen() || m_settings->m_traceFile.isEmpty())
+    {
+        return;
+    }
+
+    QFileInfo info(m_settings->m_traceFile);
+    QString port = m_serialPortName.section(QRegExp("[/\\\\]"), -1);
+    QString fileName = info.path() + "/" + info.completeBaseName() + "_" + port;
+    if (!info.suffix().isEmpty())
+    {
+        fileName += "." + info.suffix();
+    }
+    if (m_trace.open(fileName))
+    {
+        m_serialBuffer.setTrace(&m_trace);
+    }
+}
+
+
+/*!
+ * @brief loads the search windows of this fixture and firmware from the history
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::loadSearchPriors()
+{
+    m_prior = CSearchPrior();
+    openHistory();
+    m_history.searchPriors(firmware(), fixtureName(), m_channels, &m_prior);
+}
+
+
+/*!
+ * @brief adds the result of the run to the history
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::recordHistory()
+{
+    openHistory();
+    m_history.record(m_result, fixtureName());
+}
+
+
+/*!
+ * @brief starts a complete calibration of the attached controller
+ *
+ * The operator, serial number and serial port must have been set first.
+ * The run proceeds from the event loop; calibrationFinished() is emitted
+ * with the result in all cases, never from within this call.
+ *
+ * A pass of the idle monitor still in progress is abandoned.
+ *
+ * @param[in] none
+ * @param[out] none
+ * @return false if a calibration is already running
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::start()
+{
+    if (isRunning())
+    {
+        return(false);
+    }
+
+    //
+    // The calibration reopens the port and changes the stored values
+    //
+    cancelMonitor();
+    resetMonitor();
+
+    m_result = CCalibrationResult();
+    m_result.m_station = m_serialPortName;
+    m_result.m_operator = m_operator;
+    m_result.m_serialNumber = m_serialNumber;
+    m_result.m_startTime = QDateTime::currentDateTime();
+    m_result.m_channels = m_channels;
+    m_runTimer.start();
+    m_phaseTimer.start();
+
+    //
+    // The first step runs from the event loop like all the others
+    //
+    m_state = Run_Open;
+    m_streamWait = Wait_None;
+    m_confirmPending = false;
+    m_waiting = true;
+    m_settleMS = -1;
+    m_waitTimer.start(0);
+    return(true);
+}
+
+
+/*!
+ * @brief starts a calibration of the given unit
+ *
+ * For callers in another thread, which can not set the operator and the
+ * serial number first.
+ *
+ * @param[in] operatorName - operator running the calibration
+ * @param[in] serialNumber - serial number of the unit
+ * @return false if a calibration is already running
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::start(QString operatorName, QString serialNumber)
+{
+    if (isRunning())
+    {
+        return(false);
+    }
+    setOperator(operatorName);
+    setSerialNumber(serialNumber);
+    return(start());
+}
+
+
+/*!
+ * @brief answers the question of confirmationRequested()
+ *
+ * The run waits for the answer without a timeout.  It goes on from the
+ * event loop, never from within this call, so the receiver of the signal
+ * may answer straight from its slot.
+ *
+ * @param[in] proceed - true if the run may go on
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::confirm(bool proceed)
+{
+    if (!m_confirmPending)
+    {
+        return;
+    }
+    m_confirmPending = false;
+    m_replyOk = proceed;
+    QMetaObject::invokeMethod(this, "resume", Qt::QueuedConnection);
+}
+
+
+/*!
+ * @brief runs steps of the calibration until one of them has to wait
+ *
+ * Called when whatever the run was waiting for has happened.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::resume()
+{
+    m_waiting = false;
+    while ((m_state != Run_Idle) && !m_waiting)
+    {
+        step();
+    }
+}
+
+
+void CCalibrationEngine::onTransactionFinished(bool ok, QStringList lines)
+{
+    if (m_state == Run_Idle)
+    {
+        return;
+    }
+    m_replyOk = ok;
+    m_reply = lines;
+    resume();
+}
+
+
+/*!
+ * @brief ends a settle delay, or a wait for stream data that timed out
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::onWaitTimeout()
+{
+    if (m_settleMS >= 0)
+    {
+        CMetrics::instance()->observeWakeup(CMetrics::Wakeup_Settle,
+                                            m_settleClock.nsecsElapsed() / 1000 - m_settleMS * 1000LL);
+        m_settleMS = -1;
+    }
+    if (m_state == Run_Idle)
+    {
+        return;
+    }
+    m_replyOk = false;
+    m_streamWait = Wait_None;
+    resume();
+}
+
+
+/*!
+ * @brief resumes a run waiting for stream data once the data has arrived
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::onStreamEvents()
+{
+    if (    ((m_streamWait == Wait_Voltage) && (m_stream.voltageCount() > m_streamVoltageSeen))
+         || ((m_streamWait == Wait_Exposure) && (m_stream.exposureCount() > m_streamExposureSeen)) )
+    {
+        m_waitTimer.stop();
+        m_streamWait = Wait_None;
+        m_replyOk = true;
+        resume();
+    }
+}
+
+
+/*!
+ * @brief sends a command and suspends the run until its response is in
+ *
+ * m_replyOk and m_reply hold the outcome when the run resumes at next.
+ *
+ * @param[in] command - the command
+ * @param[in] responseLines - response lines to read after the echo
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::send(const QString &command, int responseLines, int next)
+{
+    m_state = next;
+    m_waiting = true;
+    m_reply.clear();
+    m_serialBuffer.startTransaction(command, responseLines);
+}
+
+
+void CCalibrationEngine::settle(int ms, int next)
+{
+    m_state = next;
+    m_waiting = true;
+    m_streamWait = Wait_None;
+    m_settleMS = ms;
+    m_settleClock.start();
+    m_waitTimer.start(ms);
+}
+
+
+/*!
+ * @brief suspends the run until new stream data has arrived
+ *
+ * Continues at once if the data is already there.  m_replyOk is false
+ * when the run resumes after the profile's stream timeout without the data.
+ *
+ * @param[in] wait - the kind of data
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::waitStream(StreamWait wait, int next)
+{
+    m_state = next;
+    m_replyOk = true;
+    m_serialBuffer.drainEvents();
+    if (    ((wait == Wait_Voltage) && (m_stream.voltageCount() > m_streamVoltageSeen))
+         || ((wait == Wait_Exposure) && (m_stream.exposureCount() > m_streamExposureSeen)) )
+    {
+        return;
+    }
+    m_streamWait = wait;
+    m_waiting = true;
+    m_settleMS = -1;
+    m_waitTimer.start(m_profile.m_streamTimeoutMS);
+}
+
+
+/*!
+ * @brief sends a list of commands that have no response, stopping at the first failure
+ *
+ * m_commandsOk tells whether all were echoed when the run resumes at next.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::sendCommands(const QStringList &commands, int next)
+{
+    m_commands = commands;
+    m_commandIndex = 0;
+    m_commandsOk = true;
+    m_commandsReturn = next;
+    m_replyOk = true;
+    m_state = Commands_Next;
+}
+
+
+/*!
+ * @brief sets the DACs of all LED channels and refreshes all measurements
+ *
+ * Frames taken before the DAC change are stale, so a fresh accumulation
+ * of the configured number of frames is taken.  m_measureOk is false when
+ * the run resumes at next if the command or any measurement failed.
+ *
+ * @param[in] dac - DAC code of each channel, m_channels entries
+ * @param[in] next - state to resume at
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+void CCalibrationEngine::measure(const int *dac, int next)
+{
+    for (int c=0; c<m_channels; c++)
+    {
+        m_measureDac[c] = dac[c];
+    }
+    m_measureOk = true;
+    m_measureReturn = next;
+    send(m_protocol->encodeDac(dac, m_channels), 1, Measure_Settle);
+}
+
+
+/*!
+ * @brief drives the LED of the current search phase, with the others off
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::measurePhase(int value, int next)
+{
+    int dac[LED_CHANNELS_MAX];
+    for (int c=0; c<m_channels; c++)
+    {
+        dac[c] = 0;
+    }
+    dac[phaseChannel(m_phase)] = value;
+    measure(dac, next);
+}
+
+
+/*!
+ * @brief measures one DAC code of the current search phase
+ *
+ * When the run resumes at next, m_probeOk is false if the measurement
+ * failed, and m_probeBelow tells whether the code is at or below the
+ * threshold.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::probe(int value, int next)
+{
+    m_probeReturn = next;
+    measurePhase(value, Probe_Measured);
+}
+
+
+/*!
+ * @brief measures a DAC code of each channel in the high threshold search
+ *
+ * Like probe(), with the settle delay of the high thresholds, but the
+ * caller judges each channel itself.  m_probeOk is false when the run
+ * resumes at next if the measurement failed.
+ *
+ * @param[in] dac - DAC code of each channel, m_channels entries
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::probeCodes(const int *dac, int next)
+{
+    m_probeReturn = next;
+    measure(dac, Probe_Measured);
+}
+
+
+/*!
+ * @brief probes both ends of a bracket of the current search phase
+ *
+ * An end that is also the end of the full window needs no probe.  When
+ * the run resumes at next, m_verifyOk is false if a measurement failed and
+ * m_verifyHolds tells whether the threshold is still inside the bracket.
+ *
+ * @param[in] low, high - the bracket
+ * @param[in] skipLow, skipHigh - the end is known to be below/above the threshold
+ * @param[in] next - state to resume at
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::verify(int low, int high, bool skipLow, bool skipHigh, int next)
+{
+    m_verifyLow = low;
+    m_verifyHigh = high;
+    m_verifySkipHigh = skipHigh;
+    m_verifyReturn = next;
+    if (skipLow)
+    {
+        m_probeOk = true;
+        m_probeBelow = true;
+        m_state = Verify_Low;
+        return;
+    }
+    probe(low, Verify_Low);
+}
+
+
+void CCalibrationEngine::endSearch(int value)
+{
+    m_searchValue = value;
+    m_state = Run_PhaseDone;
+}
+
+
+/*!
+ * @brief executes the current state of the calibration
+ *
+ * A state either moves on to another state, to be run straight away, or
+ * starts a transaction, delay or stream wait naming the state that
+ * handles its outcome; the run is then suspended until resume().
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::step()
+{
+    if (m_state < Search_Begin)
+    {
+        stepRun();
+    }
+    else if (m_state < Batch_Begin)
+    {
+        stepSearch();
+    }
+    else if (m_state < Check_Begin)
+    {
+        stepBatch();
+    }
+    else if (m_state < Verify_Low)
+    {
+        stepCheck();
+    }
+    else if (m_state < Measure_Settle)
+    {
+        stepProbe();
+    }
+    else if (m_state < Link_Echo)
+    {
+        stepMeasure();
+    }
+    else if (m_state < Monitor_Begin)
+    {
+        stepLink();
+    }
+    else
+    {
+        stepMonitor();
+    }
+}
+
+
+/*!
+ * @brief the calibration sequence: connect, check, search the
+ *        thresholds of all channels, save, clean up
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+void CCalibrationEngine::stepRun()
+{
+    switch (m_state)
+    {
+    case Run_Open:
+        //
+        // The profile is taken once per run; one reloaded meanwhile is
+        // used by the next run.
+        //
+        if (!m_settings->profileErrors().isEmpty())
+        {
+            fail(m_settings->profileErrors());
+            m_state = Run_Abort;
+            break;
+        }
+        m_profile = m_settings->profile();
+        m_channels = m_profile.m_channels;
+        m_result.m_profile = m_profile.m_name;
+        m_result.m_channels = m_channels;
+        m_serialBuffer.setTimeout(m_profile.m_responseTimeoutMS);
+        if (!selectProtocol())
+        {
+            m_state = Run_Abort;
+            break;
+        }
+
+        emit statusChanged("Opening Serial Port...");
+        if (!m_serialBuffer.openPort(m_serialPortName))
+        {
+            fail("The specified serial port could not be opened.");
+            m_state = Run_Abort;
+            break;
+        }
+        openTrace();
+        m_trace.run(m_serialNumber);
+        emit statusChanged("Checking communication with controller...");
+        connectLink(Run_Echo);
+        break;
+
+    case Run_Echo:
+        if (!m_linkOk)
+        {
+            fail("Communication with the controller could not be established.\n\nPort opend successfully.\nCommands are not echoed.");
+            m_state = Run_Abort;
+            break;
+        }
+        emit statusChanged("Initializing controller settings...");
+        send("disable_events=1", 1, Run_Init);
+        break;
+
+    case Run_Init:
+        negotiateLink(Run_Negotiated);
+        break;
+
+    case Run_Negotiated:
+        endTiming(Timing_Connect);
+        emit statusChanged("Checking firmware version...");
+        send(m_protocol->m_versionCommand, m_protocol->m_versionLines, Run_Version);
+        break;
+
+    case Run_Version:
+        parseFirmwareVersion(m_reply);
+        if (   (m_result.m_versionARM != m_settings->m_versionARM)
+               || (m_result.m_versionDSP != m_settings->m_versionDSP)
+               || (m_result.m_versionFPGA != m_settings->m_versionFPGA) )
+        {
+            //
+            // Nobody to ask means no
+            //
+            m_replyOk = false;
+            m_state = Run_VersionConfirmed;
+            if (receivers(SIGNAL(confirmationRequested(QString))) > 0)
+            {
+                m_confirmPending = true;
+                m_waiting = true;
+                emit confirmationRequested("Controller version does not match expected.\nContinue?");
+            }
+            break;
+        }
+        m_replyOk = true;
+        m_state = Run_VersionConfirmed;
+        break;
+
+    case Run_VersionConfirmed:
+        if (!m_replyOk)
+        {
+            m_result.m_error = "Controller version does not match expected.";
+            m_result.m_failedPhase = Timing_Version;
+            m_state = Run_Abort;
+            break;
+        }
+        endTiming(Timing_Version);
+        send(m_protocol->m_calibrationCommand, 1, Run_StoredCal);
+        break;
+
+    case Run_StoredCal:
+        parseCalibrationValues(m_reply.value(0));
+        emit statusChanged("Checking for scope...");
+        send("em_style=1", 1, Run_ScopeStyle);
+        break;
+
+    case Run_ScopeStyle:
+        //
+        // With em_style=1 the reading is a single line, whatever the protocol
+        //
+        send(m_protocol->m_exposureCommand, 1, Run_Scope);
+        break;
+
+    case Run_Scope:
+        if (m_reply.value(0).isEmpty())
+        {
+            fail("Scope not detected.\n\nEnsure that the scope is connected and installed in the calibration fixture.");
+            m_state = Run_Abort;
+            break;
+        }
+        send("em_style=0", 0, Run_ScopeDone);
+        break;
+
+    case Run_ScopeDone:
+        endTiming(Timing_Scope);
+        if (!m_settings->m_streamEnabled)
+        {
+            m_state = Run_SearchStart;
+            break;
+        }
+        startStream(Run_StreamStarted);
+        break;
+
+    case Run_StreamStarted:
+        if (m_commandsOk)
+        {
+            m_serialBuffer.setEventNotification(true);
+            m_state = Run_SearchStart;
+            break;
+        }
+        sendCommands(m_settings->m_streamStopCommands, Run_StreamFallback);
+        break;
+
+    case Run_StreamFallback:
+        m_serialBuffer.setEventFilter(0);
+        m_streaming = false;
+        emit statusChanged("Controller events could not be enabled, polling instead");
+        m_state = Run_SearchStart;
+        break;
+
+    case Run_SearchStart:
+        //
+        // Progress is journaled so an interrupted calibration of the same
+        // unit resumes where it left off (see stepSearch()).  The low
+        // thresholds are searched one channel at a time, as all channels
+        // light the same scope; the high thresholds all at once (see
+        // stepBatch()) unless the profile says otherwise.
+        //
+        for (int c=0; c<m_channels; c++)
+        {
+            m_channel[c].m_low = m_channel[c].m_high = -1;
+        }
+        emitNewCalibration();
+        m_journal.open(m_serialNumber, firmware());
+        loadSearchPriors();
+        m_phase = 0;
+        m_state = Search_Begin;
+        break;
+
+    case Run_PhaseDone:
+        if (highPhase(m_phase))
+        {
+            m_channel[phaseChannel(m_phase)].m_high = m_searchValue;
+        }
+        else
+        {
+            m_channel[m_phase].m_low = m_searchValue;
+        }
+        if (m_searchValue < 0)
+        {
+            m_journal.close();
+            fail(QString("Communication with the controller was lost during the %1 search.\n\n"
+                         "Reconnect and start the calibration again to resume.").arg(phaseName(m_phase)));
+            m_state = Run_LedOff;
+            break;
+        }
+        emitNewCalibration();
+        if (++m_phase == m_channels)
+        {
+            endTiming(Timing_SearchLow);
+            if (m_profile.m_batchHighSearch)
+            {
+                m_state = Batch_Begin;
+                break;
+            }
+        }
+        if (m_phase < 2*m_channels)
+        {
+            m_state = Search_Begin;
+            break;
+        }
+        m_searchValue = 0;
+        m_state = Run_HighDone;
+        break;
+
+    case Run_HighDone:
+        if (m_searchValue < 0)
+        {
+            m_journal.close();
+            fail("Communication with the controller was lost during the high threshold search.\n\n"
+                 "Reconnect and start the calibration again to resume.");
+            m_state = Run_LedOff;
+            break;
+        }
+        endTiming(Timing_SearchHigh);
+        emitNewCalibration();
+        m_journal.close();
+        {
+            int dac[LED_CHANNELS_MAX];
+            for (int c=0; c<m_channels; c++)
+            {
+                dac[c] = m_channel[c].m_low;
+            }
+            measure(dac, Run_Found);
+        }
+        break;
+
+    case Run_Found:
+        for (int c=0; c<m_channels; c++)
+        {
+            m_result.m_low[c] = m_channel[c].m_low;
+            m_result.m_high[c] = m_channel[c].m_high;
+        }
+
+        emit statusChanged("Saving calibration...");
+        m_saveChannel = 0;
+        m_state = Run_Save;
+        break;
+
+    case Run_Save:
+        //
+        // A write that failed after its retries leaves the journal, so
+        // the next run of the unit can save without searching again
+        //
+        if ((m_saveChannel > 0) && !m_replyOk)
+        {
+            fail(QString("The calibration of LED %1 could not be saved to the controller.").arg(m_saveChannel));
+            m_state = Run_LedOff;
+            break;
+        }
+        if (m_saveChannel < m_channels)
+        {
+            const CLedChannel &channel = m_channel[m_saveChannel];
+            send(m_protocol->encodeCalibration(m_saveChannel, channel.m_low, channel.m_high), 1, Run_Save);
+            m_saveChannel++;
+            break;
+        }
+        endTiming(Timing_Save);
+        m_state = m_profile.m_verifySave ? Check_Begin : Run_Saved;
+        break;
+
+    case Run_Saved:
+        m_journal.remove();
+        m_result.m_success = true;
+        m_state = Run_LedOff;
+        break;
+
+    case Run_LedOff:
+        send("led=0", 0, Run_LedOffDone);
+        break;
+
+    case Run_LedOffDone:
+        m_exposure.clear();
+        if (m_streaming)
+        {
+            m_serialBuffer.setEventNotification(false);
+            sendCommands(m_settings->m_streamStopCommands, Run_StreamStopped);
+            break;
+        }
+        m_state = Run_Finish;
+        break;
+
+    case Run_StreamStopped:
+        m_serialBuffer.setEventFilter(0);
+        m_streaming = false;
+        m_state = Run_Finish;
+        break;
+
+    case Run_Finish:
+        finishRun();
+        break;
+
+    case Run_Abort:
+        abortRun();
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief binary search for the threshold of phase m_phase
+ *
+ * Progress is journaled after every step.  If the journal already holds
+ * progress for this phase it is verified with a quick probe and the search
+ * continues from there; progress that fails verification is discarded.
+ * Otherwise the search starts from the window given by the history.
+ * A failed measurement stops the search without journaling anything, so
+ * the journal only ever holds confirmed brackets.
+ *
+ * Ends in Run_PhaseDone with the threshold in m_searchValue, -1 if
+ * communication with the controller failed.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::stepSearch()
+{
+    switch (m_state)
+    {
+    case Search_Begin:
+        m_X1 = searchWindow(m_phase)[0];
+        m_X2 = searchWindow(m_phase)[1];
+        if (m_journal.phaseDone(m_phase))
+        {
+            int value = m_journal.phaseValue(m_phase);
+            emit statusChanged(QString("Verifying %1 threshold from journal...").arg(phaseName(m_phase)));
+            verify(value, value+1, false, false, Search_JournalChecked);
+            break;
+        }
+        if (m_journal.hasBracket(m_phase))
+        {
+            int bracketLow = m_journal.bracketLow(m_phase);
+            int bracketHigh = m_journal.bracketHigh(m_phase);
+            emit statusChanged(QString("Verifying %1 search bracket from journal...").arg(phaseName(m_phase)));
+            verify(bracketLow, bracketHigh, bracketLow == m_X1, bracketHigh == m_X2, Search_BracketChecked);
+            break;
+        }
+        m_state = Search_Prior;
+        break;
+
+    case Search_JournalChecked:
+        if (!m_verifyOk)
+        {
+            endSearch(-1);
+            break;
+        }
+        if (m_verifyHolds)
+        {
+            endSearch(m_verifyLow);
+            break;
+        }
+        m_journal.discardPhase(m_phase);
+        m_state = Search_Prior;
+        break;
+
+    case Search_BracketChecked:
+        if (!m_verifyOk)
+        {
+            endSearch(-1);
+            break;
+        }
+        if (m_verifyHolds)
+        {
+            m_X1 = m_verifyLow;
+            m_X2 = m_verifyHigh;
+        }
+        else
+        {
+            m_journal.discardPhase(m_phase);
+        }
+        m_state = Search_Prior;
+        break;
+
+    case Search_Prior:
+        //
+        // Without journaled progress, try the window this fixture and
+        // firmware usually calibrate in.  Its ends are probed first; if the
+        // threshold turns out to be outside, the full window is searched.
+        //
+        if ((m_X1 == searchWindow(m_phase)[0]) && (m_X2 == searchWindow(m_phase)[1]) && (m_prior.m_samples > 0))
+        {
+            int priorLow = qMax(m_X1, m_prior.m_low[m_phase]);
+            int priorHigh = qMin(m_X2, m_prior.m_high[m_phase]);
+            if (priorLow < priorHigh)
+            {
+                emit statusChanged(QString("Checking %1 search window from history...").arg(phaseName(m_phase)));
+                verify(priorLow, priorHigh, priorLow == m_X1, priorHigh == m_X2, Search_PriorChecked);
+                break;
+            }
+        }
+        m_state = Search_Bisect;
+        break;
+
+    case Search_PriorChecked:
+        if (!m_verifyOk)
+        {
+            endSearch(-1);
+            break;
+        }
+        if (m_verifyHolds)
+        {
+            m_X1 = m_verifyLow;
+            m_X2 = m_verifyHigh;
+            m_journal.recordBracket(m_phase, m_X1, m_X2);
+        }
+        m_state = Search_Bisect;
+        break;
+
+    case Search_Bisect:
+        emit statusChanged(QString("Searching for %1 threshold...").arg(phaseName(m_phase)));
+        m_M = (m_X1+m_X2)/2;
+        measurePhase(highPhase(m_phase) ? m_X1 : m_M, Search_BisectSettle);
+        break;
+
+    case Search_BisectSettle:
+        if (!m_measureOk)
+        {
+            endSearch(-1);
+            break;
+        }
+        settle(m_profile.m_searchSettleMS, Search_Step);
+        break;
+
+    case Search_Step:
+        if (m_X1 < (m_X2-1))
+        {
+            m_M = (m_X1+m_X2)/2;
+            probe(m_M, Search_Stepped);
+            break;
+        }
+        m_journal.recordPhase(m_phase, m_X1);
+        endSearch(m_X1);
+        break;
+
+    case Search_Stepped:
+        if (!m_probeOk)
+        {
+            endSearch(-1);
+            break;
+        }
+        if (m_probeBelow)
+        {
+            m_X1 = m_M;
+        }
+        else
+        {
+            m_X2 = m_M;
+        }
+        m_journal.recordBracket(m_phase, m_X1, m_X2);
+        m_state = Search_Step;
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief search of the high thresholds of all channels at once
+ *
+ * A channel's current depends only on its own DAC code, and one "ledvi"
+ * reads the currents of all channels, so every measurement of this search
+ * drives each channel still searching at its own code and judges all of
+ * them.  The search takes as many steps as the widest bracket needs, no
+ * matter how many channels there are.  Channels that are done are driven
+ * at 0.
+ *
+ * As in stepSearch(), progress from the journal is verified first, then
+ * the windows from the history.  Each round verifies the brackets of all
+ * channels with one measurement of the low ends and one of the high ends.
+ *
+ * Ends in Run_HighDone with m_searchValue -1 if communication with the
+ * controller failed.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::stepBatch()
+{
+    const double limit = m_profile.m_currentLimit;
+    int dac[LED_CHANNELS_MAX];
+    bool any = false;
+
+    switch (m_state)
+    {
+    case Batch_Begin:
+        for (int c=0; c<m_channels; c++)
+        {
+            CChannelSearch &search = m_batch[c];
+            search.m_X1 = m_profile.m_highWindow[0];
+            search.m_X2 = m_profile.m_highWindow[1];
+            search.m_M = search.m_X1;
+            search.m_done = false;
+            search.m_source = CChannelSearch::Source_None;
+        }
+        m_phase = m_channels;       // a high phase, for the settle delay of the probes
+        m_batchRound = 0;
+        m_state = Batch_Verify;
+        break;
+
+    case Batch_Verify:
+        for (int c=0; c<m_channels; c++)
+        {
+            CChannelSearch &search = m_batch[c];
+            int phase = m_channels + c;
+            search.m_source = CChannelSearch::Source_None;
+            if (search.m_done)
+            {
+                continue;
+            }
+            if (m_batchRound == 0)
+            {
+                if (m_journal.phaseDone(phase))
+                {
+                    search.m_source = CChannelSearch::Source_Journal;
+                    search.m_verifyLow = m_journal.phaseValue(phase);
+                    search.m_verifyHigh = search.m_verifyLow + 1;
+                }
+                else if (m_journal.hasBracket(phase))
+                {
+                    search.m_source = CChannelSearch::Source_Bracket;
+                    search.m_verifyLow = m_journal.bracketLow(phase);
+                    search.m_verifyHigh = m_journal.bracketHigh(phase);
+                }
+            }
+            else if (    (search.m_X1 == m_profile.m_highWindow[0])
+                      && (search.m_X2 == m_profile.m_highWindow[1])
+                      && (m_prior.m_samples > 0) )
+            {
+                int priorLow = qMax(search.m_X1, m_prior.m_low[phase]);
+                int priorHigh = qMin(search.m_X2, m_prior.m_high[phase]);
+                if (priorLow < priorHigh)
+                {
+                    search.m_source = CChannelSearch::Source_Prior;
+                    search.m_verifyLow = priorLow;
+                    search.m_verifyHigh = priorHigh;
+                }
+            }
+            if (search.m_source != CChannelSearch::Source_None)
+            {
+                bool window = (search.m_source != CChannelSearch::Source_Journal);
+                search.m_skipLow = window && (search.m_verifyLow == search.m_X1);
+                search.m_skipHigh = window && (search.m_verifyHigh == search.m_X2);
+                any = true;
+            }
+        }
+        if (!any)
+        {
+            m_state = (++m_batchRound < 2) ? Batch_Verify : Batch_Bisect;
+            break;
+        }
+        emit statusChanged((m_batchRound == 0) ? "Verifying high thresholds from journal..."
+                                               : "Checking high threshold search windows from history...");
+        batchVerify(false);
+        break;
+
+    case Batch_VerifyLow:
+        if (!m_probeOk)
+        {
+            endBatch(false);
+            break;
+        }
+        for (int c=0; c<m_channels; c++)
+        {
+            CChannelSearch &search = m_batch[c];
+            if (search.m_source != CChannelSearch::Source_None)
+            {
+                search.m_verifyBelow = search.m_skipLow || (m_channel[c].m_I <= limit);
+            }
+        }
+        batchVerify(true);
+        break;
+
+    case Batch_VerifyHigh:
+        if (!m_probeOk)
+        {
+            endBatch(false);
+            break;
+        }
+        for (int c=0; c<m_channels; c++)
+        {
+            CChannelSearch &search = m_batch[c];
+            int phase = m_channels + c;
+            bool holds = search.m_verifyBelow && (search.m_skipHigh || (m_channel[c].m_I > limit));
+            switch (search.m_source)
+            {
+            case CChannelSearch::Source_Journal:
+                if (holds)
+                {
+                    search.m_X1 = search.m_verifyLow;
+                    search.m_done = true;
+                }
+                else
+                {
+                    m_journal.discardPhase(phase);
+                }
+                break;
+            case CChannelSearch::Source_Bracket:
+                if (holds)
+                {
+                    search.m_X1 = search.m_verifyLow;
+                    search.m_X2 = search.m_verifyHigh;
+                }
+                else
+                {
+                    m_journal.discardPhase(phase);
+                }
+                break;
+            case CChannelSearch::Source_Prior:
+                if (holds)
+                {
+                    search.m_X1 = search.m_verifyLow;
+                    search.m_X2 = search.m_verifyHigh;
+                    m_journal.recordBracket(phase, search.m_X1, search.m_X2);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        m_state = (++m_batchRound < 2) ? Batch_Verify : Batch_Bisect;
+        break;
+
+    case Batch_Bisect:
+        emit statusChanged("Searching for high thresholds...");
+        for (int c=0; c<m_channels; c++)
+        {
+            dac[c] = m_batch[c].m_done ? 0 : m_batch[c].m_X1;
+            any = any || !m_batch[c].m_done;
+        }
+        if (!any)
+        {
+            m_state = Batch_Step;
+            break;
+        }
+        measure(dac, Batch_BisectSettle);
+        break;
+
+    case Batch_BisectSettle:
+        if (!m_measureOk)
+        {
+            endBatch(false);
+            break;
+        }
+        settle(m_profile.m_searchSettleMS, Batch_Step);
+        break;
+
+    case Batch_Step:
+        for (int c=0; c<m_channels; c++)
+        {
+            CChannelSearch &search = m_batch[c];
+            dac[c] = 0;
+            if (search.m_done)
+            {
+                continue;
+            }
+            if (search.m_X1 < (search.m_X2-1))
+            {
+                search.m_M = (search.m_X1+search.m_X2)/2;
+                dac[c] = search.m_M;
+                any = true;
+                continue;
+            }
+            m_journal.recordPhase(m_channels + c, search.m_X1);
+            search.m_done = true;
+        }
+        if (!any)
+        {
+            endBatch(true);
+            break;
+        }
+        probeCodes(dac, Batch_Stepped);
+        break;
+
+    case Batch_Stepped:
+        if (!m_probeOk)
+        {
+            endBatch(false);
+            break;
+        }
+        for (int c=0; c<m_channels; c++)
+        {
+            CChannelSearch &search = m_batch[c];
+            if (search.m_done)
+            {
+                continue;
+            }
+            if (m_channel[c].m_I <= limit)
+            {
+                search.m_X1 = search.m_M;
+            }
+            else
+            {
+                search.m_X2 = search.m_M;
+            }
+            m_journal.recordBracket(m_channels + c, search.m_X1, search.m_X2);
+        }
+        m_state = Batch_Step;
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief probes the low or high ends of the brackets being verified
+ *
+ * Channels whose end needs no probe are driven at 0.  If no channel needs
+ * one, the run continues without a measurement.
+ *
+ * @param[in] high - probe the high ends, else the low ends
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::batchVerify(bool high)
+{
+    int next = high ? Batch_VerifyHigh : Batch_VerifyLow;
+    int dac[LED_CHANNELS_MAX];
+    bool any = false;
+    for (int c=0; c<m_channels; c++)
+    {
+        const CChannelSearch &search = m_batch[c];
+        dac[c] = 0;
+        if (    (search.m_source != CChannelSearch::Source_None)
+             && !(high ? search.m_skipHigh : search.m_skipLow) )
+        {
+            dac[c] = high ? search.m_verifyHigh : search.m_verifyLow;
+            any = true;
+        }
+    }
+    if (!any)
+    {
+        m_probeOk = true;
+        m_state = next;
+        return;
+    }
+    probeCodes(dac, next);
+}
+
+
+/*!
+ * @brief ends the high threshold search
+ *
+ * @param[in] ok - false if communication with the controller failed
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::endBatch(bool ok)
+{
+    for (int c=0; c<m_channels; c++)
+    {
+        m_channel[c].m_high = (ok && m_batch[c].m_done) ? m_batch[c].m_X1 : -1;
+    }
+    m_searchValue = ok ? 0 : -1;
+    m_state = Run_HighDone;
+}
+
+
+/*!
+ * @brief checks the calibration just saved, in place of a second calibration
+ *
+ * The values are read back from the controller and compared with the
+ * ones written, then each threshold is probed once: every channel must
+ * draw no more than the current limit at its high threshold and give no
+ * exposure at its low threshold.  Both are checked on all channels at
+ * once; the high thresholds one channel at a time if the profile does not
+ * search them together.  Light adds up, so all channels dark together
+ * proves each one dark; only if they are not is each channel tried alone
+ * to find the one at fault.  The low codes are probed last so the final
+ * readings of the run are the same as without the check.
+ *
+ * Ends in Run_Saved if the check passed, otherwise in Run_LedOff with the
+ * run failed; the journal is kept then, so a new calibration verifies its
+ * brackets instead of searching again.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::stepCheck()
+{
+    int dac[LED_CHANNELS_MAX];
+
+    switch (m_state)
+    {
+    case Check_Begin:
+        emit statusChanged("Checking saved calibration...");
+        send(m_protocol->m_calibrationCommand, 1, Check_ReadBack);
+        break;
+
+    case Check_ReadBack:
+        {
+            int storedLow[LED_CHANNELS_MAX];
+            int storedHigh[LED_CHANNELS_MAX];
+            int found = m_replyOk ? m_protocol->parseCalibration(m_reply.value(0), storedLow, storedHigh) : 0;
+            if (found < m_channels)
+            {
+                endCheck("The saved calibration could not be read back from the controller.");
+                break;
+            }
+            int c = 0;
+            while ((c < m_channels) && (storedLow[c] == m_channel[c].m_low) && (storedHigh[c] == m_channel[c].m_high))
+            {
+                c++;
+            }
+            if (c < m_channels)
+            {
+                endCheck(QString("LED %1 reads back low=%2 high=%3 instead of the saved low=%4 high=%5.")
+                         .arg(c+1).arg(storedLow[c]).arg(storedHigh[c])
+                         .arg(m_channel[c].m_low).arg(m_channel[c].m_high));
+                break;
+            }
+        }
+        for (int c=0; c<m_channels; c++)
+        {
+            dac[c] = m_channel[c].m_high;
+        }
+        m_phase = m_channels;
+        if (m_profile.m_batchHighSearch)
+        {
+            m_checkChannel = -1;
+            probeCodes(dac, Check_High);
+            break;
+        }
+        m_checkChannel = 0;
+        probe(dac[0], Check_High);
+        break;
+
+    case Check_High:
+        if (!m_probeOk)
+        {
+            endCheck("Communication with the controller failed while checking the saved calibration.");
+            break;
+        }
+        {
+            int c = (m_checkChannel < 0) ? 0 : m_checkChannel;
+            int last = (m_checkChannel < 0) ? m_channels-1 : m_checkChannel;
+            while ((c <= last) && (m_channel[c].m_I <= m_profile.m_currentLimit))
+            {
+                c++;
+            }
+            if (c <= last)
+            {
+                endCheck(QString("LED %1 draws %2 A at its high threshold of %3, more than %4 A.")
+                         .arg(c+1).arg(m_channel[c].m_I, 0, 'f', 3)
+                         .arg(m_channel[c].m_high).arg(m_profile.m_currentLimit));
+                break;
+            }
+        }
+        if ((m_checkChannel >= 0) && (m_checkChannel+1 < m_channels))
+        {
+            m_checkChannel++;
+            m_phase = m_channels + m_checkChannel;
+            probe(m_channel[m_checkChannel].m_high, Check_High);
+            break;
+        }
+        for (int c=0; c<m_channels; c++)
+        {
+            dac[c] = m_channel[c].m_low;
+        }
+        m_phase = 0;
+        m_checkChannel = -1;
+        probeCodes(dac, Check_Low);
+        break;
+
+    case Check_Low:
+        if (!m_probeOk)
+        {
+            endCheck("Communication with the controller failed while checking the saved calibration.");
+            break;
+        }
+        if ((m_checkChannel >= 0) && !m_probeBelow)
+        {
+            endCheck(QString("LED %1 is not dark at its low threshold of %2.")
+                     .arg(m_checkChannel+1).arg(m_channel[m_checkChannel].m_low));
+            break;
+        }
+        m_checkChannel = (m_probeBelow && (m_checkChannel < 0)) ? m_channels : m_checkChannel+1;
+        if (m_checkChannel < m_channels)
+        {
+            m_phase = m_checkChannel;
+            probe(m_channel[m_checkChannel].m_low, Check_Low);
+            break;
+        }
+        endCheck(QString());
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief ends the check of the saved calibration
+ *
+ * @param[in] error - why the check failed, empty if it passed
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::endCheck(QString error)
+{
+    endTiming(Timing_Check);
+    m_result.m_saveCheck = error.isEmpty() ? 1 : 0;
+    if (!error.isEmpty())
+    {
+        fail("The saved calibration did not pass its check.\n\n" + error);
+        m_state = Run_LedOff;
+        return;
+    }
+    emit statusChanged("Saved calibration checked");
+    m_state = Run_Saved;
+}
+
+
+/*!
+ * @brief the bracket verification and the single probe of the search
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::stepProbe()
+{
+    switch (m_state)
+    {
+    case Verify_Low:
+        if (!m_probeOk)
+        {
+            m_verifyOk = false;
+            m_state = m_verifyReturn;
+            break;
+        }
+        m_verifyBelow = m_probeBelow;
+        if (m_verifySkipHigh)
+        {
+            m_probeOk = true;
+            m_probeBelow = false;
+            m_state = Verify_High;
+            break;
+        }
+        probe(m_verifyHigh, Verify_High);
+        break;
+
+    case Verify_High:
+        m_verifyOk = m_probeOk;
+        m_verifyHolds = m_probeOk && m_verifyBelow && !m_probeBelow;
+        m_state = m_verifyReturn;
+        break;
+
+    case Probe_Measured:
+        if (!m_measureOk)
+        {
+            m_probeOk = false;
+            m_state = m_probeReturn;
+            break;
+        }
+        if (highPhase(m_phase))
+        {
+            settle(m_profile.m_highSettleMS, Probe_Settled);
+            break;
+        }
+        m_state = Probe_Settled;
+        break;
+
+    case Probe_Settled:
+        m_probeOk = true;
+        m_probeBelow = belowThreshold(m_phase);
+        m_state = m_probeReturn;
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief the DAC setting with its measurements, and the command lists
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+void CCalibrationEngine::stepMeasure()
+{
+    switch (m_state)
+    {
+    case Measure_Settle:
+        if (!m_replyOk)
+        {
+            m_measureOk = false;
+        }
+        settle(m_profile.m_dacSettleMS, Measure_ReadDac);
+        break;
+
+    case Measure_ReadDac:
+        if (m_streaming)
+        {
+            //
+            // Only samples that arrive from now on reflect the new codes
+            //
+            m_serialBuffer.drainEvents();
+            m_streamExposureSeen = m_stream.exposureCount();
+            m_streamVoltageSeen = m_stream.voltageCount();
+        }
+        send(m_protocol->m_dacCommand, 1, Measure_Dac);
+        break;
+
+    case Measure_Dac:
+        parseDacValues(m_replyOk ? m_reply.value(0) : QString());
+        if (m_streaming)
+        {
+            waitStream(Wait_Voltage, Measure_VI);
+            break;
+        }
+        send(m_protocol->m_readingsCommand, 1, Measure_VI);
+        break;
+
+    case Measure_VI:
+        {
+            bool valid = m_replyOk;
+            if (m_streaming)
+            {
+                if (valid)
+                {
+                    valid = takeStreamVoltage();
+                }
+            }
+            else if (!parseCurrentAndVoltage(m_reply.value(0)))
+            {
+                valid = false;
+            }
+            if (!publishCurrentAndVoltage(valid))
+            {
+                m_measureOk = false;
+            }
+        }
+        m_exposure.clear();
+        m_measureFrame = 0;
+        m_state = Measure_Frame;
+        break;
+
+    case Measure_Frame:
+        if (m_measureFrame >= m_exposure.depth())
+        {
+            for (int c=0; c<m_channels; c++)
+            {
+                m_channel[c].m_dac = m_measureDac[c];
+            }
+            m_state = m_measureReturn;
+            break;
+        }
+        if (m_streaming)
+        {
+            waitStream(Wait_Exposure, Measure_FrameRead);
+            break;
+        }
+        send(m_protocol->m_exposureCommand, m_protocol->m_exposureLines, Measure_FrameRead);
+        break;
+
+    case Measure_FrameRead:
+        {
+            int zones[EXPOSURE_ZONES];
+            bool valid = m_replyOk;
+            if (m_streaming)
+            {
+                if (valid)
+                {
+                    takeStreamFrame(zones);
+                }
+            }
+            else if (!parseExposureFrame(m_reply, zones))
+            {
+                valid = false;
+            }
+            if (valid)
+            {
+                double V[LED_CHANNELS_MAX];
+                double I[LED_CHANNELS_MAX];
+                for (int c=0; c<m_channels; c++)
+                {
+                    V[c] = m_channel[c].m_V;
+                    I[c] = m_channel[c].m_I;
+                }
+                m_trace.sample(m_channels, m_measureDac, V, I, zones);
+            }
+            if (!publishExposure(valid ? zones : 0))
+            {
+                m_measureOk = false;
+                m_measureFrame = m_exposure.depth();
+            }
+            else
+            {
+                m_measureFrame++;
+            }
+        }
+        m_state = Measure_Frame;
+        break;
+
+    case Commands_Next:
+        if (!m_replyOk)
+        {
+            m_commandsOk = false;
+        }
+        if (!m_commandsOk || (m_commandIndex >= m_commands.size()))
+        {
+            m_state = m_commandsReturn;
+            break;
+        }
+        send(m_commands[m_commandIndex++], 0, Commands_Next);
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief the search for the rate of the controller and the negotiation of a
+ *        faster one, see connectLink() and negotiateLink()
+ *
+ * The controller is assumed to change its rate once it has received the
+ * command, so the command is not checked for its echo.  A rate is trusted
+ * once LINK_CHECKS echoes in a row have come back; otherwise the command
+ * for the old rate is sent at the new rate and the port goes back to the
+ * old rate, so a rate the adapter or the cable cannot carry never loses
+ * the controller.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::stepLink()
+{
+    switch (m_state)
+    {
+    case Link_Echo:
+        if (m_replyOk)
+        {
+            m_linkOk = true;
+            m_state = m_linkReturn;
+            break;
+        }
+        m_state = Link_Rate;
+        break;
+
+    case Link_Rate:
+        while ((m_linkIndex < m_linkRates.size()) && (m_linkRates[m_linkIndex] == m_linkPrevious))
+        {
+            m_linkIndex++;
+        }
+        if (m_linkIndex >= m_linkRates.size())
+        {
+            m_serialBuffer.setPortBaudRate(m_linkPrevious);
+            m_state = m_linkReturn;
+            break;
+        }
+        m_serialBuffer.setPortBaudRate(m_linkRates[m_linkIndex++]);
+        send("", 0, Link_Echo);
+        break;
+
+    case Negotiate_Next:
+        while ((m_linkIndex < m_linkRates.size()) && (m_linkRates[m_linkIndex] <= m_linkPrevious))
+        {
+            m_linkIndex++;
+        }
+        if (m_linkIndex >= m_linkRates.size())
+        {
+            m_state = m_linkReturn;
+            break;
+        }
+        m_linkRate = m_linkRates[m_linkIndex++];
+        m_serialBuffer.writeCommand(m_settings->m_linkBaudCommand.arg(m_linkRate));
+        settle(LINK_BAUD_SETTLE_MS, Negotiate_Switch);
+        break;
+
+    case Negotiate_Switch:
+        m_serialBuffer.setPortBaudRate(m_linkRate);
+        m_linkChecks = 0;
+        send("", 0, Negotiate_Check);
+        break;
+
+    case Negotiate_Check:
+        if (m_replyOk && (++m_linkChecks < LINK_CHECKS))
+        {
+            send("", 0, Negotiate_Check);
+            break;
+        }
+        if (m_serialBuffer.baudRate() == m_linkPrevious)
+        {
+            //
+            // Back at the old rate after a fallback; try the next rate
+            //
+            m_state = Negotiate_Next;
+            break;
+        }
+        if (m_replyOk)
+        {
+            m_state = m_linkReturn;
+            break;
+        }
+        m_serialBuffer.writeCommand(m_settings->m_linkBaudCommand.arg(m_linkPrevious));
+        settle(LINK_BAUD_SETTLE_MS, Negotiate_Fallback);
+        break;
+
+    case Negotiate_Fallback:
+        m_serialBuffer.setPortBaudRate(m_linkPrevious);
+        m_linkChecks = 0;
+        send("", 0, Negotiate_Check);
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
+}
+
+
+/*!
+ * @brief records the outcome of a run that got as far as the search
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+void CCalibrationEngine::finishRun()
+{
+    m_result.m_durationMs = m_runTimer.elapsed();
+
+    for (int c=0; c<m_channels; c++)
+    {
+        m_result.m_I[c] = m_channel[c].m_I;
+        m_result.m_V[c] = m_channel[c].m_V;
+    }
+    m_result.m_totalExposure = m_totalExposure;
+    openHistory();
+    m_result.m_alerts = m_drift.update(m_result);
+    for (int i=0; i<m_result.m_alerts.size(); i++)
+    {
+        emit statusChanged("Drift alert: " + m_result.m_alerts[i]);
+    }
+    CMetrics::instance()->observeCalibration(m_result.m_success, m_result.m_durationMs);
+    recordHistory();
+    emit statusChanged(m_result.m_success ? "Calibration complete" : "Calibration failed");
+
+    //
+    // Idle before the signal, so a receiver can start the next run from it
+    //
+    m_state = Run_Idle;
+    emit calibrationFinished(m_result);
+}
+
+
+/*!
+ * @brief records the outcome of a run that failed before the search
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::abortRun()
+{
+    m_result.m_durationMs = m_runTimer.elapsed();
+    CMetrics::instance()->observeCalibration(false, m_result.m_durationMs);
+    recordHistory();
+
+    m_state = Run_Idle;
+    emit calibrationFinished(m_result);
+}
+
+
+/*!
+ * @brief parses the response to the version command and reports the versions
+ *
+ * With the protocol set to "auto" the response also selects the protocol.
+ *
+ * @param[in] lines - the response lines, missing lines are ignored
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+void CCalibrationEngine::parseFirmwareVersion(const QStringList &lines)
+{
+    //
+    // With "auto" the response picks the protocol for the rest of the session
+    //
+    if (m_settings->m_protocol.compare(PROTOCOL_AUTO, Qt::CaseInsensitive) == 0)
+    {
+        const CControllerProtocol *protocol = CControllerProtocol::identify(lines);
+        if (protocol)
+        {
+            setProtocol(protocol);
+        }
+    }
+
+    m_protocol->parseVersion(lines, &m_result.m_versionARM, &m_result.m_versionDSP, &m_result.m_versionFPGA);
+    emit firmwareVersionChanged(m_result.m_versionARM, m_result.m_versionDSP, m_result.m_versionFPGA);
+}
+
+
+/*!
+ * @brief parses the response to "led_dac" and reports the values
+ *
+ * @param[in] response - the response line, empty if there was none
+ * @return true if the values of all channels were found
+ *
+ * @author J. Peterson
+ * @date 01/23/2015
+*/
+bool CCalibrationEngine::parseDacValues(const QString &response)
+{
+    int values[LED_CHANNELS_MAX];
+    int found = m_protocol->parseDac(response, values);
+
+    QVector<int> dac(m_channels, 0);
+    for (int c=0; (c<m_channels) && (c<found); c++)
+    {
+        dac[c] = values[c];
+    }
+
+    bool sawError = response.isEmpty() || (found < m_channels);
+    emit dacValuesChanged(!sawError, dac);
+    return(!sawError);
+}
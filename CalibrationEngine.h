@@ -0,0 +1,452 @@
+/*!
+ * @file CalibrationEngine.h
+ * @brief Declares the calibration engine for a single controller
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version, moved out of MainWindow
+ *   2      | agent        | 10/18/2026  | any number of LED channels, high thresholds searched together
+ *   3      | agent        | 10/18/2026  | commands and responses through the controller protocol
+ *   4      | agent        | 10/18/2026  | check of the saved calibration
+ *   5      | agent        | 10/18/2026  | binary trace of the serial traffic and the measurements
+ *   6      | agent        | 10/18/2026  | precise settle delays in real-time mode, settle wakeup latency
+ *   7      | agent        | 10/18/2026  | version mismatch confirmed through confirm()
+ *   8      | agent        | 10/18/2026  | idle monitor, link search and baud negotiation as states
+ *
+*/
+
+#ifndef CALIBRATIONENGINE_H
+#define CALIBRATIONENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QStringList>
+#include <QMetaType>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "Settings.h"
+#include "SerialBuffer.h"
+#include "ExposureAccumulator.h"
+#include "CalibrationJournal.h"
+#include "HistoryStore.h"
+#include "DriftMonitor.h"
+#include "ControllerStream.h"
+#include "LedChannels.h"
+#include "ControllerProtocol.h"
+#include "TraceFile.h"
+
+
+/*!
+ * Timed steps of a calibration run, in the order they are run.  The
+ * dashboard's table of step times in mainwindow.ui has a row for each.
+ */
+enum CalibrationTiming
+{
+    Timing_Connect,         // open the port, check the echo, initialize
+    Timing_Version,         // firmware version check
+    Timing_Scope,           // read stored values, check for the scope
+    Timing_SearchLow,       // low threshold searches of all channels
+    Timing_SearchHigh,      // high threshold search of all channels
+    Timing_Save,            // write the new values to the controller
+    Timing_Check,           // read back and probe the saved values
+    TIMING_PHASES
+};
+
+extern const char *c_timingName[TIMING_PHASES];
+
+
+/*!
+ * Outcome of one calibration run.
+ */
+class CCalibrationResult
+{
+public:
+    CCalibrationResult();
+    QJsonObject toJson() const;
+
+public:
+    QString m_station;          // name of the station (serial port) that ran the calibration
+    QString m_operator;         // operator name
+    QString m_serialNumber;     // serial number of the unit
+    QString m_versionARM;       // firmware versions reported by the controller
+    QString m_versionDSP;
+    QString m_versionFPGA;
+    QString m_profile;          // calibration profile the run used
+    QString m_protocol;         // firmware protocol the controller was spoken to in
+    int     m_channels;         // LED channels of the unit, the entries used below
+    int     m_oldLow[LED_CHANNELS_MAX];   // led_cal values found on the controller before calibration
+    int     m_oldHigh[LED_CHANNELS_MAX];
+    int     m_low[LED_CHANNELS_MAX];      // new calibration values, -1 if not found
+    int     m_high[LED_CHANNELS_MAX];
+    double  m_I[LED_CHANNELS_MAX];        // last current and voltage readings
+    double  m_V[LED_CHANNELS_MAX];
+    int     m_totalExposure;    // last total exposure reading
+    bool    m_success;          // true if the calibration was found and saved
+    int     m_saveCheck;        // check of the saved values: 1 passed, 0 failed, -1 not run
+    QString m_error;            // reason for failure
+    int     m_failedPhase;      // CalibrationTiming step the run failed in, -1 if it did not fail there
+    QStringList m_alerts;       // drift and outlier alerts raised by this run
+    QDateTime m_startTime;      // when the run started
+    qint64  m_durationMs;       // length of the whole run
+    qint64  m_phaseMs[TIMING_PHASES];   // time spent in each step, -1 if not reached
+};
+
+Q_DECLARE_METATYPE(CCalibrationResult)
+
+
+/*!
+ * Progress of one channel in the search of the high thresholds, which
+ * searches all channels at once.
+ */
+class CChannelSearch
+{
+public:
+    //! where the bracket being verified came from
+    enum Source
+    {
+        Source_None,
+        Source_Journal,         // threshold found by an interrupted run
+        Source_Bracket,         // bracket of an interrupted run
+        Source_Prior            // window from the history
+    };
+
+public:
+    int     m_X1;               // search bracket
+    int     m_X2;
+    int     m_M;                // code being probed
+    bool    m_done;             // threshold found, it is m_X1
+    int     m_source;           // Source of the bracket being verified
+    int     m_verifyLow;        // bracket being verified
+    int     m_verifyHigh;
+    bool    m_skipLow;          // end known to be below/above the threshold
+    bool    m_skipHigh;
+    bool    m_verifyBelow;      // low end measured below the threshold
+};
+
+
+/*!
+ * Talks to one controller over one serial port and implements the idle
+ * monitor and the calibration sequence.  The engine has no user interface;
+ * everything that should be displayed is reported through signals.
+ *
+ * The calibration runs as a state machine driven by the event loop: every
+ * command, settle delay and wait for streamed data suspends the run until
+ * its signal or timer resumes it (see step()).  start() returns at once and
+ * calibrationFinished() reports the outcome.  A pass of the idle monitor
+ * runs the same way, started by poll() and reported by
+ * monitorStateChanged(), so the engine never waits on the controller.
+ */
+class CCalibrationEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! controller state as seen by a pass of the idle monitor
+    enum PollState
+    {
+        Poll_NoSerialPort,
+        Poll_NoEcho,
+        Poll_NoResponse,
+        Poll_NoScope,
+        Poll_ScopeDetected
+    };
+
+    //! steps of the calibration, see step()
+    enum RunState
+    {
+        Run_Idle,
+        Run_Open,               // calibration sequence
+        Run_Echo,
+        Run_Init,
+        Run_Negotiated,
+        Run_Version,
+        Run_VersionConfirmed,
+        Run_StoredCal,
+        Run_ScopeStyle,
+        Run_Scope,
+        Run_ScopeDone,
+        Run_StreamStarted,
+        Run_StreamFallback,
+        Run_SearchStart,
+        Run_PhaseDone,
+        Run_HighDone,
+        Run_Found,
+        Run_Save,
+        Run_Saved,
+        Run_LedOff,
+        Run_LedOffDone,
+        Run_StreamStopped,
+        Run_Finish,
+        Run_Abort,
+        Search_Begin,           // threshold search of m_phase
+        Search_JournalChecked,
+        Search_BracketChecked,
+        Search_Prior,
+        Search_PriorChecked,
+        Search_Bisect,
+        Search_BisectSettle,
+        Search_Step,
+        Search_Stepped,
+        Batch_Begin,            // search of the high thresholds of all channels
+        Batch_Verify,
+        Batch_VerifyLow,
+        Batch_VerifyHigh,
+        Batch_Bisect,
+        Batch_BisectSettle,
+        Batch_Step,
+        Batch_Stepped,
+        Check_Begin,            // check of the saved calibration
+        Check_ReadBack,
+        Check_High,
+        Check_Low,
+        Verify_Low,             // probe of both ends of a bracket
+        Verify_High,
+        Probe_Measured,         // measurement of DAC codes of m_phase
+        Probe_Settled,
+        Measure_Settle,         // DAC setting with all measurements
+        Measure_ReadDac,
+        Measure_Dac,
+        Measure_VI,
+        Measure_Frame,
+        Measure_FrameRead,
+        Commands_Next,          // list of commands without responses
+        Link_Echo,              // search for the rate of the controller
+        Link_Rate,
+        Negotiate_Next,         // change to the fastest rate that works
+        Negotiate_Switch,
+        Negotiate_Check,
+        Negotiate_Fallback,
+        Monitor_Begin,          // one pass of the idle monitor
+        Monitor_Connected,
+        Monitor_EventsOff,
+        Monitor_StyleSet,
+        Monitor_Negotiated,
+        Monitor_Version,
+        Monitor_StoredCal,
+        Monitor_StartDac,
+        Monitor_StreamStarted,
+        Monitor_StreamFallback,
+        Monitor_Readings,
+        Monitor_VI,
+        Monitor_Exposure,
+        Monitor_Frame,
+        Monitor_ScopeCal,
+        Monitor_Dac,
+        Monitor_DacRead,
+        Monitor_Check,
+        Monitor_Stream,
+        Monitor_StreamCal,
+        Monitor_StreamReadDac,
+        Monitor_StreamDac,
+        Monitor_StreamCheck,
+        Monitor_Echo
+    };
+
+public:
+    explicit CCalibrationEngine(CSettings *settings, QObject *parent = 0);
+    ~CCalibrationEngine();
+
+    QString serialPortName() const          { return(m_serialPortName); }
+    void    setOperator(QString name)       { m_operator = name; }
+    void    setSerialNumber(QString serial) { m_serialNumber = serial; }
+
+    const CCalibrationResult &result() const { return(m_result); }
+    bool isRunning() const { return((m_state != Run_Idle) && !m_monitoring); }
+    void resetMonitor();
+
+public slots:
+    void setSerialPortName(QString name);
+    bool start();
+    bool start(QString operatorName, QString serialNumber);
+    void confirm(bool proceed);
+    void poll();
+
+signals:
+    void statusChanged(QString text);
+    void errorOccurred(QString text);
+    void confirmationRequested(QString text);
+    void monitorStateChanged(int state);
+    void firmwareVersionChanged(QString arm, QString dsp, QString fpga);
+    void storedCalibrationChanged(QVector<int> low, QVector<int> high);
+    void currentAndVoltageChanged(bool valid, QVector<double> V, QVector<double> I);
+    void exposureChanged(bool valid, QVector<double> means, QVector<double> variances, int frames);
+    void dacValuesChanged(bool valid, QVector<int> dac);
+    void newCalibrationChanged(QVector<int> low, QVector<int> high);
+    void calibrationFinished(CCalibrationResult result);
+
+private slots:
+    void resume();
+    void onTransactionFinished(bool ok, QStringList lines);
+    void onWaitTimeout();
+    void onStreamEvents();
+
+private:
+    //! stream data a suspended step is waiting for
+    enum StreamWait
+    {
+        Wait_None,
+        Wait_Voltage,
+        Wait_Exposure
+    };
+
+private:
+    bool selectProtocol();
+    void setProtocol(const CControllerProtocol *protocol);
+    void parseFirmwareVersion(const QStringList &lines);
+    void parseCalibrationValues(QString calString);
+    bool parseDacValues(const QString &response);
+    bool parseCurrentAndVoltage(const QString &response);
+    bool parseExposureFrame(const QStringList &lines, int *zones);
+    bool publishCurrentAndVoltage(bool valid);
+    bool publishExposure(const int *zones);
+    void takeStreamFrame(int *zones);
+    bool takeStreamVoltage();
+    bool highPhase(int phase) const { return(phase >= m_channels); }
+    int  phaseChannel(int phase) const { return(phase % m_channels); }
+    QString phaseName(int phase) const;
+    bool belowThreshold(int phase);
+    const int *searchWindow(int phase) const;
+    void emitNewCalibration();
+    void step();
+    void stepRun();
+    void stepSearch();
+    void stepBatch();
+    void stepCheck();
+    void stepProbe();
+    void stepMeasure();
+    void stepLink();
+    void stepMonitor();
+    void send(const QString &command, int responseLines, int next);
+    void settle(int ms, int next);
+    void waitStream(StreamWait wait, int next);
+    void sendCommands(const QStringList &commands, int next);
+    void connectLink(int next);
+    void negotiateLink(int next);
+    void startStream(int next);
+    void endMonitor(PollState state);
+    void cancelMonitor();
+    void measure(const int *dac, int next);
+    void measurePhase(int value, int next);
+    void probe(int value, int next);
+    void probeCodes(const int *dac, int next);
+    void batchVerify(bool high);
+    void endBatch(bool ok);
+    void endCheck(QString error);
+    void verify(int low, int high, bool skipLow, bool skipHigh, int next);
+    void endSearch(int value);
+    void finishRun();
+    void abortRun();
+    void fail(QString msg);
+    void endTiming(int timing);
+    bool monitorDue(QElapsedTimer &last, int intervalMS);
+    QString firmware() const;
+    QString fixtureName() const;
+    bool openHistory();
+    void openTrace();
+    void loadSearchPriors();
+    void recordHistory();
+
+private:
+    CSettings           *m_settings;
+    CCalibrationProfile  m_profile;     // profile of the run, taken from m_settings when it starts
+    CSerialBuffer        m_serialBuffer;
+    CExposureAccumulator m_exposure;
+    CCalibrationJournal  m_journal;
+    CHistoryStore        m_history;
+    CTraceWriter         m_trace;       // trace of this station, open while tracing
+    CSearchPrior         m_prior;       // search windows from the history, m_samples 0 if none
+    CDriftMonitor        m_drift;       // statistics of the results of this fixture
+    CControllerStream    m_stream;      // events received while streaming
+    const CControllerProtocol *m_protocol;  // protocol of the controller's firmware, never 0
+
+    QString       m_serialPortName;
+    QString       m_operator;
+    QString       m_serialNumber;
+    CCalibrationResult m_result;
+    QElapsedTimer m_runTimer;       // started by start()
+    QElapsedTimer m_phaseTimer;     // restarted at the end of every timed step
+
+    bool          m_monitoring;         // m_state is in a pass of the idle monitor
+    bool          m_monitorOk;          // no reading of the pass failed
+    PollState     m_pollState;          // result of the last pass
+    bool          m_monitorConnected;   // port open and static data read by the monitor
+    bool          m_monitorScope;       // scope seen by the last exposure reading of the monitor
+    QElapsedTimer m_monitorVoltage;     // last I/V reading of the monitor
+    QElapsedTimer m_monitorExposure;    // last exposure reading of the monitor
+    QElapsedTimer m_monitorDac;         // last DAC reading of the monitor
+
+    bool          m_streaming;          // controller events on, readings come from m_stream
+    qint64        m_streamExposureSeen; // number of the next stream frame to use
+    qint64        m_streamVoltageSeen;  // number of the next stream I/V sample to use
+
+    int           m_totalExposure;
+    int           m_channels;           // LED channels of the unit, from the profile
+    CLedChannel   m_channel[LED_CHANNELS_MAX];
+
+    //
+    // State of the calibration run.  Each of the nested steps (search,
+    // verify, probe, measure, commands) returns to the state its caller
+    // gave it; none of them is ever entered twice at the same time.
+    //
+    int           m_state;              // RunState to execute next
+    bool          m_waiting;            // suspended until a transaction, timer or stream event
+    QTimer        m_waitTimer;          // settle delay, stream timeout or the start of a run; child, so it moves with the engine
+    int           m_settleMS;           // settle delay m_waitTimer runs for, -1 if it runs for something else
+    QElapsedTimer m_settleClock;        // started with the settle delay
+    StreamWait    m_streamWait;
+    bool          m_replyOk;            // outcome of the last transaction, stream wait or confirmation
+    bool          m_confirmPending;     // suspended until confirm()
+    QStringList   m_reply;              // response lines of the last transaction
+
+    int           m_phase;              // phase being searched, see JOURNAL_PHASES
+    int           m_searchValue;        // threshold found, -1 on lost communication
+    int           m_X1;                 // search bracket
+    int           m_X2;
+    int           m_M;
+
+    CChannelSearch m_batch[LED_CHANNELS_MAX];   // high threshold search of each channel
+    int           m_batchRound;         // 0 to verify journaled brackets, 1 for the history windows
+    int           m_saveChannel;        // next channel whose values are saved
+    int           m_checkChannel;       // channel checked on its own, -1 while all are checked together
+
+    int           m_verifyLow;          // bracket being verified
+    int           m_verifyHigh;
+    bool          m_verifySkipHigh;
+    bool          m_verifyBelow;
+    bool          m_verifyOk;           // both probes measured
+    bool          m_verifyHolds;        // low end below, high end above the threshold
+    int           m_verifyReturn;
+
+    bool          m_probeOk;
+    bool          m_probeBelow;
+    int           m_probeReturn;
+
+    int           m_measureDac[LED_CHANNELS_MAX];
+    int           m_measureFrame;       // exposure frames read so far
+    bool          m_measureOk;
+    int           m_measureReturn;
+
+    QStringList   m_commands;
+    int           m_commandIndex;
+    bool          m_commandsOk;
+    int           m_commandsReturn;
+
+    bool          m_linkOk;             // the controller echoed at the rate found
+    QList<qint32> m_linkRates;          // rates to try
+    int           m_linkIndex;          // next rate to try
+    qint32        m_linkRate;           // rate being negotiated
+    qint32        m_linkPrevious;       // rate in use before the search or negotiation
+    int           m_linkChecks;         // echo checks passed at the rate being tried
+    int           m_linkReturn;
+};
+
+#endif // CALIBRATIONENGINE_H
@@ -0,0 +1,301 @@
+/*!
+ * @file CalibrationJournal.cpp
+ * @brief Implements the on-disk journal of an in-progress calibration
+ *
+ * Journal files live in the "journal" directory next to the ini file and
+ * are named after the serial number.  Records are one per line:
+ *
+ *   start <firmware>
+ *   bracket <phase> <X1> <X2>
+ *   phase <phase> <value>
+ *   discard <phase>
+ *
+ * A journal written for different firmware is ignored and restarted.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QDir>
+#include <QStringList>
+#include <QRegExp>
+#include <QTextStream>
+#include "CalibrationJournal.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//
+// Directory that holds the journal files
+//
+const char *c_journalDir = "journal";
+
+
+CCalibrationJournal::CCalibrationJournal()
+{
+    for (int i=0; i<JOURNAL_PHASES; i++)
+    {
+        m_done[i] = false;
+        m_value[i] = -1;
+        m_bracket[i] = false;
+        m_X1[i] = m_X2[i] = -1;
+    }
+}
+
+CCalibrationJournal::~CCalibrationJournal()
+{
+    close();
+}
+
+
+/*!
+ * @brief opens (or creates) the journal of a unit
+ *
+ * Any progress already recorded for the same firmware is loaded.
+ *
+ * @param[in] serialNumber - serial number of the unit
+ * @param[in] firmware - firmware versions of the controller
+ * @return false if the journal file could not be opened
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationJournal::open(QString serialNumber, QString firmware)
+{
+    close();
+    for (int i=0; i<JOURNAL_PHASES; i++)
+    {
+        m_done[i] = false;
+        m_bracket[i] = false;
+    }
+
+    if (serialNumber.isEmpty())
+    {
+        return(false);
+    }
+
+    QDir().mkpath(c_journalDir);
+    QString name = serialNumber;
+    name.replace(QRegExp("[^A-Za-z0-9_.-]"), "_");
+    m_file.setFileName(QString("%1/%2.jnl").arg(c_journalDir).arg(name));
+
+    load(firmware);
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        return(false);
+    }
+    if (m_file.size() == 0)
+    {
+        append(QString("start %1").arg(firmware));
+    }
+    return(true);
+}
+
+
+void CCalibrationJournal::close()
+{
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+}
+
+
+/*!
+ * @brief deletes the journal once the calibration has been saved
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationJournal::remove()
+{
+    close();
+    if (!m_file.fileName().isEmpty())
+    {
+        m_file.remove();
+    }
+}
+
+
+/*!
+ * @brief reads the records of an existing journal
+ *
+ * @param[in] firmware - firmware of the controller now attached
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationJournal::load(QString firmware)
+{
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return;
+    }
+
+    QTextStream in(&m_file);
+    bool valid = false;
+    while (!in.atEnd())
+    {
+        QStringList fields = in.readLine().split(' ', QString::SkipEmptyParts);
+        if (fields.isEmpty())
+        {
+            continue;
+        }
+
+        if (fields[0] == "start")
+        {
+            valid = (fields.mid(1).join(" ") == firmware);
+            continue;
+        }
+
+        int phase = (fields.size() > 1) ? fields[1].toInt() : -1;
+        if (!valid || (phase < 0) || (phase >= JOURNAL_PHASES))
+        {
+            continue;
+        }
+
+        if ((fields[0] == "bracket") && (fields.size() == 4))
+        {
+            m_bracket[phase] = true;
+            m_X1[phase] = fields[2].toInt();
+            m_X2[phase] = fields[3].toInt();
+        }
+        else if ((fields[0] == "phase") && (fields.size() == 3))
+        {
+            m_done[phase] = true;
+            m_value[phase] = fields[2].toInt();
+        }
+        else if (fields[0] == "discard")
+        {
+            m_done[phase] = false;
+            m_bracket[phase] = false;
+        }
+    }
+    m_file.close();
+
+    //
+    // A journal from other firmware is of no use, start a new one
+    //
+    if (!valid)
+    {
+        m_file.remove();
+        for (int i=0; i<JOURNAL_PHASES; i++)
+        {
+            m_done[i] = false;
+            m_bracket[i] = false;
+        }
+    }
+}
+
+
+bool CCalibrationJournal::phaseDone(int phase) const
+{
+    return((phase >= 0) && (phase < JOURNAL_PHASES) && m_done[phase]);
+}
+
+int CCalibrationJournal::phaseValue(int phase) const
+{
+    return(phaseDone(phase) ? m_value[phase] : -1);
+}
+
+bool CCalibrationJournal::hasBracket(int phase) const
+{
+    return((phase >= 0) && (phase < JOURNAL_PHASES) && m_bracket[phase]);
+}
+
+int CCalibrationJournal::bracketLow(int phase) const
+{
+    return(hasBracket(phase) ? m_X1[phase] : -1);
+}
+
+int CCalibrationJournal::bracketHigh(int phase) const
+{
+    return(hasBracket(phase) ? m_X2[phase] : -1);
+}
+
+
+/*!
+ * @brief records a confirmed search bracket
+ *
+ * @param[in] phase - search phase
+ * @param[in] X1, X2 - the threshold is known to lie in [X1, X2)
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationJournal::recordBracket(int phase, int X1, int X2)
+{
+    m_bracket[phase] = true;
+    m_X1[phase] = X1;
+    m_X2[phase] = X2;
+    append(QString("bracket %1 %2 %3").arg(phase).arg(X1).arg(X2));
+}
+
+
+/*!
+ * @brief records the result of a finished phase
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationJournal::recordPhase(int phase, int value)
+{
+    m_done[phase] = true;
+    m_value[phase] = value;
+    append(QString("phase %1 %2").arg(phase).arg(value));
+}
+
+
+/*!
+ * @brief forgets a phase whose recorded progress failed verification
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationJournal::discardPhase(int phase)
+{
+    m_done[phase] = false;
+    m_bracket[phase] = false;
+    append(QString("discard %1").arg(phase));
+}
+
+
+void CCalibrationJournal::append(QString record)
+{
+    if (!m_file.isOpen())
+    {
+        return;
+    }
+    record.append('\n');
+    m_file.write(record.toLatin1());
+    sync();
+}
+
+
+/*!
+ * @brief pushes the written records all the way to the disk
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationJournal::sync()
+{
+    m_file.flush();
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    fsync(m_file.handle());
+#endif
+}
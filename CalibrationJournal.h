@@ -0,0 +1,75 @@
+/*!
+ * @file CalibrationJournal.h
+ * @brief Declares the on-disk journal of an in-progress calibration
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | phases for any number of LED channels
+ *
+*/
+
+#ifndef CALIBRATIONJOURNAL_H
+#define CALIBRATIONJOURNAL_H
+
+#include <QString>
+#include <QFile>
+#include "LedChannels.h"
+
+//
+// Threshold searches of a run with n channels: the low thresholds of
+// channels 1 to n are phases 0 to n-1, their high thresholds n to 2n-1.
+//
+#define JOURNAL_PHASES  (2*LED_CHANNELS_MAX)
+
+
+/*!
+ * Records the progress of the threshold searches of one unit so that a
+ * calibration interrupted by a crash or a lost connection can resume.
+ *
+ * The journal is a small append-only text file per serial number.  Every
+ * record is flushed and synced to disk before the search continues, so a
+ * record that was written is never lost.
+ */
+class CCalibrationJournal
+{
+public:
+    CCalibrationJournal();
+    ~CCalibrationJournal();
+
+public:
+    bool open(QString serialNumber, QString firmware);
+    void close();
+    void remove();
+
+    bool phaseDone(int phase) const;
+    int  phaseValue(int phase) const;
+    bool hasBracket(int phase) const;
+    int  bracketLow(int phase) const;
+    int  bracketHigh(int phase) const;
+
+    void recordBracket(int phase, int X1, int X2);
+    void recordPhase(int phase, int value);
+    void discardPhase(int phase);
+
+private:
+    void load(QString firmware);
+    void append(QString record);
+    void sync();
+
+private:
+    QFile   m_file;
+    bool    m_done[JOURNAL_PHASES];     // phase finished
+    int     m_value[JOURNAL_PHASES];    // result of a finished phase
+    bool    m_bracket[JOURNAL_PHASES];  // a bracket was recorded
+    int     m_X1[JOURNAL_PHASES];       // last recorded bracket
+    int     m_X2[JOURNAL_PHASES];
+};
+
+#endif // CALIBRATIONJOURNAL_H
@@ -0,0 +1,593 @@
+/*!
+ * @file CommandLine.cpp
+ * @brief Implements the headless command line calibration mode
+ *
+ * Usage:
+ *   LED_cal --port COM3 --operator jgp --serial SG12345 [--allow-version-mismatch] [--quiet]
+ *   LED_cal --history SG12345
+ *   LED_cal --request '{"op":"start","serial":"SG12345"}' [--follow] [--server LED_cal]
+ *   LED_cal --link-test [--port COM3]
+ *   LED_cal --trace LED_cal_trace_COM3.bin [--from 2026-10-18T09:30:00 | --record N | --serial SG12345] [--count N]
+ *
+ * No window is created and only a QCoreApplication is needed, so the mode
+ * works without a display server and starts quickly from test scripts.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | dump of a binary trace
+ *   3      | agent        | 10/18/2026  | real-time mode, wakeup latency in the link test
+ *   4      | agent        | 10/18/2026  | trace dump from a unit's run
+ *
+*/
+
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QLocalSocket>
+#include <QEventLoop>
+#include <cstdio>
+#include "CommandLine.h"
+#include "CalibrationEngine.h"
+#include "Settings.h"
+#include "ReportWriter.h"
+#include "HistoryStore.h"
+#include "Metrics.h"
+#include "SerialBuffer.h"
+#include "TraceFile.h"
+#include "RealTime.h"
+
+
+/*!
+ * @brief summarizes the wakeup latency of one kind of wait
+ *
+ * The 99th percentile is the upper bound of its histogram bucket, -1 if
+ * it is beyond the last bucket.
+ *
+ * @param[in] source - one of the CMetrics::WakeupSource values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static QJsonObject wakeupLatency(int source)
+{
+    const CMetricHistogram *latency = CMetrics::instance()->wakeupLatency(source);
+    qint64 count = latency->count();
+    QJsonObject json;
+    json["count"] = (double)count;
+    json["meanUs"] = (count > 0) ? latency->sum() / (double)count : 0.0;
+    json["p99Us"] = (double)latency->quantile(0.99);
+    json["maxUs"] = (double)CMetrics::instance()->wakeupMax(source);
+    json["early"] = (double)CMetrics::instance()->wakeupEarly(source);
+    return(json);
+}
+
+
+CCommandLine::CCommandLine(QObject *parent) :
+    QObject(parent)
+{
+    m_quiet = false;
+    m_allowVersionMismatch = false;
+}
+
+
+/*!
+ * @brief checks whether the program was started in command line mode
+ *
+ * @param[in] argc, argv - arguments passed to main()
+ * @return true if any of the command line options is present
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCommandLine::isRequested(int argc, char *argv[])
+{
+    for (int i=1; i<argc; i++)
+    {
+        QString arg = QString::fromLocal8Bit(argv[i]);
+        if (    arg.startsWith("--port")
+             || arg.startsWith("--serial")
+             || arg.startsWith("--operator")
+             || arg.startsWith("--history")
+             || arg.startsWith("--request")
+             || (arg == "--link-test")
+             || arg.startsWith("--trace")
+             || (arg == "--headless")
+             || (arg == "--help") )
+        {
+            return(true);
+        }
+    }
+    return(false);
+}
+
+
+/*!
+ * @brief parses the arguments and runs the calibration
+ *
+ * @param[in] arguments - QCoreApplication::arguments()
+ * @return process exit code, one of the EXIT_CAL_ values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CCommandLine::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Spyglass LED calibration, headless mode");
+    parser.addHelpOption();
+    QCommandLineOption headlessOption("headless", "Run without a user interface (implied by the options below).");
+    QCommandLineOption portOption("port", "Serial port of the controller.", "port");
+    QCommandLineOption operatorOption("operator", "Operator name.", "name");
+    QCommandLineOption serialOption("serial", "Serial number of the unit. With --trace, start at the last run of this unit.", "number");
+    QCommandLineOption mismatchOption("allow-version-mismatch", "Continue if the firmware is not the expected version.");
+    QCommandLineOption quietOption("quiet", "Do not print progress to stderr.");
+    QCommandLineOption historyOption("history", "Print the earlier calibrations of a unit and exit.", "number");
+    QCommandLineOption requestOption("request", "Send a JSON request to the automation API of a running LED_cal and print the response. May be repeated.", "json");
+    QCommandLineOption followOption("follow", "With --request, print progress events until the started calibration finishes.");
+    QCommandLineOption serverOption("server", "Name of the automation API server (default from LED_Cal.ini).", "name");
+    QCommandLineOption linkTestOption("link-test", "Measure the round trip time and throughput of the link at every configured rate and exit.");
+    parser.addOption(headlessOption);
+    parser.addOption(portOption);
+    parser.addOption(operatorOption);
+    parser.addOption(serialOption);
+    parser.addOption(mismatchOption);
+    parser.addOption(quietOption);
+    parser.addOption(historyOption);
+    parser.addOption(requestOption);
+    parser.addOption(followOption);
+    parser.addOption(serverOption);
+    QCommandLineOption traceOption("trace", "Print the records of a binary trace file, one JSON object per line, and exit.", "file");
+    QCommandLineOption fromOption("from", "With --trace, start at the first record at or after this local time (ISO 8601).", "time");
+    QCommandLineOption recordOption("record", "With --trace, start at this record number.", "number");
+    QCommandLineOption countOption("count", "With --trace, print at most this many records.", "number");
+    parser.addOption(linkTestOption);
+    parser.addOption(traceOption);
+    parser.addOption(fromOption);
+    parser.addOption(recordOption);
+    parser.addOption(countOption);
+
+    if (!parser.parse(arguments))
+    {
+        fprintf(stderr, "%s\n", qPrintable(parser.errorText()));
+        return(EXIT_CAL_USAGE);
+    }
+    if (parser.isSet("help"))
+    {
+        fprintf(stdout, "%s", qPrintable(parser.helpText()));
+        return(EXIT_CAL_PASS);
+    }
+
+    QString port = parser.value(portOption);
+    QString operatorName = parser.value(operatorOption);
+    QString serialNumber = parser.value(serialOption);
+    m_quiet = parser.isSet(quietOption);
+    m_allowVersionMismatch = parser.isSet(mismatchOption);
+
+    if (parser.isSet(traceOption))
+    {
+        return(printTrace(parser.value(traceOption), parser.value(fromOption), parser.value(recordOption),
+                          parser.value(serialOption), parser.value(countOption)));
+    }
+
+    CSettings settings;
+    if (parser.isSet(historyOption))
+    {
+        return(printHistory(&settings, parser.value(historyOption)));
+    }
+    if (parser.isSet(requestOption))
+    {
+        QString server = parser.isSet(serverOption) ? parser.value(serverOption) : settings.m_automationServer;
+        return(sendRequests(server, parser.values(requestOption), parser.isSet(followOption)));
+    }
+
+    //
+    // The port defaults to the one last used by the GUI
+    //
+    if (port.isEmpty())
+    {
+        port = settings.m_serialPort;
+    }
+
+    //
+    // The engine and its serial I/O run in this thread
+    //
+    QStringList problems;
+    if (!CRealTimeMode::fromSettings(&settings).enter(&problems))
+    {
+        fprintf(stderr, "warning: %s\n", qPrintable(problems.join("\nwarning: ")));
+    }
+
+    if (parser.isSet(linkTestOption))
+    {
+        return(testLink(&settings, port));
+    }
+
+    if (port.isEmpty() || operatorName.isEmpty() || serialNumber.isEmpty())
+    {
+        fprintf(stderr, "--port, --operator and --serial are required.\n");
+        return(EXIT_CAL_USAGE);
+    }
+
+    CCalibrationEngine engine(&settings);
+    connect(&engine, SIGNAL(statusChanged(QString)), this, SLOT(onStatusChanged(QString)));
+    connect(&engine, SIGNAL(errorOccurred(QString)), this, SLOT(onErrorOccurred(QString)));
+    connect(&engine, SIGNAL(confirmationRequested(QString)),
+            this, SLOT(onConfirmationRequested(QString)));
+
+    engine.setSerialPortName(port);
+    engine.setOperator(operatorName);
+    engine.setSerialNumber(serialNumber);
+
+    //
+    // The engine runs from the event loop; this is the only loop running
+    //
+    QEventLoop loop;
+    connect(&engine, SIGNAL(calibrationFinished(CCalibrationResult)), &loop, SLOT(quit()));
+    engine.start();
+    loop.exec();
+
+    const CCalibrationResult &result = engine.result();
+    bool passed = result.m_success;
+    if (!m_quiet && settings.m_realTimeEnabled)
+    {
+        fprintf(stderr, "settle wakeup latency: %s\n",
+                QJsonDocument(wakeupLatency(CMetrics::Wakeup_Settle)).toJson(QJsonDocument::Compact).constData());
+    }
+
+    //
+    // The writer's destructor writes and syncs the record before exit
+    //
+    CReportWriter reportWriter;
+    reportWriter.write(settings.m_reportFile, result);
+    CMetricsExporter(&settings).writeTextFile();
+    QByteArray json = QJsonDocument(result.toJson()).toJson(QJsonDocument::Compact);
+    fprintf(stdout, "%s\n", json.constData());
+    fflush(stdout);
+
+    if (passed)
+    {
+        return(EXIT_CAL_PASS);
+    }
+    if ((result.m_failedPhase >= Timing_Connect) && (result.m_failedPhase <= Timing_Scope))
+    {
+        return(EXIT_CAL_NO_CONTROLLER);
+    }
+    return(EXIT_CAL_FAIL);
+}
+
+
+/*!
+ * @brief prints the calibrations of a unit from the history, one JSON object per line
+ *
+ * @param[in] settings - application settings
+ * @param[in] serialNumber - serial number of the unit
+ * @return process exit code
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CCommandLine::printHistory(CSettings *settings, QString serialNumber)
+{
+    CHistoryStore history;
+    if (settings->m_historyFile.isEmpty() || !history.open(settings->m_historyFile))
+    {
+        fprintf(stderr, "The calibration history could not be opened.\n");
+        return(EXIT_CAL_FAIL);
+    }
+
+    QList<CCalibrationResult> results = history.findBySerialNumber(serialNumber);
+    for (int i=0; i<results.size(); i++)
+    {
+        QByteArray json = QJsonDocument(results[i].toJson()).toJson(QJsonDocument::Compact);
+        fprintf(stdout, "%s\n", json.constData());
+    }
+    fflush(stdout);
+    return(EXIT_CAL_PASS);
+}
+
+
+/*!
+ * @brief prints the records of a binary trace, one JSON object per line
+ *
+ * The trace is memory mapped and the start is found by a binary search of
+ * the block headers, or of the serial number index for a unit, so only
+ * the records printed are read.
+ *
+ * @param[in] fileName - the trace file
+ * @param[in] from - local time to start at, empty for the start of the trace
+ * @param[in] record - record number to start at, empty for the start of the trace
+ * @param[in] serialNumber - unit whose last run to start at, empty for the start of the trace
+ * @param[in] count - most records to print, empty for all
+ * @return EXIT_CAL_PASS, EXIT_CAL_USAGE for a bad argument, or EXIT_CAL_FAIL
+ *         if the file is not a trace
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CCommandLine::printTrace(QString fileName, QString from, QString record, QString serialNumber, QString count)
+{
+    static const char *c_types[] = { "none", "command", "response", "sample", "run" };
+
+    qint64 limit = -1;
+    bool ok = true;
+    if (!count.isEmpty())
+    {
+        limit = count.toLongLong(&ok);
+    }
+    if (!ok || (limit < -1))
+    {
+        fprintf(stderr, "--count must be a number.\n");
+        return(EXIT_CAL_USAGE);
+    }
+
+    CTraceReader reader;
+    if (!reader.open(fileName))
+    {
+        fprintf(stderr, "%s is not a trace file.\n", qPrintable(fileName));
+        return(EXIT_CAL_FAIL);
+    }
+
+    bool found = true;
+    if (!from.isEmpty())
+    {
+        QDateTime time = QDateTime::fromString(from, Qt::ISODate);
+        if (!time.isValid())
+        {
+            fprintf(stderr, "--from must be a time like 2026-10-18T09:30:00.\n");
+            return(EXIT_CAL_USAGE);
+        }
+        found = reader.seekTime(time.toMSecsSinceEpoch() * 1000);
+    }
+    else if (!record.isEmpty())
+    {
+        qint64 number = record.toLongLong(&ok);
+        if (!ok || (number < 0))
+        {
+            fprintf(stderr, "--record must be a number.\n");
+            return(EXIT_CAL_USAGE);
+        }
+        found = reader.seekRecord(number);
+    }
+    else if (!serialNumber.isEmpty())
+    {
+        found = reader.seekSerial(serialNumber, -1);
+    }
+
+    CTraceRecord trace;
+    for (qint64 n=0; found && (n != limit) && reader.next(&trace); n++)
+    {
+        QJsonObject json;
+        json["record"] = (double)trace.m_number;
+        json["time"] = QDateTime::fromMSecsSinceEpoch(trace.m_time / 1000).toString("yyyy-MM-dd'T'HH:mm:ss.zzz")
+                       + QString("%1").arg(trace.m_time % 1000, 3, 10, QChar('0'));
+        json["type"] = c_types[trace.m_type];
+        switch (trace.m_type)
+        {
+        case CTraceRecord::Trace_Command:
+        case CTraceRecord::Trace_Response:
+            json["ok"] = trace.m_ok;
+            json["ms"] = trace.m_ms;
+            json["text"] = trace.m_text;
+            break;
+
+        case CTraceRecord::Trace_Sample:
+            {
+                QJsonArray dac;
+                QJsonArray V;
+                QJsonArray I;
+                for (int c=0; c<trace.m_channels; c++)
+                {
+                    dac.append(trace.m_dac[c]);
+                    V.append(trace.m_V[c]);
+                    I.append(trace.m_I[c]);
+                }
+                QJsonArray zones;
+                for (int i=0; i<EXPOSURE_ZONES; i++)
+                {
+                    zones.append(trace.m_zones[i]);
+                }
+                json["dac"] = dac;
+                json["V"] = V;
+                json["I"] = I;
+                json["zones"] = zones;
+            }
+            break;
+
+        default:
+            json["serialNumber"] = trace.m_text;
+            break;
+        }
+        fprintf(stdout, "%s\n", QJsonDocument(json).toJson(QJsonDocument::Compact).constData());
+    }
+    fflush(stdout);
+    return(EXIT_CAL_PASS);
+}
+
+
+/*!
+ * @brief measures the link at the configured rate and every negotiable rate
+ *
+ * Prints one JSON object per rate with the mean echo round trip time and
+ * the bytes per second received while a response was due, then sets the
+ * controller back to its default rate.
+ *
+ * @param[in] settings - application settings
+ * @param[in] port - serial port of the controller
+ * @return EXIT_CAL_PASS, or EXIT_CAL_NO_CONTROLLER if the controller did not echo
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CCommandLine::testLink(CSettings *settings, QString port)
+{
+    const int rounds = 20;
+
+    CSerialBuffer serialBuffer;
+    serialBuffer.setLinkParameters(CLinkParameters::fromSettings(settings));
+    if (!serialBuffer.openPort(port) || !serialBuffer.checkForEcho())
+    {
+        fprintf(stderr, "No controller on %s\n", qPrintable(port));
+        return(EXIT_CAL_NO_CONTROLLER);
+    }
+    serialBuffer.writeLine("disable_events=1");
+
+    QList<qint32> rates = CLinkParameters::fastRates(settings);
+    rates.prepend(settings->m_linkBaudRate);
+    for (int i=0; i<rates.size(); i++)
+    {
+        QJsonObject json;
+        json["baud"] = rates[i];
+        if (!serialBuffer.changeBaudRate(settings->m_linkBaudCommand, rates[i]))
+        {
+            json["ok"] = false;
+        }
+        else
+        {
+            CLinkThroughput throughput = serialBuffer.measureThroughput(rounds);
+            json["ok"] = true;
+            json["rounds"] = throughput.m_rounds;
+            json["failures"] = throughput.m_failures;
+            json["rttMs"] = throughput.m_rttMs;
+            json["bytesPerSecond"] = throughput.m_bytesPerSecond;
+        }
+        fprintf(stdout, "%s\n", QJsonDocument(json).toJson(QJsonDocument::Compact).constData());
+        fflush(stdout);
+    }
+
+    serialBuffer.changeBaudRate(settings->m_linkBaudCommand, settings->m_linkBaudRate);
+
+    QJsonObject json;
+    json["wakeup"] = wakeupLatency(CMetrics::Wakeup_Snooze);
+    fprintf(stdout, "%s\n", QJsonDocument(json).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+    return(EXIT_CAL_PASS);
+}
+
+
+/*!
+ * @brief client of the automation API
+ *
+ * Sends the requests to the automation server of a running LED_cal and
+ * prints each response line.  With follow, progress events are printed
+ * until the calibration started by the requests finishes.  This is the
+ * reference client for the line-management software.
+ *
+ * @param[in] server - local server name
+ * @param[in] requests - JSON requests, one per element
+ * @param[in] follow - wait for the started calibration
+ * @return EXIT_CAL_PASS, or EXIT_CAL_FAIL if a request failed or the calibration failed
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CCommandLine::sendRequests(QString server, QStringList requests, bool follow)
+{
+    const int timeoutMS = 5000;
+
+    QLocalSocket socket;
+    socket.connectToServer(server);
+    if (!socket.waitForConnected(timeoutMS))
+    {
+        fprintf(stderr, "Could not connect to %s: %s\n", qPrintable(server), qPrintable(socket.errorString()));
+        return(EXIT_CAL_NO_CONTROLLER);
+    }
+
+    if (follow)
+    {
+        requests.prepend("{\"op\":\"subscribe\"}");
+    }
+
+    int exitCode = EXIT_CAL_PASS;
+    int job = 0;
+    int responses = 0;
+    for (int i=0; i<requests.size(); i++)
+    {
+        socket.write(requests[i].toUtf8().trimmed() + "\n");
+    }
+
+    //
+    // Read the responses, then the events of the started job
+    //
+    while ((responses < requests.size()) || (follow && (job != 0)))
+    {
+        if (!socket.canReadLine() && !socket.waitForReadyRead(follow ? -1 : timeoutMS))
+        {
+            fprintf(stderr, "No response from %s\n", qPrintable(server));
+            return(EXIT_CAL_FAIL);
+        }
+
+        while (socket.canReadLine())
+        {
+            QByteArray line = socket.readLine().trimmed();
+            QJsonObject message = QJsonDocument::fromJson(line).object();
+            if (message.contains("event"))
+            {
+                if (message["job"].toInt() != job)
+                {
+                    continue;
+                }
+                fprintf(stdout, "%s\n", line.constData());
+                if (message["event"].toString() == "finished")
+                {
+                    if (!message["result"].toObject()["success"].toBool())
+                    {
+                        exitCode = EXIT_CAL_FAIL;
+                    }
+                    job = 0;
+                }
+                continue;
+            }
+
+            fprintf(stdout, "%s\n", line.constData());
+            responses++;
+            if (!message["ok"].toBool())
+            {
+                exitCode = EXIT_CAL_FAIL;
+            }
+            if (follow && message.contains("job") && message["job"].isDouble())
+            {
+                job = message["job"].toInt();
+            }
+        }
+        fflush(stdout);
+    }
+
+    return(exitCode);
+}
+
+
+void CCommandLine::onStatusChanged(QString text)
+{
+    if (!m_quiet)
+    {
+        fprintf(stderr, "%s\n", qPrintable(text));
+    }
+}
+
+void CCommandLine::onErrorOccurred(QString text)
+{
+    fprintf(stderr, "error: %s\n", qPrintable(text.simplified()));
+}
+
+void CCommandLine::onConfirmationRequested(QString text)
+{
+    if (!m_quiet)
+    {
+        fprintf(stderr, "%s %s\n", qPrintable(text.simplified()), m_allowVersionMismatch ? "yes" : "no");
+    }
+
+    CCalibrationEngine *engine = qobject_cast<CCalibrationEngine *>(sender());
+    if (engine)
+    {
+        engine->confirm(m_allowVersionMismatch);
+    }
+}
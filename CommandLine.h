@@ -0,0 +1,67 @@
+/*!
+ * @file CommandLine.h
+ * @brief Declares the headless command line calibration mode
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | dump of a binary trace
+ *   3      | agent        | 10/18/2026  | trace dump from a unit's run
+ *
+*/
+
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class CSettings;
+
+//
+// Exit codes of the command line mode
+//
+#define EXIT_CAL_PASS           0   // calibration found and saved
+#define EXIT_CAL_FAIL           1   // calibration ran but failed
+#define EXIT_CAL_USAGE          2   // bad or missing arguments
+#define EXIT_CAL_NO_CONTROLLER  3   // port, controller, version or scope check failed
+
+
+/*!
+ * Runs a calibration without a user interface.  Progress goes to stderr
+ * and the result is written to stdout as a single JSON object.
+ */
+class CCommandLine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CCommandLine(QObject *parent = 0);
+
+    static bool isRequested(int argc, char *argv[]);
+    int run(const QStringList &arguments);
+
+private slots:
+    void onStatusChanged(QString text);
+    void onErrorOccurred(QString text);
+    void onConfirmationRequested(QString text);
+
+private:
+    int  printHistory(CSettings *settings, QString serialNumber);
+    int  sendRequests(QString server, QStringList requests, bool follow);
+    int  testLink(CSettings *settings, QString port);
+    int  printTrace(QString fileName, QString from, QString record, QString serialNumber, QString count);
+
+private:
+    bool m_quiet;                   // no progress output
+    bool m_allowVersionMismatch;    // continue when the firmware is not the expected version
+};
+
+#endif // COMMANDLINE_H
@@ -0,0 +1,374 @@
+/*!
+ * @file ControllerProtocol.cpp
+ * @brief Implements the text protocols of the controller firmware families
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QRegExp>
+#include "ControllerProtocol.h"
+#include "ExposureAccumulator.h"
+
+//
+// The compiled-in protocols; the first one is used when the name is
+// "auto" and the version response is not recognized.  A new firmware
+// family is a traits class and a line here.
+//
+static const CControllerProtocol c_protocols[] =
+{
+    protocolEntry<CSpyglassProtocol>()
+};
+
+static const int c_protocolCount = sizeof(c_protocols) / sizeof(c_protocols[0]);
+
+
+/*!
+ * @brief returns the protocol of the given name
+ *
+ * @param[in] name - name of a compiled-in protocol, or PROTOCOL_AUTO or
+ *                   empty for the first one
+ * @return the protocol, 0 if no protocol of that name is compiled in
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+const CControllerProtocol *CControllerProtocol::select(const QString &name)
+{
+    if (name.isEmpty() || (name.compare(PROTOCOL_AUTO, Qt::CaseInsensitive) == 0))
+    {
+        return(&c_protocols[0]);
+    }
+    for (int i=0; i<c_protocolCount; i++)
+    {
+        if (name.compare(c_protocols[i].m_name, Qt::CaseInsensitive) == 0)
+        {
+            return(&c_protocols[i]);
+        }
+    }
+    return(0);
+}
+
+
+/*!
+ * @brief returns the first protocol that understands a version response
+ *
+ * @param[in] versionLines - the response to the version command
+ * @return the protocol, 0 if none recognizes the response
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+const CControllerProtocol *CControllerProtocol::identify(const QStringList &versionLines)
+{
+    for (int i=0; i<c_protocolCount; i++)
+    {
+        QString arm;
+        QString dsp;
+        QString fpga;
+        if (c_protocols[i].parseVersion(versionLines, &arm, &dsp, &fpga))
+        {
+            return(&c_protocols[i]);
+        }
+    }
+    return(0);
+}
+
+
+/*!
+ * @brief returns the names of the compiled-in protocols
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QStringList CControllerProtocol::names()
+{
+    QStringList list;
+    for (int i=0; i<c_protocolCount; i++)
+    {
+        list.append(c_protocols[i].m_name);
+    }
+    return(list);
+}
+
+
+/*!
+ * @brief parses the response to "version"
+ *
+ * The lines are recognized by their prefix in any order.  The FPGA
+ * version is the rest of its line, the ARM and DSP versions the first
+ * word after the prefix.  Outputs whose line is missing are left alone.
+ *
+ * @param[in] lines - the response lines
+ * @param[out] arm, dsp, fpga - the versions
+ * @return true if at least one version was found
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSpyglassProtocol::parseVersion(const QStringList &lines, QString *arm, QString *dsp, QString *fpga)
+{
+    bool found = false;
+    for (int i=0; i<lines.size(); i++)
+    {
+        const QString &line = lines[i];
+        int index;
+        if ((index = line.indexOf("FPGA: ")) >= 0)
+        {
+            *fpga = line.mid(index+6).trimmed();
+            found = true;
+        }
+        else if ((index = line.indexOf("ARM: ")) >= 0)
+        {
+            *arm = line.mid(index+5).section(' ', 0, 0).trimmed();
+            found = true;
+        }
+        else if ((index = line.indexOf("DSP: ")) >= 0)
+        {
+            *dsp = line.mid(index+5).section(' ', 0, 0).trimmed();
+            found = true;
+        }
+    }
+    return(found);
+}
+
+
+/*!
+ * @brief parses the response to "led_cal"
+ *
+ * @param[in] line - the response line
+ * @param[out] low, high - thresholds of each channel, LED_CHANNELS_MAX entries
+ * @return number of channels found
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CSpyglassProtocol::parseCalibration(const QString &line, int *low, int *high)
+{
+    static const QRegExp c_values("low=(-?\\d+)[^)]*high=(-?\\d+)");
+
+    //
+    // One "(low=... high=...)" group per channel, in channel order
+    //
+    QRegExp rx(c_values);
+    int pos = 0;
+    int channels = 0;
+    while ((channels < LED_CHANNELS_MAX) && ((pos = rx.indexIn(line, pos)) >= 0))
+    {
+        pos += rx.matchedLength();
+        low[channels] = rx.cap(1).toInt();
+        high[channels] = rx.cap(2).toInt();
+        channels++;
+    }
+    return(channels);
+}
+
+
+/*!
+ * @brief parses the response to "led_dac"
+ *
+ * @param[in] line - the response line
+ * @param[out] dac - code of each channel, LED_CHANNELS_MAX entries
+ * @return number of channels from channel 1 on that have a code
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CSpyglassProtocol::parseDac(const QString &line, int *dac)
+{
+    static const QRegExp c_dac("led(\\d+)=([-0-9.]+)");
+
+    bool seen[LED_CHANNELS_MAX];
+    for (int i=0; i<LED_CHANNELS_MAX; i++)
+    {
+        seen[i] = false;
+    }
+
+    //
+    // "led1=<code>,led2=<code>,..."
+    //
+    QRegExp rx(c_dac);
+    int pos = 0;
+    while ((pos = rx.indexIn(line, pos)) >= 0)
+    {
+        pos += rx.matchedLength();
+        int channel = rx.cap(1).toInt() - 1;
+        bool ok;
+        double value = rx.cap(2).toDouble(&ok);
+        if (ok && (channel >= 0) && (channel < LED_CHANNELS_MAX))
+        {
+            dac[channel] = (int)value;
+            seen[channel] = true;
+        }
+    }
+
+    int channels = 0;
+    while ((channels < LED_CHANNELS_MAX) && seen[channels])
+    {
+        channels++;
+    }
+    return(channels);
+}
+
+
+/*!
+ * @brief parses a "ledvi" response or I/V event
+ *
+ * The line holds "Vn: value" and "In: value" for channels n = 1, 2, ...
+ * in any order, e.g. "V1: 3.10, I1: 0.512, V2: 3.08, I2: 0.498".
+ *
+ * @param[in] line - the line
+ * @param[out] V - voltage of each channel, LED_CHANNELS_MAX entries
+ * @param[out] I - current of each channel, LED_CHANNELS_MAX entries
+ * @return number of channels from channel 1 on that have both readings
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CSpyglassProtocol::parseReadings(const QString &line, double *V, double *I)
+{
+    static const QRegExp c_reading("\\b([VI])(\\d+):\\s*([-0-9.]+)");
+
+    bool seenV[LED_CHANNELS_MAX];
+    bool seenI[LED_CHANNELS_MAX];
+    for (int i=0; i<LED_CHANNELS_MAX; i++)
+    {
+        seenV[i] = seenI[i] = false;
+    }
+
+    QRegExp rx(c_reading);
+    int pos = 0;
+    while ((pos = rx.indexIn(line, pos)) >= 0)
+    {
+        pos += rx.matchedLength();
+        int channel = rx.cap(2).toInt() - 1;
+        bool ok;
+        double value = rx.cap(3).toDouble(&ok);
+        if (!ok || (channel < 0) || (channel >= LED_CHANNELS_MAX))
+        {
+            continue;
+        }
+        if (rx.cap(1) == "V")
+        {
+            V[channel] = value;
+            seenV[channel] = true;
+        }
+        else
+        {
+            I[channel] = value;
+            seenI[channel] = true;
+        }
+    }
+
+    int channels = 0;
+    while ((channels < LED_CHANNELS_MAX) && seenV[channels] && seenI[channels])
+    {
+        channels++;
+    }
+    return(channels);
+}
+
+
+/*!
+ * @brief parses one row of an exposure frame
+ *
+ * @param[in] line - the line
+ * @param[out] row - EXPOSURE_ROW_ZONES values, undefined if the line is not a row
+ * @return true if the line is a row of five values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSpyglassProtocol::parseExposureRow(const QString &line, int *row)
+{
+    QStringList list = line.split(QRegExp("\\W+"), QString::SkipEmptyParts);
+    if (list.size() != EXPOSURE_ROW_ZONES)
+    {
+        return(false);
+    }
+
+    for (int j=0; j<EXPOSURE_ROW_ZONES; j++)
+    {
+        bool b;
+        row[j] = list[j].toInt(&b);
+        if (!b)
+        {
+            return(false);
+        }
+    }
+    return(true);
+}
+
+
+/*!
+ * @brief parses the response to "em=-1"
+ *
+ * @param[in] lines - the response, a header line and five rows of five values
+ * @param[out] zones - EXPOSURE_ZONES values in row order, -1 where not read
+ * @return true if the frame is complete
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSpyglassProtocol::parseExposureFrame(const QStringList &lines, int *zones)
+{
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        zones[i] = -1;
+    }
+
+    //
+    // The first line is the header
+    //
+    for (int i=0; i<EXPOSURE_ZONES/EXPOSURE_ROW_ZONES; i++)
+    {
+        if (!parseExposureRow(lines.value(i+1), &zones[i*EXPOSURE_ROW_ZONES]))
+        {
+            return(false);
+        }
+    }
+    return(true);
+}
+
+
+/*!
+ * @brief builds the command that sets the DACs of all channels
+ *
+ * @param[in] dac - code of each channel
+ * @param[in] channels - number of channels
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QString CSpyglassProtocol::encodeDac(const int *dac, int channels)
+{
+    QStringList codes;
+    for (int c=0; c<channels; c++)
+    {
+        codes.append(QString::number(dac[c]));
+    }
+    return("led_dac=" + codes.join(","));
+}
+
+
+/*!
+ * @brief builds the command that writes the thresholds of one channel to flash
+ *
+ * @param[in] channel - channel, 0 for the first
+ * @param[in] low, high - the thresholds
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QString CSpyglassProtocol::encodeCalibration(int channel, int low, int high)
+{
+    return(QString("led_cal=%1,%2,%3").arg(channel).arg(low).arg(high));
+}
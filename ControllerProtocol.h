@@ -0,0 +1,138 @@
+/*!
+ * @file ControllerProtocol.h
+ * @brief Declares the text protocols of the controller firmware families
+ *
+ * Each firmware family is a traits class: a type whose static members
+ * name the commands and parse or build their text.  A family is compiled
+ * in by listing it in the table of ControllerProtocol.cpp, which takes the
+ * address of every member through protocolEntry<>().  The engine picks one
+ * entry at run time, by name or by the response to "version".  Every
+ * parse and build is then an indirect call through that entry's function
+ * pointers, not a call resolved at compile time; what the traits remove is
+ * the firmware version checks, which no code compares anymore.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef CONTROLLERPROTOCOL_H
+#define CONTROLLERPROTOCOL_H
+
+#include <QString>
+#include <QStringList>
+#include "LedChannels.h"
+
+#define PROTOCOL_AUTO       "auto"      // protocol name that selects by the response to "version"
+#define EXPOSURE_ROW_ZONES  5           // values in one row of an exposure frame
+
+
+/*!
+ * Protocol of the Spyglass controller firmware (ARM/DSP 2.1, FPGA 2.0x)
+ *
+ *   version  -> "FPGA: <v>", "ARM: <v> ...", "DSP: <v> ..."
+ *   led_cal  -> "(low=<code> ... high=<code>)" for every channel in order
+ *   led_dac  -> "led1=<code>,led2=<code>,..."
+ *   ledvi    -> "V1: <V>, I1: <A>, V2: ..." in any order
+ *   em=-1    -> a header line, then five rows of five values
+ *
+ * The I/V and exposure events are the same text as the responses.
+ */
+class CSpyglassProtocol
+{
+public:
+    static const char *name()               { return("spyglass"); }
+    static const char *versionCommand()     { return("version"); }
+    static const char *calibrationCommand() { return("led_cal"); }
+    static const char *dacCommand()         { return("led_dac"); }
+    static const char *readingsCommand()    { return("ledvi"); }
+    static const char *exposureCommand()    { return("em=-1"); }
+    static int  versionLines()              { return(3); }
+    static int  exposureLines()             { return(6); }
+
+    static bool parseVersion(const QStringList &lines, QString *arm, QString *dsp, QString *fpga);
+    static int  parseCalibration(const QString &line, int *low, int *high);
+    static int  parseDac(const QString &line, int *dac);
+    static int  parseReadings(const QString &line, double *V, double *I);
+    static bool parseExposureRow(const QString &line, int *row);
+    static bool parseExposureFrame(const QStringList &lines, int *zones);
+    static QString encodeDac(const int *dac, int channels);
+    static QString encodeCalibration(int channel, int low, int high);
+};
+
+
+/*!
+ * One compiled-in protocol: the members of its traits class taken by
+ * address, see protocolEntry().
+ *
+ * The parsers that fill per-channel arrays take LED_CHANNELS_MAX entries
+ * and return how many channels, from channel 1 on, were found.
+ */
+class CControllerProtocol
+{
+public:
+    static const CControllerProtocol *select(const QString &name);
+    static const CControllerProtocol *identify(const QStringList &versionLines);
+    static QStringList names();
+
+public:
+    const char *m_name;
+    const char *m_versionCommand;
+    const char *m_calibrationCommand;
+    const char *m_dacCommand;
+    const char *m_readingsCommand;
+    const char *m_exposureCommand;
+    int         m_versionLines;         // response lines of the version command
+    int         m_exposureLines;        // response lines of the exposure command
+
+    bool    (*parseVersion)(const QStringList &lines, QString *arm, QString *dsp, QString *fpga);
+    int     (*parseCalibration)(const QString &line, int *low, int *high);
+    int     (*parseDac)(const QString &line, int *dac);
+    int     (*parseReadings)(const QString &line, double *V, double *I);
+    bool    (*parseExposureRow)(const QString &line, int *row);
+    bool    (*parseExposureFrame)(const QStringList &lines, int *zones);
+    QString (*encodeDac)(const int *dac, int channels);
+    QString (*encodeCalibration)(int channel, int low, int high);
+};
+
+
+/*!
+ * @brief builds the table entry of a protocol traits class
+ *
+ * A traits class lacking a member fails to compile here, so every entry
+ * is complete.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+template <class Traits>
+CControllerProtocol protocolEntry()
+{
+    CControllerProtocol entry;
+    entry.m_name               = Traits::name();
+    entry.m_versionCommand     = Traits::versionCommand();
+    entry.m_calibrationCommand = Traits::calibrationCommand();
+    entry.m_dacCommand         = Traits::dacCommand();
+    entry.m_readingsCommand    = Traits::readingsCommand();
+    entry.m_exposureCommand    = Traits::exposureCommand();
+    entry.m_versionLines       = Traits::versionLines();
+    entry.m_exposureLines      = Traits::exposureLines();
+    entry.parseVersion         = &Traits::parseVersion;
+    entry.parseCalibration     = &Traits::parseCalibration;
+    entry.parseDac             = &Traits::parseDac;
+    entry.parseReadings        = &Traits::parseReadings;
+    entry.parseExposureRow     = &Traits::parseExposureRow;
+    entry.parseExposureFrame   = &Traits::parseExposureFrame;
+    entry.encodeDac            = &Traits::encodeDac;
+    entry.encodeCalibration    = &Traits::encodeCalibration;
+    return(entry);
+}
+
+#endif // CONTROLLERPROTOCOL_H
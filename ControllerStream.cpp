@@ -0,0 +1,127 @@
+/*!
+ * @file ControllerStream.cpp
+ * @brief Implements the parser of the controller's event stream
+ *
+ * The controller's event output is taken to use the same text as the
+ * responses to the polled commands, so the lines are parsed by the
+ * controller protocol: an I/V event is a line like the response to its
+ * readings command and an exposure event is the rows of the response to
+ * its exposure command, one line per row.  The commands that switch the
+ * events on and off are configurable (see CSettings).
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | events parsed by the controller protocol
+ *
+*/
+
+#include <QStringList>
+#include "ControllerStream.h"
+
+
+CControllerStream::CControllerStream()
+{
+    m_protocol = CControllerProtocol::select(PROTOCOL_AUTO);
+    m_clock.start();
+    m_exposureCount = 0;
+    m_voltageCount = 0;
+    clear();
+}
+
+
+/*!
+ * @brief forgets all samples
+ *
+ * The sample numbers keep counting so readers holding a number never see
+ * an old sample again.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CControllerStream::clear()
+{
+    m_lastEventTime = -1;
+    m_rows = 0;
+}
+
+
+/*!
+ * @brief consumes a line if it is an event
+ *
+ * @param[in] line - a complete line read from the controller
+ * @return true if the line was an event
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CControllerStream::filterLine(const QString &line)
+{
+    if (parseVoltage(line) || parseExposureRow(line))
+    {
+        m_lastEventTime = now();
+        return(true);
+    }
+    m_rows = 0;
+    return(false);
+}
+
+
+bool CControllerStream::parseVoltage(const QString &line)
+{
+    CVoltageSample &sample = m_voltage[m_voltageCount % STREAM_VOLTAGE_SAMPLES];
+    int channels = m_protocol->parseReadings(line, sample.m_V, sample.m_I);
+    if (channels == 0)
+    {
+        return(false);
+    }
+
+    sample.m_time = now();
+    sample.m_channels = channels;
+    m_voltageCount++;
+    return(true);
+}
+
+
+/*!
+ * @brief collects the rows of an exposure frame
+ *
+ * @param[in] line - a complete line
+ * @return true if the line was a row of an exposure frame
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CControllerStream::parseExposureRow(const QString &line)
+{
+    int row[EXPOSURE_ROW_ZONES];
+    if (!m_protocol->parseExposureRow(line, row))
+    {
+        return(false);
+    }
+
+    for (int j=0; j<EXPOSURE_ROW_ZONES; j++)
+    {
+        m_frame[m_rows*EXPOSURE_ROW_ZONES+j] = row[j];
+    }
+    m_rows++;
+
+    if (m_rows == EXPOSURE_ZONES/EXPOSURE_ROW_ZONES)
+    {
+        CExposureSample &sample = m_exposure[m_exposureCount % STREAM_EXPOSURE_FRAMES];
+        sample.m_time = now();
+        for (int i=0; i<EXPOSURE_ZONES; i++)
+        {
+            sample.m_zones[i] = m_frame[i];
+        }
+        m_exposureCount++;
+        m_rows = 0;
+    }
+    return(true);
+}
@@ -0,0 +1,100 @@
+/*!
+ * @file ControllerStream.h
+ * @brief Declares the parser of the controller's event stream
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | events parsed by the controller protocol
+ *
+*/
+
+#ifndef CONTROLLERSTREAM_H
+#define CONTROLLERSTREAM_H
+
+#include <QString>
+#include <QElapsedTimer>
+#include "SerialBuffer.h"
+#include "ExposureAccumulator.h"
+#include "LedChannels.h"
+#include "ControllerProtocol.h"
+
+#define STREAM_EXPOSURE_FRAMES  64      // exposure frames kept in the ring
+#define STREAM_VOLTAGE_SAMPLES  256     // I/V samples kept in the ring
+#define STREAM_SCOPE_MS         2000    // scope counts as present this long after a frame
+#define STREAM_SILENCE_MS       5000    // no events this long triggers an echo check
+
+
+/*!
+ * One exposure frame from the stream
+ */
+class CExposureSample
+{
+public:
+    qint64  m_time;                     // ms on the stream clock
+    int     m_zones[EXPOSURE_ZONES];
+};
+
+/*!
+ * One current and voltage sample from the stream
+ */
+class CVoltageSample
+{
+public:
+    qint64  m_time;                     // ms on the stream clock
+    int     m_channels;                 // channels the event had readings for
+    double  m_V[LED_CHANNELS_MAX];
+    double  m_I[LED_CHANNELS_MAX];
+};
+
+
+/*!
+ * Parses the events the controller sends when events are enabled and
+ * keeps the most recent samples in fixed-size rings.
+ *
+ * The stream is fed by CSerialBuffer, which passes every line it reads to
+ * filterLine() first; event lines are consumed here and never reach the
+ * command/response code.  Samples are numbered, so a reader can ask for
+ * everything newer than the last sample it has seen.  Everything runs in
+ * the thread of the engine that owns the stream.
+ */
+class CControllerStream : public CSerialEventFilter
+{
+public:
+    CControllerStream();
+
+    void    clear();
+    void    setProtocol(const CControllerProtocol *protocol) { m_protocol = protocol; }
+    bool    filterLine(const QString &line);
+
+    qint64  now() const { return(m_clock.elapsed()); }
+
+    qint64  exposureCount() const { return(m_exposureCount); }
+    qint64  voltageCount() const  { return(m_voltageCount); }
+    const CExposureSample &exposure(qint64 n) const { return(m_exposure[n % STREAM_EXPOSURE_FRAMES]); }
+    const CVoltageSample  &voltage(qint64 n) const  { return(m_voltage[n % STREAM_VOLTAGE_SAMPLES]); }
+    qint64  lastEventTime() const { return(m_lastEventTime); }
+
+private:
+    bool    parseVoltage(const QString &line);
+    bool    parseExposureRow(const QString &line);
+
+private:
+    const CControllerProtocol *m_protocol;  // parses the event lines
+    QElapsedTimer   m_clock;
+    CExposureSample m_exposure[STREAM_EXPOSURE_FRAMES];
+    CVoltageSample  m_voltage[STREAM_VOLTAGE_SAMPLES];
+    qint64          m_exposureCount;    // frames received, the newest is m_exposureCount-1
+    qint64          m_voltageCount;     // I/V samples received
+    qint64          m_lastEventTime;    // time of the last event, -1 if none
+    int             m_rows;             // rows of the exposure frame being received
+    int             m_frame[EXPOSURE_ZONES];
+};
+
+#endif // CONTROLLERSTREAM_H
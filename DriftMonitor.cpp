@@ -0,0 +1,181 @@
+/*!
+ * @file DriftMonitor.cpp
+ * @brief Implements the drift and outlier monitor of a calibration fixture
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QtMath>
+#include "DriftMonitor.h"
+#include "CalibrationEngine.h"
+
+//
+// Monitor parameters
+//
+const int    c_warmupCount   = 30;      // samples that establish the baseline
+const double c_baselineAlpha = 0.02;    // weight of a new sample in the baseline
+const double c_recentLambda  = 0.2;     // weight of a new sample in the recent EWMA
+const double c_outlierSigma  = 4.0;     // distance of an outlier from the baseline
+const double c_driftSigma    = 3.0;     // control limit of the recent EWMA
+
+//
+// Name and smallest standard deviation of each quantity.  The floor keeps
+// quantities that barely vary from alerting on the smallest change.
+//
+static const char *c_driftName[DRIFT_QUANTITIES] =
+{
+    "LED 1 low threshold", "LED 1 high threshold", "LED 2 low threshold", "LED 2 high threshold",
+    "LED 1 current", "LED 2 current", "LED 1 voltage", "LED 2 voltage", "run duration"
+};
+static const double c_driftMinSigma[DRIFT_QUANTITIES] =
+{
+    2.0, 2.0, 2.0, 2.0,         // DAC codes
+    0.01, 0.01,                 // A
+    0.01, 0.01,                 // V
+    1000.0                      // ms
+};
+
+
+CDriftStatistic::CDriftStatistic()
+{
+    m_minSigma = 0.0;
+    clear();
+}
+
+
+void CDriftStatistic::clear()
+{
+    m_count = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_variance = 0.0;
+    m_recent = 0.0;
+    m_drifting = false;
+}
+
+
+double CDriftStatistic::sigma() const
+{
+    return(qMax(qSqrt(m_variance), m_minSigma));
+}
+
+
+/*!
+ * @brief adds a sample
+ *
+ * Outliers are reported but left out of the statistics, so a single bad
+ * unit neither moves the baseline nor triggers a drift.  A drift is
+ * reported once when it starts.
+ *
+ * @param[in] x - the sample
+ * @return what the sample revealed
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CDriftStatistic::Event CDriftStatistic::add(double x)
+{
+    if (m_count < c_warmupCount)
+    {
+        m_count++;
+        double delta = x - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (x - m_mean);
+        m_variance = (m_count > 1) ? m_m2 / (m_count - 1) : 0.0;
+        m_recent = m_mean;
+        return(Event_None);
+    }
+
+    double sd = sigma();
+    if (qAbs(x - m_mean) > c_outlierSigma * sd)
+    {
+        return(Event_Outlier);
+    }
+    m_count++;
+
+    m_recent = c_recentLambda * x + (1.0 - c_recentLambda) * m_recent;
+    double limit = c_driftSigma * sd * qSqrt(c_recentLambda / (2.0 - c_recentLambda));
+    bool drifting = qAbs(m_recent - m_mean) > limit;
+
+    double delta = x - m_mean;
+    m_mean += c_baselineAlpha * delta;
+    m_variance = (1.0 - c_baselineAlpha) * (m_variance + c_baselineAlpha * delta * delta);
+
+    Event event = (drifting && !m_drifting) ? Event_Drift : Event_None;
+    m_drifting = drifting;
+    return(event);
+}
+
+
+CDriftMonitor::CDriftMonitor()
+{
+    for (int i=0; i<DRIFT_QUANTITIES; i++)
+    {
+        m_stats[i].setMinSigma(c_driftMinSigma[i]);
+    }
+}
+
+
+void CDriftMonitor::clear()
+{
+    for (int i=0; i<DRIFT_QUANTITIES; i++)
+    {
+        m_stats[i].clear();
+    }
+}
+
+
+/*!
+ * @brief adds the result of a calibration run
+ *
+ * Only passed calibrations are used; a failed run has no thresholds and
+ * is reported by the engine already.
+ *
+ * @param[in] result - outcome of the run
+ * @return alert messages, empty if nothing unusual was seen
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QStringList CDriftMonitor::update(const CCalibrationResult &result)
+{
+    QStringList alerts;
+    if (!result.m_success)
+    {
+        return(alerts);
+    }
+
+    double values[DRIFT_QUANTITIES] =
+    {
+        (double)result.m_low[0], (double)result.m_high[0], (double)result.m_low[1], (double)result.m_high[1],
+        result.m_I[0], result.m_I[1], result.m_V[0], result.m_V[1], (double)result.m_durationMs
+    };
+
+    for (int i=0; i<DRIFT_QUANTITIES; i++)
+    {
+        CDriftStatistic &stat = m_stats[i];
+        switch (stat.add(values[i]))
+        {
+        case CDriftStatistic::Event_Outlier:
+            alerts.append(QString("%1 %2 is an outlier (usual %3 +/- %4)")
+                          .arg(c_driftName[i]).arg(values[i]).arg(stat.mean()).arg(stat.sigma()));
+            break;
+        case CDriftStatistic::Event_Drift:
+            alerts.append(QString("%1 is drifting (recent %2, usual %3 +/- %4)")
+                          .arg(c_driftName[i]).arg(stat.recent()).arg(stat.mean()).arg(stat.sigma()));
+            break;
+        default:
+            break;
+        }
+    }
+    return(alerts);
+}
@@ -0,0 +1,103 @@
+/*!
+ * @file DriftMonitor.h
+ * @brief Declares the drift and outlier monitor of a calibration fixture
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef DRIFTMONITOR_H
+#define DRIFTMONITOR_H
+
+#include <QString>
+#include <QStringList>
+
+class CCalibrationResult;
+
+
+/*!
+ * Quantities watched by the drift monitor
+ */
+enum DriftQuantity
+{
+    Drift_Low1,
+    Drift_High1,
+    Drift_Low2,
+    Drift_High2,
+    Drift_I1,
+    Drift_I2,
+    Drift_V1,
+    Drift_V2,
+    Drift_Duration,
+    DRIFT_QUANTITIES
+};
+
+
+/*!
+ * Running statistics of one quantity.
+ *
+ * The first samples establish a baseline mean and variance (Welford).
+ * After that the baseline follows slow changes through an exponentially
+ * weighted mean and variance, and a faster EWMA of the recent samples is
+ * compared against it as in an EWMA control chart.  Each update takes
+ * constant time and the memory use does not grow with the number of units.
+ */
+class CDriftStatistic
+{
+public:
+    enum Event
+    {
+        Event_None,
+        Event_Outlier,      // the sample is far from the baseline
+        Event_Drift         // the recent samples have moved away from the baseline
+    };
+
+public:
+    CDriftStatistic();
+
+    void   setMinSigma(double minSigma) { m_minSigma = minSigma; }
+    void   clear();
+    Event  add(double x);
+
+    int    count() const    { return(m_count); }
+    double mean() const     { return(m_mean); }
+    double sigma() const;
+    double recent() const   { return(m_recent); }
+
+private:
+    int    m_count;         // samples seen
+    double m_mean;          // baseline mean
+    double m_m2;            // sum of squared deviations during warm-up
+    double m_variance;      // baseline variance
+    double m_recent;        // EWMA of the recent samples
+    double m_minSigma;      // smallest standard deviation used for the limits
+    bool   m_drifting;      // a drift has been reported and not yet recovered
+};
+
+
+/*!
+ * Watches the results of one fixture for outliers and drift, e.g. a dirty
+ * sensor or an aging fixture LED, before they cause a run of reworks.
+ */
+class CDriftMonitor
+{
+public:
+    CDriftMonitor();
+
+    void        clear();
+    QStringList update(const CCalibrationResult &result);
+    const CDriftStatistic &statistic(int quantity) const { return(m_stats[quantity]); }
+
+private:
+    CDriftStatistic m_stats[DRIFT_QUANTITIES];
+};
+
+#endif // DRIFTMONITOR_H
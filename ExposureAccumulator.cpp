@@ -0,0 +1,262 @@
+/*!
+ * @file ExposureAccumulator.cpp
+ * @brief Implements multi-frame accumulation of the 5x5 exposure zones
+ *
+ * The update and statistics loops run over fixed-length, padded, contiguous
+ * arrays with no data dependent branches so the compiler can vectorize them.
+ * Sums are kept as 64 bit integers so removing an old frame from the running
+ * sums is exact and does not drift on long soak runs.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <algorithm>
+#include "ExposureAccumulator.h"
+
+
+/*!
+ * @brief constructor
+ *
+ * @param[in] depth - number of frames to accumulate
+ * @return none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CExposureAccumulator::CExposureAccumulator(int depth)
+{
+    m_depth = 0;
+    setDepth(depth);
+}
+
+CExposureAccumulator::~CExposureAccumulator()
+{
+}
+
+
+/*!
+ * @brief sets the number of frames kept and discards all accumulated data
+ *
+ * @param[in] depth - number of frames, clamped to 1..EXPOSURE_MAX_FRAMES
+ * @return none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureAccumulator::setDepth(int depth)
+{
+    if (depth < 1)
+    {
+        depth = 1;
+    }
+    if (depth > EXPOSURE_MAX_FRAMES)
+    {
+        depth = EXPOSURE_MAX_FRAMES;
+    }
+
+    m_depth = depth;
+    m_samples.assign(m_depth * EXPOSURE_ZONE_STRIDE, 0);
+    m_totals.assign(m_depth, 0);
+    clear();
+}
+
+
+/*!
+ * @brief discards all accumulated frames
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureAccumulator::clear()
+{
+    m_count = 0;
+    m_next = 0;
+    m_totalSum = 0;
+    m_totalSumSq = 0;
+    for (int z=0; z<EXPOSURE_ZONE_STRIDE; z++)
+    {
+        m_sum[z] = 0;
+        m_sumSq[z] = 0;
+    }
+    std::fill(m_samples.begin(), m_samples.end(), 0);
+    std::fill(m_totals.begin(), m_totals.end(), 0);
+}
+
+
+/*!
+ * @brief adds a frame, replacing the oldest one once the ring is full
+ *
+ * @param[in] zones - EXPOSURE_ZONES values in row order (11, 12, ... 55)
+ * @return none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureAccumulator::addFrame(const int *zones)
+{
+    //
+    // Pad the incoming frame so the kernel below works on whole vectors.
+    // Unused slots of the ring are zero, so evicting them is a no-op.
+    //
+    int frame[EXPOSURE_ZONE_STRIDE];
+    for (int z=0; z<EXPOSURE_ZONE_STRIDE; z++)
+    {
+        frame[z] = (z < EXPOSURE_ZONES) ? zones[z] : 0;
+    }
+
+    int * __restrict slot = &m_samples[m_next * EXPOSURE_ZONE_STRIDE];
+    long long * __restrict sum = m_sum;
+    long long * __restrict sumSq = m_sumSq;
+    int total = 0;
+    for (int z=0; z<EXPOSURE_ZONE_STRIDE; z++)
+    {
+        long long oldValue = slot[z];
+        long long newValue = frame[z];
+        sum[z]   += newValue - oldValue;
+        sumSq[z] += newValue*newValue - oldValue*oldValue;
+        slot[z]   = frame[z];
+        total    += frame[z];
+    }
+
+    long long oldTotal = m_totals[m_next];
+    m_totalSum   += total - oldTotal;
+    m_totalSumSq += (long long)total*total - oldTotal*oldTotal;
+    m_totals[m_next] = total;
+
+    m_next = (m_next + 1) % m_depth;
+    if (m_count < m_depth)
+    {
+        m_count++;
+    }
+}
+
+
+/*!
+ * @brief returns the mean of one zone over the accumulated frames
+ *
+ * @param[in] zone - index 0..EXPOSURE_ZONES-1
+ * @return mean value, 0 if no frames have been accumulated
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+double CExposureAccumulator::mean(int zone) const
+{
+    if ((m_count == 0) || (zone < 0) || (zone >= EXPOSURE_ZONES))
+    {
+        return(0.0);
+    }
+    return((double)m_sum[zone] / m_count);
+}
+
+
+/*!
+ * @brief returns the (population) variance of one zone
+ *
+ * @param[in] zone - index 0..EXPOSURE_ZONES-1
+ * @return variance, 0 if fewer than two frames have been accumulated
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+double CExposureAccumulator::variance(int zone) const
+{
+    if ((m_count < 2) || (zone < 0) || (zone >= EXPOSURE_ZONES))
+    {
+        return(0.0);
+    }
+    double m = (double)m_sum[zone] / m_count;
+    double v = (double)m_sumSq[zone] / m_count - m*m;
+    return((v > 0.0) ? v : 0.0);
+}
+
+
+/*!
+ * @brief returns the means of all zones
+ *
+ * @param[out] out - EXPOSURE_ZONES values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureAccumulator::means(double *out) const
+{
+    double scale = (m_count > 0) ? (1.0 / m_count) : 0.0;
+    double m[EXPOSURE_ZONE_STRIDE];
+    for (int z=0; z<EXPOSURE_ZONE_STRIDE; z++)
+    {
+        m[z] = (double)m_sum[z] * scale;
+    }
+    for (int z=0; z<EXPOSURE_ZONES; z++)
+    {
+        out[z] = m[z];
+    }
+}
+
+
+/*!
+ * @brief returns the variances of all zones
+ *
+ * @param[out] out - EXPOSURE_ZONES values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureAccumulator::variances(double *out) const
+{
+    double scale = (m_count > 1) ? (1.0 / m_count) : 0.0;
+    double v[EXPOSURE_ZONE_STRIDE];
+    for (int z=0; z<EXPOSURE_ZONE_STRIDE; z++)
+    {
+        double m = (double)m_sum[z] * scale;
+        double d = (double)m_sumSq[z] * scale - m*m;
+        v[z] = (d > 0.0) ? d : 0.0;
+    }
+    for (int z=0; z<EXPOSURE_ZONES; z++)
+    {
+        out[z] = v[z];
+    }
+}
+
+
+/*!
+ * @brief returns the mean of the per-frame total exposure
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+double CExposureAccumulator::totalMean() const
+{
+    if (m_count == 0)
+    {
+        return(0.0);
+    }
+    return((double)m_totalSum / m_count);
+}
+
+
+/*!
+ * @brief returns the variance of the per-frame total exposure
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+double CExposureAccumulator::totalVariance() const
+{
+    if (m_count < 2)
+    {
+        return(0.0);
+    }
+    double m = (double)m_totalSum / m_count;
+    double v = (double)m_totalSumSq / m_count - m*m;
+    return((v > 0.0) ? v : 0.0);
+}
@@ -0,0 +1,69 @@
+/*!
+ * @file ExposureAccumulator.h
+ * @brief Declares the CExposureAccumulator class
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef EXPOSUREACCUMULATOR_H
+#define EXPOSUREACCUMULATOR_H
+
+#include <vector>
+
+#define EXPOSURE_ZONES        25      // 5x5 zones reported by "em=-1"
+#define EXPOSURE_ZONE_STRIDE  32      // zones padded so the kernels run on whole vectors
+#define EXPOSURE_MAX_FRAMES   256     // upper bound on the accumulation depth
+
+/*!
+ * Keeps the most recent N exposure frames and maintains running per-zone
+ * sums so that the mean and variance of every zone (and of the total) can
+ * be read in constant time.
+ *
+ * Storage is a fixed ring of frames laid out as separate contiguous arrays
+ * (samples, sums, sums of squares, totals), each zone row padded to
+ * EXPOSURE_ZONE_STRIDE.  Memory is allocated once by setDepth() and never
+ * grows, no matter how many frames are added.
+ */
+class CExposureAccumulator
+{
+public:
+    CExposureAccumulator(int depth = 1);
+    ~CExposureAccumulator();
+
+public:
+    void   setDepth(int depth);
+    int    depth() const { return(m_depth); }
+    int    count() const { return(m_count); }
+    void   clear();
+    void   addFrame(const int *zones);
+
+    double mean(int zone) const;
+    double variance(int zone) const;
+    void   means(double *out) const;
+    void   variances(double *out) const;
+    double totalMean() const;
+    double totalVariance() const;
+
+private:
+    int                 m_depth;     // number of frames kept
+    int                 m_count;     // number of valid frames (<= m_depth)
+    int                 m_next;      // ring slot that receives the next frame
+
+    std::vector<int>       m_samples;   // m_depth rows of EXPOSURE_ZONE_STRIDE values
+    std::vector<int>       m_totals;    // per-frame total exposure
+    long long              m_sum[EXPOSURE_ZONE_STRIDE];
+    long long              m_sumSq[EXPOSURE_ZONE_STRIDE];
+    long long              m_totalSum;
+    long long              m_totalSumSq;
+};
+
+#endif // EXPOSUREACCUMULATOR_H
@@ -0,0 +1,230 @@
+/*!
+ * @file ExposureHeatmap.cpp
+ * @brief Implements the heatmap display of the 5x5 exposure zones
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version, replaces 25 line edits
+ *
+*/
+
+#include <QPainter>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QtMath>
+#include "ExposureHeatmap.h"
+
+//
+// Interval between repaints, about one display frame
+//
+const int c_repaintMS = 16;
+
+//
+// Rows and columns of the zone grid
+//
+const int c_gridSize = 5;
+
+//
+// Size of a cell in the size hints
+//
+const int c_cellWidth = 36;
+const int c_cellHeight = 22;
+
+
+/*!
+ * @brief constructor
+ *
+ * @param[in] parent - parent widget
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CExposureHeatmap::CExposureHeatmap(QWidget *parent) :
+    QWidget(parent)
+{
+    m_valid = false;
+    m_frames = 0;
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        m_means[i] = 0.0;
+        m_variances[i] = 0.0;
+    }
+
+    m_repaintTimer.setSingleShot(true);
+    m_repaintTimer.setInterval(c_repaintMS);
+    connect(&m_repaintTimer, SIGNAL(timeout()), this, SLOT(update()));
+
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+}
+
+
+/*!
+ * @brief shows a new exposure reading
+ *
+ * @param[in] means - EXPOSURE_ZONES mean values in row order
+ * @param[in] variances - EXPOSURE_ZONES variances in row order
+ * @param[in] frames - number of frames averaged
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureHeatmap::setValues(const QVector<double> &means, const QVector<double> &variances, int frames)
+{
+    if ((means.size() < EXPOSURE_ZONES) || (variances.size() < EXPOSURE_ZONES))
+    {
+        clear();
+        return;
+    }
+
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        m_means[i] = means[i];
+        m_variances[i] = variances[i];
+    }
+    m_frames = frames;
+    m_valid = true;
+    scheduleRepaint();
+}
+
+
+void CExposureHeatmap::clear()
+{
+    if (!m_valid)
+    {
+        return;
+    }
+    m_valid = false;
+    m_frames = 0;
+    scheduleRepaint();
+}
+
+
+QSize CExposureHeatmap::sizeHint() const
+{
+    return(QSize(c_gridSize*c_cellWidth, c_gridSize*c_cellHeight));
+}
+
+
+QSize CExposureHeatmap::minimumSizeHint() const
+{
+    return(sizeHint());
+}
+
+
+void CExposureHeatmap::scheduleRepaint()
+{
+    if (!m_repaintTimer.isActive())
+    {
+        m_repaintTimer.start();
+    }
+}
+
+
+QRectF CExposureHeatmap::zoneRect(int zone) const
+{
+    double w = width() / (double)c_gridSize;
+    double h = height() / (double)c_gridSize;
+    return(QRectF((zone % c_gridSize) * w, (zone / c_gridSize) * h, w, h));
+}
+
+
+int CExposureHeatmap::zoneAt(const QPoint &pos) const
+{
+    int column = pos.x() * c_gridSize / qMax(width(), 1);
+    int row = pos.y() * c_gridSize / qMax(height(), 1);
+    if ((column < 0) || (column >= c_gridSize) || (row < 0) || (row >= c_gridSize))
+    {
+        return(-1);
+    }
+    return(row*c_gridSize + column);
+}
+
+
+/*!
+ * @brief shows the statistics of the zone under the mouse as the tooltip
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CExposureHeatmap::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip)
+    {
+        QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
+        int zone = zoneAt(helpEvent->pos());
+        if (m_valid && (m_frames > 1) && (zone >= 0))
+        {
+            QToolTip::showText(helpEvent->globalPos(),
+                               QString("mean %1, sd %2 (%3 frames)")
+                               .arg(m_means[zone], 0, 'f', 2)
+                               .arg(qSqrt(m_variances[zone]), 0, 'f', 2)
+                               .arg(m_frames));
+        }
+        else
+        {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return(true);
+    }
+    return(QWidget::event(event));
+}
+
+
+/*!
+ * @brief draws the whole grid
+ *
+ * The colour runs from blue for the dimmest to red for the brightest zone
+ * of the reading; zones with no exposure are left in the background colour.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CExposureHeatmap::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    double minimum = 0.0;
+    double maximum = 0.0;
+    if (m_valid)
+    {
+        minimum = maximum = m_means[0];
+        for (int i=1; i<EXPOSURE_ZONES; i++)
+        {
+            minimum = qMin(minimum, m_means[i]);
+            maximum = qMax(maximum, m_means[i]);
+        }
+    }
+    double range = maximum - minimum;
+
+    painter.setPen(palette().color(QPalette::Mid));
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        QRectF cell = zoneRect(i);
+        int value = qRound(m_means[i]);
+        if (m_valid && (value != 0))
+        {
+            double level = (range > 0.0) ? (m_means[i] - minimum) / range : 1.0;
+            painter.fillRect(cell, QColor::fromHsvF(0.66 * (1.0 - level), 0.6, 1.0));
+        }
+        painter.drawRect(cell.adjusted(0, 0, -1, -1));
+    }
+
+    if (!m_valid)
+    {
+        return;
+    }
+
+    painter.setPen(palette().color(QPalette::Text));
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        painter.drawText(zoneRect(i), Qt::AlignCenter, QString::number(qRound(m_means[i])));
+    }
+}
@@ -0,0 +1,67 @@
+/*!
+ * @file ExposureHeatmap.h
+ * @brief Declares the heatmap display of the 5x5 exposure zones
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version, replaces 25 line edits
+ *
+*/
+
+#ifndef EXPOSUREHEATMAP_H
+#define EXPOSUREHEATMAP_H
+
+#include <QWidget>
+#include <QVector>
+#include <QTimer>
+#include "ExposureAccumulator.h"
+
+
+/*!
+ * Shows the exposure zones as a 5x5 grid of coloured cells with the value
+ * of each zone, drawn in a single paint pass.
+ *
+ * New values only mark the widget dirty; the repaint is deferred to the
+ * next display frame, so a burst of exposure readings costs one repaint.
+ * The tooltip of a cell shows the mean and standard deviation of the zone
+ * when more than one frame was averaged.
+ *
+ * Used as a promoted widget in mainwindow.ui.
+ */
+class CExposureHeatmap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CExposureHeatmap(QWidget *parent = 0);
+
+    void    setValues(const QVector<double> &means, const QVector<double> &variances, int frames);
+    void    clear();
+
+    QSize   sizeHint() const;
+    QSize   minimumSizeHint() const;
+
+protected:
+    bool    event(QEvent *event);
+    void    paintEvent(QPaintEvent *event);
+
+private:
+    void    scheduleRepaint();
+    int     zoneAt(const QPoint &pos) const;
+    QRectF  zoneRect(int zone) const;
+
+private:
+    bool    m_valid;                        // false to show an empty grid
+    double  m_means[EXPOSURE_ZONES];
+    double  m_variances[EXPOSURE_ZONES];
+    int     m_frames;                       // frames averaged into the values
+    QTimer  m_repaintTimer;                 // pending repaint, single shot
+};
+
+#endif // EXPOSUREHEATMAP_H
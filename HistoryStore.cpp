@@ -0,0 +1,413 @@
+/*!
+ * @file HistoryStore.cpp
+ * @brief Implements the local database of calibration results
+ *
+ * The database is a single SQLite file.  The indexes make lookups by
+ * serial number, by time range and of the most recent results for a
+ * firmware/fixture pair independent of the size of the table, so the
+ * store stays fast with hundreds of thousands of records.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | all LED channels kept in the "leds" column
+ *
+*/
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QVector>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <algorithm>
+#include "HistoryStore.h"
+#include "CalibrationEngine.h"
+
+//
+// Search priors
+//
+const int c_priorRecords    = 500;  // most recent passed calibrations used
+const int c_priorMinSamples = 20;   // fewer than this and no prior is given
+const int c_priorMinMargin  = 16;   // DAC codes added on each side of the window
+
+
+CSearchPrior::CSearchPrior()
+{
+    m_samples = 0;
+    for (int i=0; i<JOURNAL_PHASES; i++)
+    {
+        m_low[i] = -1;
+        m_high[i] = -1;
+    }
+}
+
+
+CHistoryStore::CHistoryStore()
+{
+    m_connectionName = QString("history_%1").arg((quintptr)this);
+    m_open = false;
+}
+
+CHistoryStore::~CHistoryStore()
+{
+    close();
+}
+
+
+/*!
+ * @brief opens the database, creating the table and indexes if needed
+ *
+ * @param[in] fileName - SQLite database file
+ * @return true if the database is ready
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CHistoryStore::open(QString fileName)
+{
+    close();
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    db.setDatabaseName(fileName);
+    db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    if (!db.open())
+    {
+        QSqlDatabase::removeDatabase(m_connectionName);
+        return(false);
+    }
+
+    QSqlQuery query(db);
+    query.exec("PRAGMA journal_mode=WAL");
+    query.exec("CREATE TABLE IF NOT EXISTS calibration ("
+               " id INTEGER PRIMARY KEY,"
+               " time INTEGER NOT NULL,"
+               " serial TEXT NOT NULL,"
+               " firmware TEXT NOT NULL,"
+               " fixture TEXT NOT NULL,"
+               " operator TEXT,"
+               " success INTEGER NOT NULL,"
+               " low1 INTEGER, high1 INTEGER, low2 INTEGER, high2 INTEGER,"
+               " oldLow1 INTEGER, oldHigh1 INTEGER, oldLow2 INTEGER, oldHigh2 INTEGER,"
+               " I1 REAL, I2 REAL, V1 REAL, V2 REAL,"
+               " exposure INTEGER,"
+               " durationMs INTEGER,"
+               " error TEXT,"
+               " leds TEXT)");
+    //
+    // The fixed columns hold LED 1 and 2; "leds" holds every channel.
+    // Databases created before it existed get it added.
+    //
+    query.exec("ALTER TABLE calibration ADD COLUMN leds TEXT");
+    query.exec("CREATE INDEX IF NOT EXISTS calibration_serial ON calibration(serial, time)");
+    query.exec("CREATE INDEX IF NOT EXISTS calibration_time ON calibration(time)");
+    query.exec("CREATE INDEX IF NOT EXISTS calibration_model ON calibration(firmware, fixture, success, time)");
+
+    m_open = true;
+    return(true);
+}
+
+
+void CHistoryStore::close()
+{
+    if (!m_open)
+    {
+        return;
+    }
+    m_open = false;
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+
+static QString firmwareOf(const CCalibrationResult &result)
+{
+    return(QString("%1/%2/%3").arg(result.m_versionARM).arg(result.m_versionDSP).arg(result.m_versionFPGA));
+}
+
+
+/*!
+ * @brief returns the values of all LED channels as the text of the "leds" column
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static QString ledsOf(const CCalibrationResult &result)
+{
+    QJsonArray leds;
+    for (int c=0; c<result.m_channels; c++)
+    {
+        QJsonObject led;
+        led["low"] = result.m_low[c];
+        led["high"] = result.m_high[c];
+        led["oldLow"] = result.m_oldLow[c];
+        led["oldHigh"] = result.m_oldHigh[c];
+        led["I"] = result.m_I[c];
+        led["V"] = result.m_V[c];
+        leds.append(led);
+    }
+    return(QString::fromUtf8(QJsonDocument(leds).toJson(QJsonDocument::Compact)));
+}
+
+
+/*!
+ * @brief adds the result of a calibration run
+ *
+ * @param[in] result - outcome of the run
+ * @param[in] fixture - name of the fixture the run was made on
+ * @return true if the record was stored
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CHistoryStore::record(const CCalibrationResult &result, QString fixture)
+{
+    if (!m_open)
+    {
+        return(false);
+    }
+
+    QSqlQuery query(QSqlDatabase::database(m_connectionName));
+    query.prepare("INSERT INTO calibration (time, serial, firmware, fixture, operator, success,"
+                  " low1, high1, low2, high2, oldLow1, oldHigh1, oldLow2, oldHigh2,"
+                  " I1, I2, V1, V2, exposure, durationMs, error, leds)"
+                  " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    query.addBindValue(result.m_startTime.toMSecsSinceEpoch());
+    query.addBindValue(result.m_serialNumber);
+    query.addBindValue(firmwareOf(result));
+    query.addBindValue(fixture);
+    query.addBindValue(result.m_operator);
+    query.addBindValue(result.m_success ? 1 : 0);
+    query.addBindValue(result.m_low[0]);
+    query.addBindValue(result.m_high[0]);
+    query.addBindValue(result.m_low[1]);
+    query.addBindValue(result.m_high[1]);
+    query.addBindValue(result.m_oldLow[0]);
+    query.addBindValue(result.m_oldHigh[0]);
+    query.addBindValue(result.m_oldLow[1]);
+    query.addBindValue(result.m_oldHigh[1]);
+    query.addBindValue(result.m_I[0]);
+    query.addBindValue(result.m_I[1]);
+    query.addBindValue(result.m_V[0]);
+    query.addBindValue(result.m_V[1]);
+    query.addBindValue(result.m_totalExposure);
+    query.addBindValue(result.m_durationMs);
+    query.addBindValue(result.m_error);
+    query.addBindValue(ledsOf(result));
+    return(query.exec());
+}
+
+
+/*!
+ * @brief converts the rows of a query to results
+ *
+ * The query must select the columns in the order used below.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static QList<CCalibrationResult> resultsOf(QSqlQuery &query)
+{
+    QList<CCalibrationResult> results;
+    while (query.next())
+    {
+        CCalibrationResult r;
+        r.m_startTime = QDateTime::fromMSecsSinceEpoch(query.value(0).toLongLong());
+        r.m_serialNumber = query.value(1).toString();
+        QStringList firmware = query.value(2).toString().split('/');
+        r.m_versionARM = firmware.value(0);
+        r.m_versionDSP = firmware.value(1);
+        r.m_versionFPGA = firmware.value(2);
+        r.m_station = query.value(3).toString();
+        r.m_operator = query.value(4).toString();
+        r.m_success = query.value(5).toInt() != 0;
+        r.m_channels = 2;
+        for (int c=0; c<2; c++)
+        {
+            r.m_low[c] = query.value(6+2*c).toInt();
+            r.m_high[c] = query.value(7+2*c).toInt();
+            r.m_oldLow[c] = query.value(10+2*c).toInt();
+            r.m_oldHigh[c] = query.value(11+2*c).toInt();
+            r.m_I[c] = query.value(14+c).toDouble();
+            r.m_V[c] = query.value(16+c).toDouble();
+        }
+        r.m_totalExposure = query.value(18).toInt();
+        r.m_durationMs = query.value(19).toLongLong();
+        r.m_error = query.value(20).toString();
+
+        //
+        // Records written before the "leds" column have LED 1 and 2 only
+        //
+        QJsonArray leds = QJsonDocument::fromJson(query.value(21).toString().toUtf8()).array();
+        if (!leds.isEmpty())
+        {
+            r.m_channels = qMin(leds.size(), LED_CHANNELS_MAX);
+            for (int c=0; c<r.m_channels; c++)
+            {
+                QJsonObject led = leds[c].toObject();
+                r.m_low[c] = led["low"].toInt(-1);
+                r.m_high[c] = led["high"].toInt(-1);
+                r.m_oldLow[c] = led["oldLow"].toInt(-1);
+                r.m_oldHigh[c] = led["oldHigh"].toInt(-1);
+                r.m_I[c] = led["I"].toDouble();
+                r.m_V[c] = led["V"].toDouble();
+            }
+        }
+        results.append(r);
+    }
+    return(results);
+}
+
+#define RESULT_COLUMNS "time, serial, firmware, fixture, operator, success," \
+                       " low1, high1, low2, high2, oldLow1, oldHigh1, oldLow2, oldHigh2," \
+                       " I1, I2, V1, V2, exposure, durationMs, error, leds"
+
+
+/*!
+ * @brief returns the calibrations of a unit, most recent first
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QList<CCalibrationResult> CHistoryStore::findBySerialNumber(QString serialNumber, int limit)
+{
+    if (!m_open)
+    {
+        return(QList<CCalibrationResult>());
+    }
+
+    QSqlQuery query(QSqlDatabase::database(m_connectionName));
+    query.setForwardOnly(true);
+    query.prepare("SELECT " RESULT_COLUMNS " FROM calibration"
+                  " WHERE serial = ? ORDER BY time DESC LIMIT ?");
+    query.addBindValue(serialNumber);
+    query.addBindValue(limit);
+    query.exec();
+    return(resultsOf(query));
+}
+
+
+/*!
+ * @brief returns the calibrations made in a time range, oldest first
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QList<CCalibrationResult> CHistoryStore::findByTime(QDateTime from, QDateTime to, int limit)
+{
+    if (!m_open)
+    {
+        return(QList<CCalibrationResult>());
+    }
+
+    QSqlQuery query(QSqlDatabase::database(m_connectionName));
+    query.setForwardOnly(true);
+    query.prepare("SELECT " RESULT_COLUMNS " FROM calibration"
+                  " WHERE time >= ? AND time < ? ORDER BY time LIMIT ?");
+    query.addBindValue(from.toMSecsSinceEpoch());
+    query.addBindValue(to.toMSecsSinceEpoch());
+    query.addBindValue(limit);
+    query.exec();
+    return(resultsOf(query));
+}
+
+
+/*!
+ * @brief returns the value at a fraction of a sorted list
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static int percentile(const QVector<int> &sorted, double fraction)
+{
+    int index = (int)(fraction * (sorted.size() - 1) + 0.5);
+    return(sorted[index]);
+}
+
+
+/*!
+ * @brief computes the search windows for a firmware/fixture pair
+ *
+ * The window of each phase covers the 2.5th to 97.5th percentile of the
+ * most recent passed calibrations, widened by a quarter of its width (at
+ * least c_priorMinMargin codes) on each side.  The caller must still
+ * verify that the threshold lies inside the window.  Windows are derived
+ * for LED 1 and 2, the channels with columns of their own; the phases of
+ * any further channel get none.
+ *
+ * @param[in] firmware - "ARM/DSP/FPGA" versions
+ * @param[in] fixture - fixture name
+ * @param[in] channels - LED channels of the unit, which sets the numbering of the phases
+ * @param[out] prior - the search windows
+ * @return false if there is not enough history
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CHistoryStore::searchPriors(QString firmware, QString fixture, int channels, CSearchPrior *prior)
+{
+    *prior = CSearchPrior();
+    if (!m_open)
+    {
+        return(false);
+    }
+
+    QSqlQuery query(QSqlDatabase::database(m_connectionName));
+    query.setForwardOnly(true);
+    query.prepare("SELECT low1, low2, high1, high2 FROM calibration"
+                  " WHERE firmware = ? AND fixture = ? AND success = 1"
+                  " ORDER BY time DESC LIMIT ?");
+    query.addBindValue(firmware);
+    query.addBindValue(fixture);
+    query.addBindValue(c_priorRecords);
+    if (!query.exec())
+    {
+        return(false);
+    }
+
+    //
+    // Phases of the columns selected above
+    //
+    int columns = qMin(channels, 2);
+    int phaseOf[4] = { 0, 1, channels, channels+1 };
+
+    QVector<int> values[4];
+    while (query.next())
+    {
+        for (int i=0; i<4; i++)
+        {
+            values[i].append(query.value(i).toInt());
+        }
+    }
+
+    if (values[0].size() < c_priorMinSamples)
+    {
+        return(false);
+    }
+
+    prior->m_samples = values[0].size();
+    for (int i=0; i<4; i++)
+    {
+        if ((i % 2) >= columns)
+        {
+            continue;
+        }
+        std::sort(values[i].begin(), values[i].end());
+        int low = percentile(values[i], 0.025);
+        int high = percentile(values[i], 0.975);
+        int margin = qMax(c_priorMinMargin, (high - low) / 4);
+        prior->m_low[phaseOf[i]] = low - margin;
+        prior->m_high[phaseOf[i]] = high + margin;
+    }
+    return(true);
+}
@@ -0,0 +1,73 @@
+/*!
+ * @file HistoryStore.h
+ * @brief Declares the local database of calibration results
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+#include "CalibrationJournal.h"
+
+class CCalibrationResult;
+
+
+/*!
+ * Statistical search window for each of the threshold searches,
+ * derived from earlier calibrations of the same firmware on the same fixture.
+ */
+class CSearchPrior
+{
+public:
+    CSearchPrior();
+
+public:
+    int  m_samples;                 // number of calibrations the window is based on
+    int  m_low[JOURNAL_PHASES];     // lower end of the window of each phase
+    int  m_high[JOURNAL_PHASES];    // upper end of the window of each phase
+};
+
+
+/*!
+ * Embedded SQLite database holding every calibration result, indexed by
+ * serial number, time and firmware/fixture.
+ *
+ * Each instance uses its own database connection, and a connection may
+ * only be used from the thread that opened it, so every engine has its
+ * own store and opens it from its own thread.
+ */
+class CHistoryStore
+{
+public:
+    CHistoryStore();
+    ~CHistoryStore();
+
+public:
+    bool open(QString fileName);
+    bool isOpen() const { return(m_open); }
+    void close();
+
+    bool record(const CCalibrationResult &result, QString fixture);
+    QList<CCalibrationResult> findBySerialNumber(QString serialNumber, int limit = 100);
+    QList<CCalibrationResult> findByTime(QDateTime from, QDateTime to, int limit = 1000);
+    bool searchPriors(QString firmware, QString fixture, int channels, CSearchPrior *prior);
+
+private:
+    QString m_connectionName;
+    bool    m_open;
+};
+
+#endif // HISTORYSTORE_H
@@ -6,6 +6,8 @@
 
 QT       += core gui
 QT       += serialport
+QT       += sql
+QT       += network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -19,13 +21,51 @@ SOURCES += main.cpp\
     SerialPortDialog.cpp \
     SerialBuffer.cpp \
     Snooze.cpp \
-    Monitors.cpp
+    Monitors.cpp \
+    ExposureAccumulator.cpp \
+    CalibrationEngine.cpp \
+    StationScheduler.cpp \
+    CommandLine.cpp \
+    CalibrationJournal.cpp \
+    ReportWriter.cpp \
+    HistoryStore.cpp \
+    DriftMonitor.cpp \
+    ThroughputStats.cpp \
+    Metrics.cpp \
+    AutomationServer.cpp \
+    ControllerStream.cpp \
+    ExposureHeatmap.cpp \
+    TrendPlot.cpp \
+    PortProbe.cpp \
+    LedChannels.cpp \
+    ControllerProtocol.cpp \
+    TraceFile.cpp \
+    RealTime.cpp
 
 HEADERS  += mainwindow.h \
     Settings.h \
-    SerialPortDialog.h \
+    serialportdialog.h \
     SerialBuffer.h \
-    Snooze.h
+    Snooze.h \
+    ExposureAccumulator.h \
+    CalibrationEngine.h \
+    StationScheduler.h \
+    CommandLine.h \
+    CalibrationJournal.h \
+    ReportWriter.h \
+    HistoryStore.h \
+    DriftMonitor.h \
+    ThroughputStats.h \
+    Metrics.h \
+    AutomationServer.h \
+    ControllerStream.h \
+    ExposureHeatmap.h \
+    TrendPlot.h \
+    PortProbe.h \
+    LedChannels.h \
+    ControllerProtocol.h \
+    TraceFile.h \
+    RealTime.h
 
 FORMS    += mainwindow.ui \
     SerialPortDialog.ui
@@ -0,0 +1,28 @@
+/*!
+ * @file LedChannels.cpp
+ * @brief Implements the readings of one LED channel
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include "LedChannels.h"
+
+
+CLedChannel::CLedChannel()
+{
+    m_V = 0.0;
+    m_I = 0.0;
+    m_dac = 0;
+    m_low = -1;
+    m_high = -1;
+}
+
@@ -0,0 +1,40 @@
+/*!
+ * @file LedChannels.h
+ * @brief Declares the limits and readings of the LED channels
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef LEDCHANNELS_H
+#define LEDCHANNELS_H
+
+#define LED_CHANNELS_MAX    8       // most LED channels a controller can have
+#define LED_CHANNELS_DEFAULT 2      // channels of the original Spyglass controller
+
+
+/*!
+ * Readings and search results of one LED channel of the controller
+ */
+class CLedChannel
+{
+public:
+    CLedChannel();
+
+public:
+    double  m_V;            // last voltage reading
+    double  m_I;            // last current reading
+    int     m_dac;          // DAC code last read back from the controller
+    int     m_low;          // thresholds found by the run, -1 if not (yet) found
+    int     m_high;
+};
+
+#endif // LEDCHANNELS_H
@@ -0,0 +1,457 @@
+/*!
+ * @file Metrics.cpp
+ * @brief Implements the run-time metrics and their Prometheus export
+ *
+ * Exported series:
+ *   ledcal_serial_rtt_seconds{command,stage}         histogram
+ *   ledcal_serial_timeouts_total{command}            counter
+ *   ledcal_serial_echo_mismatches_total{command}     counter
+ *   ledcal_calibration_duration_seconds              histogram
+ *   ledcal_calibrations_total{outcome}               counter
+ *   ledcal_link_retries_total{port}                  counter
+ *   ledcal_link_timeouts_total{port}                 counter
+ *   ledcal_link_garbage_bytes_total{port}            counter
+ *   ledcal_wakeup_latency_seconds{source}            histogram
+ *   ledcal_wakeup_latency_max_seconds{source}        gauge
+ *   ledcal_wakeup_early_total{source}                counter
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | wakeup latency of the sleeps and settle delays
+ *
+*/
+
+#include <QTimer>
+#include <QSaveFile>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <cstring>
+#include "Metrics.h"
+#include "Settings.h"
+
+//
+// Bucket bounds in ms
+//
+static const qint64 c_rttBounds[]         = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 3000 };
+static const qint64 c_calibrationBounds[] = { 10000, 20000, 30000, 45000, 60000, 90000, 120000, 180000, 300000 };
+
+//
+// Bucket bounds of the wakeup latency in us
+//
+static const qint64 c_wakeupBounds[]      = { 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000 };
+
+//
+// Label values of the commands, in the order of CMetrics::Command
+//
+static const char *c_commandName[CMetrics::METRIC_COMMANDS] =
+{
+    "echo", "version", "led_cal", "led_dac", "ledvi", "em", "em_style", "disable_events", "led", "other"
+};
+static const char *c_stageName[CMetrics::METRIC_STAGES] = { "echo", "response" };
+static const char *c_wakeupName[CMetrics::METRIC_WAKEUP_SOURCES] = { "snooze", "settle" };
+
+//
+// Names and help of the link counters, in the order of CMetrics::LinkCounter
+//
+static const char *c_linkName[CMetrics::METRIC_LINK_COUNTERS] =
+{
+    "ledcal_link_retries_total", "ledcal_link_timeouts_total", "ledcal_link_garbage_bytes_total"
+};
+static const char *c_linkHelp[CMetrics::METRIC_LINK_COUNTERS] =
+{
+    "Transactions sent again after a lost or garbled echo or response.",
+    "Reads that timed out waiting for the controller.",
+    "Bytes read that were neither an echo, a response nor an event."
+};
+
+
+CMetricHistogram::CMetricHistogram(const qint64 *bounds, int bucketCount)
+{
+    m_bounds = bounds;
+    m_bucketCount = qMin(bucketCount, METRIC_MAX_BUCKETS);
+}
+
+
+void CMetricHistogram::observe(qint64 value)
+{
+    int i = 0;
+    while ((i < m_bucketCount) && (value > m_bounds[i]))
+    {
+        i++;
+    }
+    m_buckets[i].fetchAndAddRelaxed(1);
+    m_sum.fetchAndAddRelaxed(value);
+}
+
+
+qint64 CMetricHistogram::count() const
+{
+    qint64 count = 0;
+    for (int i=0; i<=m_bucketCount; i++)
+    {
+        count += m_buckets[i].load();
+    }
+    return(count);
+}
+
+
+/*!
+ * @brief returns the upper bound of the bucket holding a quantile
+ *
+ * @param[in] q - the quantile, e.g. 0.99
+ * @return the bound, 0 if nothing was observed, -1 if the quantile is
+ *         above the last bound
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+qint64 CMetricHistogram::quantile(double q) const
+{
+    qint64 total = count();
+    if (total == 0)
+    {
+        return(0);
+    }
+
+    qint64 rank = qMax((qint64)1, (qint64)(q * total + 0.999999));
+    qint64 cumulative = 0;
+    for (int i=0; i<m_bucketCount; i++)
+    {
+        cumulative += m_buckets[i].load();
+        if (cumulative >= rank)
+        {
+            return(m_bounds[i]);
+        }
+    }
+    return(-1);
+}
+
+
+/*!
+ * @brief appends the histogram in the Prometheus text format
+ *
+ * The buckets are read one at a time, so a snapshot taken while values
+ * are being observed may be off by the observations in flight.
+ *
+ * @param[out] out - text to append to
+ * @param[in] name - metric name
+ * @param[in] labels - labels of the series, e.g. command="ledvi", or empty
+ * @param[in] scale - factor converting the observed values to the exported unit
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CMetricHistogram::render(QByteArray &out, const char *name, QString labels, double scale) const
+{
+    QString prefix = labels.isEmpty() ? QString() : labels + ",";
+    qint64 cumulative = 0;
+    for (int i=0; i<m_bucketCount; i++)
+    {
+        cumulative += m_buckets[i].load();
+        out += QString("%1_bucket{%2le=\"%3\"} %4\n").arg(name).arg(prefix)
+                                                   .arg(m_bounds[i] * scale).arg(cumulative).toUtf8();
+    }
+    cumulative += m_buckets[m_bucketCount].load();
+    out += QString("%1_bucket{%2le=\"+Inf\"} %3\n").arg(name).arg(prefix).arg(cumulative).toUtf8();
+
+    QString braces = labels.isEmpty() ? QString() : "{" + labels + "}";
+    out += QString("%1_sum%2 %3\n").arg(name).arg(braces).arg(m_sum.load() * scale, 0, 'f', 6).toUtf8();
+    out += QString("%1_count%2 %3\n").arg(name).arg(braces).arg(cumulative).toUtf8();
+}
+
+
+CMetrics::CMetrics()
+{
+    int rttBuckets = sizeof(c_rttBounds) / sizeof(c_rttBounds[0]);
+    for (int c=0; c<METRIC_COMMANDS; c++)
+    {
+        for (int s=0; s<METRIC_STAGES; s++)
+        {
+            m_roundTrip[c][s] = new CMetricHistogram(c_rttBounds, rttBuckets);
+        }
+    }
+    m_calibrationDuration = new CMetricHistogram(c_calibrationBounds,
+                                                 sizeof(c_calibrationBounds) / sizeof(c_calibrationBounds[0]));
+    for (int w=0; w<METRIC_WAKEUP_SOURCES; w++)
+    {
+        m_wakeupLatency[w] = new CMetricHistogram(c_wakeupBounds, sizeof(c_wakeupBounds) / sizeof(c_wakeupBounds[0]));
+    }
+}
+
+
+CMetrics *CMetrics::instance()
+{
+    static CMetrics metrics;
+    return(&metrics);
+}
+
+
+/*!
+ * @brief returns the series a command is counted in
+ *
+ * @param[in] command - command line as sent, e.g. "led_dac=100,0"
+ * @return one of the Command values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+int CMetrics::commandIndex(const char *command)
+{
+    size_t length = strcspn(command, "=");
+    for (int i=Command_Version; i<Command_Other; i++)
+    {
+        if ((strlen(c_commandName[i]) == length) && (strncmp(command, c_commandName[i], length) == 0))
+        {
+            return(i);
+        }
+    }
+    return(Command_Other);
+}
+
+
+void CMetrics::observeRoundTrip(int command, int stage, qint64 ms)
+{
+    m_roundTrip[command][stage]->observe(ms);
+}
+
+void CMetrics::countTimeout(int command)
+{
+    m_timeouts[command].fetchAndAddRelaxed(1);
+}
+
+void CMetrics::countEchoMismatch(int command)
+{
+    m_echoMismatches[command].fetchAndAddRelaxed(1);
+}
+
+/*!
+ * @brief adds to a link quality counter of a port
+ *
+ * @param[in] port - serial port name
+ * @param[in] counter - one of the LinkCounter values
+ * @param[in] n - amount to add
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CMetrics::countLink(const QString &port, int counter, qint64 n)
+{
+    QMutexLocker locker(&m_linkMutex);
+    QVector<qint64> &counts = m_link[port];
+    if (counts.isEmpty())
+    {
+        counts.fill(0, METRIC_LINK_COUNTERS);
+    }
+    counts[counter] += n;
+}
+
+void CMetrics::observeCalibration(bool success, qint64 durationMs)
+{
+    m_calibrationDuration->observe(durationMs);
+    if (success)
+    {
+        m_passed.fetchAndAddRelaxed(1);
+    }
+    else
+    {
+        m_failed.fetchAndAddRelaxed(1);
+    }
+}
+
+
+/*!
+ * @brief records how late a wait woke up
+ *
+ * A wakeup before the deadline, which a coarse timer can do, is counted
+ * separately and observed as 0.
+ *
+ * @param[in] source - one of the WakeupSource values
+ * @param[in] lateUs - microseconds from the deadline to the wakeup
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CMetrics::observeWakeup(int source, qint64 lateUs)
+{
+    if (lateUs < 0)
+    {
+        m_wakeupEarly[source].fetchAndAddRelaxed(1);
+        lateUs = 0;
+    }
+    m_wakeupLatency[source]->observe(lateUs);
+
+    qint64 max = m_wakeupMax[source].load();
+    while ((lateUs > max) && !m_wakeupMax[source].testAndSetRelaxed(max, lateUs))
+    {
+        max = m_wakeupMax[source].load();
+    }
+}
+
+
+/*!
+ * @brief returns all metrics in the Prometheus text exposition format
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QByteArray CMetrics::text() const
+{
+    QByteArray out;
+
+    out += "# HELP ledcal_serial_rtt_seconds Time from sending a command to its echo or response line.\n";
+    out += "# TYPE ledcal_serial_rtt_seconds histogram\n";
+    for (int c=0; c<METRIC_COMMANDS; c++)
+    {
+        for (int s=0; s<METRIC_STAGES; s++)
+        {
+            QString labels = QString("command=\"%1\",stage=\"%2\"").arg(c_commandName[c]).arg(c_stageName[s]);
+            m_roundTrip[c][s]->render(out, "ledcal_serial_rtt_seconds", labels, 0.001);
+        }
+    }
+
+    out += "# HELP ledcal_serial_timeouts_total Reads that timed out waiting for the controller.\n";
+    out += "# TYPE ledcal_serial_timeouts_total counter\n";
+    for (int c=0; c<METRIC_COMMANDS; c++)
+    {
+        out += QString("ledcal_serial_timeouts_total{command=\"%1\"} %2\n")
+               .arg(c_commandName[c]).arg(m_timeouts[c].load()).toUtf8();
+    }
+
+    out += "# HELP ledcal_serial_echo_mismatches_total Commands whose echo did not match what was sent.\n";
+    out += "# TYPE ledcal_serial_echo_mismatches_total counter\n";
+    for (int c=0; c<METRIC_COMMANDS; c++)
+    {
+        out += QString("ledcal_serial_echo_mismatches_total{command=\"%1\"} %2\n")
+               .arg(c_commandName[c]).arg(m_echoMismatches[c].load()).toUtf8();
+    }
+
+    out += "# HELP ledcal_calibration_duration_seconds Length of the calibration runs.\n";
+    out += "# TYPE ledcal_calibration_duration_seconds histogram\n";
+    m_calibrationDuration->render(out, "ledcal_calibration_duration_seconds", QString(), 0.001);
+
+    out += "# HELP ledcal_calibrations_total Finished calibration runs by outcome.\n";
+    out += "# TYPE ledcal_calibrations_total counter\n";
+    out += QString("ledcal_calibrations_total{outcome=\"passed\"} %1\n").arg(m_passed.load()).toUtf8();
+    out += QString("ledcal_calibrations_total{outcome=\"failed\"} %1\n").arg(m_failed.load()).toUtf8();
+
+    out += "# HELP ledcal_wakeup_latency_seconds Time from the deadline of a sleep or settle delay to the wakeup.\n";
+    out += "# TYPE ledcal_wakeup_latency_seconds histogram\n";
+    for (int w=0; w<METRIC_WAKEUP_SOURCES; w++)
+    {
+        m_wakeupLatency[w]->render(out, "ledcal_wakeup_latency_seconds", QString("source=\"%1\"").arg(c_wakeupName[w]), 0.000001);
+    }
+    out += "# HELP ledcal_wakeup_latency_max_seconds Longest wakeup latency.\n";
+    out += "# TYPE ledcal_wakeup_latency_max_seconds gauge\n";
+    for (int w=0; w<METRIC_WAKEUP_SOURCES; w++)
+    {
+        out += QString("ledcal_wakeup_latency_max_seconds{source=\"%1\"} %2\n")
+               .arg(c_wakeupName[w]).arg(m_wakeupMax[w].load() * 0.000001, 0, 'f', 6).toUtf8();
+    }
+    out += "# HELP ledcal_wakeup_early_total Waits that ended before their deadline.\n";
+    out += "# TYPE ledcal_wakeup_early_total counter\n";
+    for (int w=0; w<METRIC_WAKEUP_SOURCES; w++)
+    {
+        out += QString("ledcal_wakeup_early_total{source=\"%1\"} %2\n")
+               .arg(c_wakeupName[w]).arg(m_wakeupEarly[w].load()).toUtf8();
+    }
+
+    QMutexLocker locker(&m_linkMutex);
+    for (int c=0; c<METRIC_LINK_COUNTERS; c++)
+    {
+        out += QString("# HELP %1 %2\n").arg(c_linkName[c]).arg(c_linkHelp[c]).toUtf8();
+        out += QString("# TYPE %1 counter\n").arg(c_linkName[c]).toUtf8();
+        QMap<QString, QVector<qint64> >::const_iterator it;
+        for (it = m_link.constBegin(); it != m_link.constEnd(); ++it)
+        {
+            out += QString("%1{port=\"%2\"} %3\n").arg(c_linkName[c]).arg(it.key()).arg(it.value()[c]).toUtf8();
+        }
+    }
+
+    return(out);
+}
+
+
+/*!
+ * @brief constructor
+ *
+ * The textfile is rewritten every metrics/intervalMS ms when metrics/file
+ * is set.  When metrics/socket is set a local server listens on it; on
+ * Linux that is a Unix-domain socket, on Windows a named pipe.
+ *
+ * @param[in] settings - application settings
+ * @param[in] parent - owner of the exporter
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CMetricsExporter::CMetricsExporter(CSettings *settings, QObject *parent) :
+    QObject(parent)
+{
+    m_fileName = settings->m_metricsFile;
+    m_timer = 0;
+    m_server = 0;
+
+    if (!m_fileName.isEmpty())
+    {
+        m_timer = new QTimer(this);
+        connect(m_timer, SIGNAL(timeout()), this, SLOT(writeTextFile()));
+        m_timer->start(qMax(settings->m_metricsIntervalMS, 1000));
+    }
+
+    if (!settings->m_metricsSocket.isEmpty())
+    {
+        m_server = new QLocalServer(this);
+        QLocalServer::removeServer(settings->m_metricsSocket);
+        connect(m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+        m_server->listen(settings->m_metricsSocket);
+    }
+}
+
+
+CMetricsExporter::~CMetricsExporter()
+{
+    writeTextFile();
+}
+
+
+/*!
+ * @brief rewrites the textfile
+ *
+ * The file is replaced atomically so a collector never reads half of it.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CMetricsExporter::writeTextFile()
+{
+    if (m_fileName.isEmpty())
+    {
+        return;
+    }
+
+    QSaveFile file(m_fileName);
+    if (file.open(QIODevice::WriteOnly))
+    {
+        file.write(CMetrics::instance()->text());
+        file.commit();
+    }
+}
+
+
+void CMetricsExporter::onNewConnection()
+{
+    QLocalSocket *socket;
+    while ((socket = m_server->nextPendingConnection()) != 0)
+    {
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        socket->write(CMetrics::instance()->text());
+        socket->disconnectFromServer();
+    }
+}
@@ -0,0 +1,170 @@
+/*!
+ * @file Metrics.h
+ * @brief Declares the run-time metrics and their Prometheus export
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | wakeup latency of the sleeps and settle delays
+ *
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QObject>
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <QMutex>
+
+class QTimer;
+class QLocalServer;
+class CSettings;
+
+#define METRIC_MAX_BUCKETS  16
+
+
+/*!
+ * Histogram with fixed bucket bounds.  observe() only does relaxed atomic
+ * adds, so it never blocks and can be called from any thread.
+ */
+class CMetricHistogram
+{
+public:
+    CMetricHistogram(const qint64 *bounds, int bucketCount);
+
+    void observe(qint64 value);
+    qint64 count() const;
+    qint64 sum() const { return(m_sum.load()); }
+    qint64 quantile(double q) const;
+    void render(QByteArray &out, const char *name, QString labels, double scale) const;
+
+private:
+    const qint64           *m_bounds;                       // upper bounds, ascending
+    int                     m_bucketCount;
+    QAtomicInteger<qint64>  m_buckets[METRIC_MAX_BUCKETS+1];  // last one is +Inf
+    QAtomicInteger<qint64>  m_sum;
+};
+
+
+/*!
+ * Counters and histograms of the serial link and of the calibrations.
+ *
+ * There is one instance for the process, shared by all engines.  All
+ * updates are lock free except the per-port link counters, which are
+ * keyed by port name and take a short lock; text() reads a snapshot for
+ * the exporter.
+ */
+class CMetrics
+{
+public:
+    //! commands with their own series, anything else is counted as "other"
+    enum Command
+    {
+        Command_Echo,
+        Command_Version,
+        Command_LedCal,
+        Command_LedDac,
+        Command_LedVI,
+        Command_Em,
+        Command_EmStyle,
+        Command_DisableEvents,
+        Command_Led,
+        Command_Other,
+        METRIC_COMMANDS
+    };
+
+    //! round trip measured to the echo of the command or to its response line
+    enum Stage
+    {
+        Stage_Echo,
+        Stage_Response,
+        METRIC_STAGES
+    };
+
+    //! link quality counters kept per serial port
+    enum LinkCounter
+    {
+        Link_Retries,           // transactions sent again
+        Link_Timeouts,          // reads that timed out
+        Link_GarbageBytes,      // bytes read that were neither an echo, a response nor an event
+        METRIC_LINK_COUNTERS
+    };
+
+    //! waits whose wakeup latency is measured
+    enum WakeupSource
+    {
+        Wakeup_Snooze,          // snooze() of the blocking serial calls
+        Wakeup_Settle,          // settle delay of the calibration engine
+        METRIC_WAKEUP_SOURCES
+    };
+
+public:
+    static CMetrics *instance();
+    static int commandIndex(const char *command);
+
+    void observeRoundTrip(int command, int stage, qint64 ms);
+    void countTimeout(int command);
+    void countEchoMismatch(int command);
+    void countLink(const QString &port, int counter, qint64 n);
+    void observeCalibration(bool success, qint64 durationMs);
+    void observeWakeup(int source, qint64 lateUs);
+    const CMetricHistogram *wakeupLatency(int source) const { return(m_wakeupLatency[source]); }
+    qint64 wakeupMax(int source) const { return(m_wakeupMax[source].load()); }
+    qint64 wakeupEarly(int source) const { return(m_wakeupEarly[source].load()); }
+
+    QByteArray text() const;
+
+private:
+    CMetrics();
+
+private:
+    CMetricHistogram       *m_roundTrip[METRIC_COMMANDS][METRIC_STAGES];
+    QAtomicInteger<qint64>  m_timeouts[METRIC_COMMANDS];
+    QAtomicInteger<qint64>  m_echoMismatches[METRIC_COMMANDS];
+    CMetricHistogram       *m_calibrationDuration;
+    QAtomicInteger<qint64>  m_passed;
+    QAtomicInteger<qint64>  m_failed;
+    CMetricHistogram       *m_wakeupLatency[METRIC_WAKEUP_SOURCES];     // microseconds past the deadline
+    QAtomicInteger<qint64>  m_wakeupMax[METRIC_WAKEUP_SOURCES];
+    QAtomicInteger<qint64>  m_wakeupEarly[METRIC_WAKEUP_SOURCES];       // wakeups before the deadline
+    mutable QMutex          m_linkMutex;    // guards m_link
+    QMap<QString, QVector<qint64> > m_link;     // port -> METRIC_LINK_COUNTERS counts
+};
+
+
+/*!
+ * Publishes the metrics in the Prometheus text format, in a textfile that
+ * is rewritten periodically and/or on a local (Unix-domain) socket that
+ * returns a snapshot to every client that connects.
+ */
+class CMetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CMetricsExporter(CSettings *settings, QObject *parent = 0);
+    ~CMetricsExporter();
+
+public slots:
+    void writeTextFile();
+
+private slots:
+    void onNewConnection();
+
+private:
+    QString       m_fileName;
+    QTimer       *m_timer;
+    QLocalServer *m_server;
+};
+
+#endif // METRICS_H
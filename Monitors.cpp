@@ -1,281 +1,457 @@
-#include "mainwindow.h"
-#include "ui_mainwindow.h"
+#include <QStringList>
+#include "CalibrationEngine.h"
 
 
 
 /*!
- * @brief
+ * @brief parses the response to the exposure command
  *
- * @param[in] none
- * @param[out] none
- * @return none
+ * @param[in] lines - the response lines
+ * @param[out] zones - EXPOSURE_ZONES values in row order, -1 where not read
+ * @return true if the frame is complete
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::parseExposureFrame(const QStringList &lines, int *zones)
+{
+    return(m_protocol->parseExposureFrame(lines, zones));
+}
+
+
+/*!
+ * @brief adds an exposure frame to the accumulator and reports the statistics
+ *
+ * exposureChanged() reports the per-zone mean and variance over the
+ * accumulated frames.  m_totalExposure is the rounded mean of the total,
+ * which is what the calibration decisions use.
+ *
+ * @param[in] zones - the frame, 0 if it could not be read
+ * @return true if a frame was given
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::publishExposure(const int *zones)
+{
+    if (!zones)
+    {
+        m_exposure.clear();
+        m_totalExposure = 0;
+        emit exposureChanged(false, QVector<double>(), QVector<double>(), 0);
+        return(false);
+    }
+
+    m_exposure.addFrame(zones);
+
+    QVector<double> means(EXPOSURE_ZONES);
+    QVector<double> variances(EXPOSURE_ZONES);
+    m_exposure.means(means.data());
+    m_exposure.variances(variances.data());
+
+    m_totalExposure = qRound(m_exposure.totalMean());
+
+    emit exposureChanged(true, means, variances, m_exposure.count());
+    return(true);
+}
+
+/*!
+ * @brief parses the response to "ledvi" into the readings of the channels
+ *
+ * @param[in] response - the response line
+ * @return true if both values were found for every channel
  *
  * @author J. Peterson
  * @date 01/23/2015
 */
-bool MainWindow::getExposure()
+bool CCalibrationEngine::parseCurrentAndVoltage(const QString &response)
 {
-    if (!m_serialBuffer.writeLine("em=-1"))
+    double V[LED_CHANNELS_MAX];
+    double I[LED_CHANNELS_MAX];
+    if (m_protocol->parseReadings(response, V, I) < m_channels)
     {
         return(false);
     }
 
-    int zones[25];
-    for (int i=0; i<25; i++)
+    for (int c=0; c<m_channels; c++)
     {
-        zones[i] = -1;
+        m_channel[c].m_V = V[c];
+        m_channel[c].m_I = I[c];
     }
+    return(true);
+}
 
-    //
-    // Dump the first line
-    //
-    m_serialBuffer.readString();
 
-    //
-    // Read the 25 fields (five rows of five values)
-    //
-    bool sawError = false;
-    for (int i=0; i<5; i++)
+/*!
+ * @brief reports the currents and voltages, or that they could not be read
+ *
+ * @param[in] valid - true if the channels hold a new reading
+ * @return valid
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CCalibrationEngine::publishCurrentAndVoltage(bool valid)
+{
+    bool sawError = !valid;
+
+    QVector<double> V(m_channels);
+    QVector<double> I(m_channels);
+    for (int c=0; c<m_channels; c++)
     {
-        QString response = m_serialBuffer.readString();
-        QStringList list = response.split(QRegExp("\\W+"), QString::SkipEmptyParts);
-        if (list.size() != 5)
-        {
-            //QString title = QFileInfo( QCoreApplication::applicationFilePath() ).fileName();
-            //QString msg = "Unexpected response:\n";
-            //msg.append(response);
-            //QMessageBox::warning(this, title, msg, QMessageBox::Ok);
-            return(false);
-        }
-        for (int j=0; j<list.size(); j++)
+        CLedChannel &channel = m_channel[c];
+        if (sawError)
         {
-            bool b;
-            zones[i*5+j] = list[j].toInt(&b);
-            if (!b)
-            {
-                sawError = true;
-                break;
-            }
+            channel.m_V = channel.m_I = 0.0;
         }
-        if (sawError)
+        else if ( (channel.m_V > -0.005) && (channel.m_V < 0.0) )
         {
-            break;
+            channel.m_V = 0.0;
         }
+        V[c] = channel.m_V;
+        I[c] = channel.m_I;
     }
+    emit currentAndVoltageChanged(!sawError, V, I);
 
-    if (!sawError)
-    {
-        int z = 0;
-        QString numStr;
-        ui->lineEdit_em_11->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_12->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_13->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_14->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_15->setText(numStr.setNum(zones[z++]));
-
-        ui->lineEdit_em_21->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_22->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_23->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_24->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_25->setText(numStr.setNum(zones[z++]));
-
-        ui->lineEdit_em_31->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_32->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_33->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_34->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_35->setText(numStr.setNum(zones[z++]));
-
-        ui->lineEdit_em_41->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_42->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_43->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_44->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_45->setText(numStr.setNum(zones[z++]));
-
-        ui->lineEdit_em_51->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_52->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_53->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_54->setText(numStr.setNum(zones[z++]));
-        ui->lineEdit_em_55->setText(numStr.setNum(zones[z++]));
+    return(!sawError);
+}
 
-        m_totalExposure = 0;
-        for (int i=0; i<25; i++)
-        {
-            m_totalExposure += zones[i];
-        }
-    }
-    else
-    {
-        ui->lineEdit_em_11->clear();
-        ui->lineEdit_em_12->clear();
-        ui->lineEdit_em_13->clear();
-        ui->lineEdit_em_14->clear();
-        ui->lineEdit_em_15->clear();
-
-        ui->lineEdit_em_21->clear();
-        ui->lineEdit_em_22->clear();
-        ui->lineEdit_em_23->clear();
-        ui->lineEdit_em_24->clear();
-        ui->lineEdit_em_25->clear();
-
-        ui->lineEdit_em_31->clear();
-        ui->lineEdit_em_32->clear();
-        ui->lineEdit_em_33->clear();
-        ui->lineEdit_em_34->clear();
-        ui->lineEdit_em_35->clear();
-
-        ui->lineEdit_em_41->clear();
-        ui->lineEdit_em_42->clear();
-        ui->lineEdit_em_43->clear();
-        ui->lineEdit_em_44->clear();
-        ui->lineEdit_em_45->clear();
-
-        ui->lineEdit_em_51->clear();
-        ui->lineEdit_em_52->clear();
-        ui->lineEdit_em_53->clear();
-        ui->lineEdit_em_54->clear();
-        ui->lineEdit_em_55->clear();
 
-        m_totalExposure = 0;
+/*!
+ * @brief takes the next exposure frame from the event stream, which must have arrived
+ *
+ * A reader that fell more than the ring behind continues with the oldest
+ * frame still kept.
+ *
+ * @param[out] zones - EXPOSURE_ZONES values in row order
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::takeStreamFrame(int *zones)
+{
+    if (m_stream.exposureCount() - m_streamExposureSeen > STREAM_EXPOSURE_FRAMES)
+    {
+        m_streamExposureSeen = m_stream.exposureCount() - STREAM_EXPOSURE_FRAMES;
     }
 
-    qApp->processEvents();
-    return(!sawError);
+    const CExposureSample &sample = m_stream.exposure(m_streamExposureSeen);
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        zones[i] = sample.m_zones[i];
+    }
+    m_streamExposureSeen++;
 }
 
+
 /*!
- * @brief
+ * @brief takes the newest current and voltage sample from the event stream,
+ *        which must have arrived
  *
- * @param[in] none
- * @param[out] none
- * @return none
+ * @return false if the sample lacks readings for some of the channels
  *
- * @author J. Peterson
- * @date 01/23/2015
+ * @author agent
+ * @date 10/18/2026
 */
-bool MainWindow::getCurrentAndVoltage()
+bool CCalibrationEngine::takeStreamVoltage()
 {
-    bool sawError = false;
-
-    if (!m_serialBuffer.writeLine("ledvi"))
+    m_streamVoltageSeen = m_stream.voltageCount();
+    const CVoltageSample &sample = m_stream.voltage(m_streamVoltageSeen-1);
+    if (sample.m_channels < m_channels)
     {
-        sawError = true;
+        return(false);
     }
-    QString response = m_serialBuffer.readString();
-    double index;
-    QString tmpStr;
-
-    //
-    // V1
-    //
-    tmpStr = response;
-    index = tmpStr.indexOf("V1:");
-    if (index < 0)
+    for (int c=0; c<m_channels; c++)
     {
-        sawError = true;
+        m_channel[c].m_V = sample.m_V[c];
+        m_channel[c].m_I = sample.m_I[c];
     }
-    else
+    return(true);
+}
+
+
+/*!
+ * @brief one pass of the idle monitor, see poll()
+ *
+ * The port is opened and the controller initialized only when there is no
+ * connection yet.  The firmware version and the stored calibration do not
+ * change while a controller is connected, so they are read once per
+ * connection, and again when a scope is inserted.  I/V, exposure and the
+ * DAC values are each read at their own configured interval; a pass in
+ * which nothing is due does not touch the serial port.
+ *
+ * While streaming, everything that arrived since the last pass is
+ * published; nothing is sent to the controller except the DAC reading
+ * and, after a long silence, the echo check.  The scope counts as present
+ * while exposure frames keep arriving.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CCalibrationEngine::stepMonitor()
+{
+    switch (m_state)
     {
-        tmpStr.remove(0, index+3);
-        index = tmpStr.indexOf(",");
-        if (index < 0)
+    case Monitor_Begin:
+        m_monitorOk = true;
+        if (m_monitorConnected)
         {
-            sawError = true;
+            m_state = m_streaming ? Monitor_Stream : Monitor_Readings;
+            break;
         }
-        else
+        resetMonitor();
+
+        //
+        // Try to open the serial port
+        //
+        if (!m_serialBuffer.openPort(m_serialPortName))
         {
-            tmpStr.truncate(index);
-            m_V1 = tmpStr.toDouble();
+            endMonitor(Poll_NoSerialPort);
+            break;
         }
-    }
+        openTrace();
 
-    //
-    // I1
-    //
-    tmpStr = response;
-    index = tmpStr.indexOf("I1:");
-    if (index < 0)
-    {
-        sawError = true;
-    }
-    else
-    {
-        tmpStr.remove(0, index+3);
-        index = tmpStr.indexOf(",");
-        if (index < 0)
+        //
+        // See if the controller is running
+        //
+        connectLink(Monitor_Connected);
+        break;
+
+    case Monitor_Connected:
+        if (!m_linkOk)
         {
-            sawError = true;
+            endMonitor(Poll_NoEcho);
+            break;
         }
-        else
+
+        //
+        // Turn off the event echoing
+        //
+        send("disable_events=1", 1, Monitor_EventsOff);
+        break;
+
+    case Monitor_EventsOff:
+        if (!m_replyOk)
         {
-            tmpStr.truncate(index);
-            m_I1 = tmpStr.toDouble();
+            endMonitor(Poll_NoResponse);
+            break;
         }
-    }
+        send("em_style=0", 0, Monitor_StyleSet);
+        break;
 
-    //
-    // V2
-    //
-    tmpStr = response;
-    index = tmpStr.indexOf("V2:");
-    if (index < 0)
-    {
-        sawError = true;
-    }
-    else
-    {
-        tmpStr.remove(0, index+3);
-        index = tmpStr.indexOf(",");
-        if (index < 0)
+    case Monitor_StyleSet:
+        if (!m_replyOk)
         {
-            sawError = true;
+            endMonitor(Poll_NoResponse);
+            break;
         }
-        else
+        negotiateLink(Monitor_Negotiated);
+        break;
+
+    case Monitor_Negotiated:
+        send(m_protocol->m_versionCommand, m_protocol->m_versionLines, Monitor_Version);
+        break;
+
+    case Monitor_Version:
+        parseFirmwareVersion(m_reply);
+        send(m_protocol->m_calibrationCommand, 1, Monitor_StoredCal);
+        break;
+
+    case Monitor_StoredCal:
+        parseCalibrationValues(m_reply.value(0));
+        m_monitorConnected = true;
+        if (!m_settings->m_streamEnabled)
         {
-            tmpStr.truncate(index);
-            m_V2 = tmpStr.toDouble();
+            m_state = Monitor_Readings;
+            break;
         }
-    }
+        send(m_protocol->m_dacCommand, 1, Monitor_StartDac);
+        break;
 
-    //
-    // I2
-    //
-    tmpStr = response;
-    index = tmpStr.indexOf("I2:");
-    if (index < 0)
-    {
-        sawError = true;
-    }
-    else
-    {
-        tmpStr.remove(0, index+3);
-        m_I2 = tmpStr.toDouble();
-    }
+    case Monitor_StartDac:
+        parseDacValues(m_replyOk ? m_reply.value(0) : QString());
+        startStream(Monitor_StreamStarted);
+        break;
 
-    if (sawError)
-    {
-        m_V1 = m_V2 = m_I1 = m_I2 = 0.0;
-        ui->lineEdit_amps1->clear();
-        ui->lineEdit_amps2->clear();
-        ui->lineEdit_volts1->clear();
-        ui->lineEdit_volts2->clear();
-    }
-    else
-    {
-        QString numStr;
-        if ( (m_V1 > -0.005) && (m_V1 < 0.0) )
+    case Monitor_StreamStarted:
+        if (m_commandsOk)
         {
-            m_V1 = 0.0;
+            m_state = Monitor_Stream;
+            break;
         }
-        if ( (m_V2 > -0.005) && (m_V2 < 0.0) )
+        sendCommands(m_settings->m_streamStopCommands, Monitor_StreamFallback);
+        break;
+
+    case Monitor_StreamFallback:
+        m_serialBuffer.setEventFilter(0);
+        m_streaming = false;
+        m_state = Monitor_Readings;
+        break;
+
+    case Monitor_Readings:
+        if (monitorDue(m_monitorVoltage, m_settings->m_monitorVoltageMS))
         {
-            m_V2 = 0.0;
+            send(m_protocol->m_readingsCommand, 1, Monitor_VI);
+            break;
         }
-        ui->lineEdit_volts1->setText(numStr.setNum(m_V1, 'f', 2));
-        ui->lineEdit_volts2->setText(numStr.setNum(m_V2, 'f', 2));
-        ui->lineEdit_amps1->setText(numStr.setNum(m_I1, 'f', 3));
-        ui->lineEdit_amps2->setText(numStr.setNum(m_I2, 'f', 3));
-    }
-    qApp->processEvents();
+        m_state = Monitor_Exposure;
+        break;
 
-    return(true);
+    case Monitor_VI:
+        if (!publishCurrentAndVoltage(m_replyOk && parseCurrentAndVoltage(m_reply.value(0))))
+        {
+            m_monitorOk = false;
+        }
+        m_state = Monitor_Exposure;
+        break;
+
+    case Monitor_Exposure:
+        if (monitorDue(m_monitorExposure, m_settings->m_monitorExposureMS))
+        {
+            send(m_protocol->m_exposureCommand, m_protocol->m_exposureLines, Monitor_Frame);
+            break;
+        }
+        m_state = Monitor_Dac;
+        break;
+
+    case Monitor_Frame:
+        {
+            int zones[EXPOSURE_ZONES];
+            bool scope = m_replyOk && parseExposureFrame(m_reply, zones);
+            publishExposure(scope ? zones : 0);
+            bool inserted = scope && !m_monitorScope;
+            m_monitorScope = scope;
+            if (inserted)
+            {
+                m_monitorDac.invalidate();
+                send(m_protocol->m_calibrationCommand, 1, Monitor_ScopeCal);
+                break;
+            }
+        }
+        m_state = Monitor_Dac;
+        break;
+
+    case Monitor_ScopeCal:
+        parseCalibrationValues(m_reply.value(0));
+        m_state = Monitor_Dac;
+        break;
+
+    case Monitor_Dac:
+        if (m_monitorScope && monitorDue(m_monitorDac, m_settings->m_monitorDacMS))
+        {
+            send(m_protocol->m_dacCommand, 1, Monitor_DacRead);
+            break;
+        }
+        m_state = Monitor_Check;
+        break;
+
+    case Monitor_DacRead:
+        if (!parseDacValues(m_replyOk ? m_reply.value(0) : QString()))
+        {
+            m_monitorOk = false;
+        }
+        m_state = Monitor_Check;
+        break;
+
+    case Monitor_Check:
+        //
+        // A failed reading may mean the controller is gone; if so, start over
+        //
+        if (!m_monitorOk)
+        {
+            send("", 0, Monitor_Echo);
+            break;
+        }
+        endMonitor(m_monitorScope ? Poll_ScopeDetected : Poll_NoScope);
+        break;
+
+    case Monitor_Stream:
+        m_serialBuffer.drainEvents();
+        if (m_stream.voltageCount() > m_streamVoltageSeen)
+        {
+            publishCurrentAndVoltage(takeStreamVoltage());
+        }
+        if (m_stream.exposureCount() > m_streamExposureSeen)
+        {
+            int zones[EXPOSURE_ZONES];
+            while (m_stream.exposureCount() > m_streamExposureSeen+1)
+            {
+                takeStreamFrame(zones);
+                m_exposure.addFrame(zones);
+            }
+            takeStreamFrame(zones);
+            publishExposure(zones);
+        }
+        {
+            qint64 now = m_stream.now();
+            bool scope = (m_stream.exposureCount() > 0)
+                      && (now - m_stream.exposure(m_stream.exposureCount()-1).m_time < STREAM_SCOPE_MS);
+            bool inserted = scope && !m_monitorScope;
+            if (!scope && m_monitorScope)
+            {
+                m_exposure.clear();
+                m_totalExposure = 0;
+                emit exposureChanged(false, QVector<double>(), QVector<double>(), 0);
+            }
+            m_monitorScope = scope;
+            if (inserted)
+            {
+                m_monitorDac.invalidate();
+                send(m_protocol->m_calibrationCommand, 1, Monitor_StreamCal);
+                break;
+            }
+        }
+        m_state = Monitor_StreamReadDac;
+        break;
+
+    case Monitor_StreamCal:
+        parseCalibrationValues(m_reply.value(0));
+        m_state = Monitor_StreamReadDac;
+        break;
+
+    case Monitor_StreamReadDac:
+        if (m_monitorScope && monitorDue(m_monitorDac, m_settings->m_monitorDacMS))
+        {
+            send(m_protocol->m_dacCommand, 1, Monitor_StreamDac);
+            break;
+        }
+        m_state = Monitor_StreamCheck;
+        break;
+
+    case Monitor_StreamDac:
+        m_monitorOk = parseDacValues(m_replyOk ? m_reply.value(0) : QString());
+        m_state = Monitor_StreamCheck;
+        break;
+
+    case Monitor_StreamCheck:
+        //
+        // No events for a while may mean the controller is gone.  The I/V
+        // timer is not used while streaming; it paces the echo checks.
+        //
+        {
+            qint64 now = m_stream.now();
+            if (    (!m_monitorOk || (m_stream.lastEventTime() < 0) || (now - m_stream.lastEventTime() > STREAM_SILENCE_MS))
+                 && monitorDue(m_monitorVoltage, STREAM_SILENCE_MS) )
+            {
+                send("", 0, Monitor_Echo);
+                break;
+            }
+        }
+        endMonitor(m_monitorScope ? Poll_ScopeDetected : Poll_NoScope);
+        break;
+
+    case Monitor_Echo:
+        if (!m_replyOk)
+        {
+            resetMonitor();
+            endMonitor(Poll_NoEcho);
+            break;
+        }
+        endMonitor(m_monitorScope ? Poll_ScopeDetected : Poll_NoScope);
+        break;
+
+    default:
+        m_state = Run_Idle;
+        break;
+    }
 }
@@ -0,0 +1,87 @@
+/*!
+ * @file PortProbe.cpp
+ * @brief Implements the identification of a controller on a serial port
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | versions parsed by the controller protocol
+ *
+*/
+
+#include "PortProbe.h"
+#include "SerialBuffer.h"
+#include "ControllerProtocol.h"
+
+
+/*!
+ * @brief constructor
+ *
+ * @param[in] portName - serial port to probe
+ * @param[in] timeoutMS - timeout of the echo and of each response line
+ * @param[in] parent - owner, must be 0 if the probe is moved to a thread
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CPortProbe::CPortProbe(QString portName, int timeoutMS, QObject *parent) :
+    QObject(parent)
+{
+    m_portName = portName;
+    m_timeoutMS = timeoutMS;
+}
+
+
+/*!
+ * @brief opens the port, checks the echo and reads the firmware versions
+ *
+ * A port that echoes but whose version response no compiled-in protocol
+ * understands is not taken for a controller.  The version command is the
+ * same for all protocols.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CPortProbe::probe()
+{
+    CSerialBuffer serialBuffer;
+    serialBuffer.setTimeout(m_timeoutMS);
+
+    if (!serialBuffer.openPort(m_portName))
+    {
+        emit probed(m_portName, Probe_Unavailable, QString(), QString(), QString());
+        return;
+    }
+
+    const CControllerProtocol *protocol = CControllerProtocol::select(PROTOCOL_AUTO);
+    if (    !serialBuffer.checkForEcho()
+         || !serialBuffer.writeLine("disable_events=1")
+         || !serialBuffer.writeLine(protocol->m_versionCommand) )
+    {
+        emit probed(m_portName, Probe_NoController, QString(), QString(), QString());
+        return;
+    }
+
+    QStringList lines;
+    for (int i=0; i<protocol->m_versionLines; i++)
+    {
+        lines.append(serialBuffer.readString().trimmed());
+    }
+
+    QString arm;
+    QString dsp;
+    QString fpga;
+    protocol = CControllerProtocol::identify(lines);
+    if (!protocol || !protocol->parseVersion(lines, &arm, &dsp, &fpga))
+    {
+        emit probed(m_portName, Probe_NoController, QString(), QString(), QString());
+        return;
+    }
+    emit probed(m_portName, Probe_Controller, arm, dsp, fpga);
+}
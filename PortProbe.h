@@ -0,0 +1,58 @@
+/*!
+ * @file PortProbe.h
+ * @brief Declares the identification of a controller on a serial port
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef PORTPROBE_H
+#define PORTPROBE_H
+
+#include <QObject>
+#include <QString>
+
+
+/*!
+ * Checks whether a controller is attached to one serial port, with a short
+ * echo check and the "version" command.
+ *
+ * Meant to be moved to a thread of its own so all ports can be probed at
+ * the same time; probe() runs once and reports through probed().
+ */
+class CPortProbe : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! outcome of a probe
+    enum ProbeState
+    {
+        Probe_Unavailable,      // the port could not be opened, e.g. in use
+        Probe_NoController,     // no echo, or not a controller
+        Probe_Controller        // a controller answered
+    };
+
+public:
+    explicit CPortProbe(QString portName, int timeoutMS, QObject *parent = 0);
+
+public slots:
+    void probe();
+
+signals:
+    void probed(QString portName, int state, QString arm, QString dsp, QString fpga);
+
+private:
+    QString m_portName;
+    int     m_timeoutMS;            // timeout of each read, much shorter than in a calibration
+};
+
+#endif // PORTPROBE_H
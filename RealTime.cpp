@@ -0,0 +1,159 @@
+/*!
+ * @file RealTime.cpp
+ * @brief Implements the real-time mode of the serial timing
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | thread that enters the mode itself
+ *
+*/
+
+#include <QtGlobal>
+#include "RealTime.h"
+#include "Settings.h"
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#endif
+
+
+CRealTimeMode::CRealTimeMode()
+{
+    m_enabled = false;
+    m_priority = 20;
+    m_cpu = -1;
+    m_lockMemory = true;
+    m_timerSlackNs = 1000;
+}
+
+
+CRealTimeMode CRealTimeMode::fromSettings(const CSettings *settings)
+{
+    CRealTimeMode mode;
+    mode.m_enabled = settings->m_realTimeEnabled;
+    mode.m_priority = settings->m_realTimePriority;
+    mode.m_cpu = settings->m_realTimeCpu;
+    mode.m_lockMemory = settings->m_realTimeLockMemory;
+    if (settings->m_realTimeTimerSlackNs > 0)
+    {
+        mode.m_timerSlackNs = settings->m_realTimeTimerSlackNs;
+    }
+    return(mode);
+}
+
+
+/*!
+ * @brief applies the mode to the calling thread
+ *
+ * Does nothing if the mode is not enabled.
+ *
+ * @param[out] problems - a line for each part that could not be applied
+ * @return true if every part was applied
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CRealTimeMode::enter(QStringList *problems) const
+{
+    if (!m_enabled)
+    {
+        return(true);
+    }
+
+#ifdef Q_OS_LINUX
+    int before = problems->size();
+    int error;
+
+    //
+    // A slack of 0 would mean the default again
+    //
+    if (prctl(PR_SET_TIMERSLACK, (unsigned long)qMax(m_timerSlackNs, 1), 0, 0, 0) != 0)
+    {
+        problems->append(QString("Timer slack not set: %1").arg(strerror(errno)));
+    }
+
+    if (m_cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(m_cpu, &cpus);
+        if ((error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) != 0)
+        {
+            problems->append(QString("Not pinned to CPU %1: %2").arg(m_cpu).arg(strerror(error)));
+        }
+    }
+
+    //
+    // With MCL_FUTURE every later allocation beyond RLIMIT_MEMLOCK fails,
+    // so the memory is only locked if the limit does not apply
+    //
+    if (m_lockMemory)
+    {
+        struct rlimit limit;
+        if (    (geteuid() != 0)
+             && ((getrlimit(RLIMIT_MEMLOCK, &limit) != 0) || (limit.rlim_cur != RLIM_INFINITY)) )
+        {
+            problems->append("Memory not locked: RLIMIT_MEMLOCK is limited (set memlock to unlimited in /etc/security/limits.conf)");
+        }
+        else if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            problems->append(QString("Memory not locked: %1").arg(strerror(errno)));
+        }
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), m_priority, sched_get_priority_max(SCHED_FIFO));
+    if ((error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) != 0)
+    {
+        problems->append(QString("No real-time priority %1: %2 (needs CAP_SYS_NICE or an rtprio limit)")
+                         .arg(param.sched_priority).arg(strerror(error)));
+    }
+
+    return(problems->size() == before);
+#else
+    problems->append("The real-time mode is only available on Linux.");
+    return(false);
+#endif
+}
+
+
+CRealTimeThread::CRealTimeThread(const CRealTimeMode &mode, QObject *parent) :
+    QThread(parent),
+    m_mode(mode)
+{
+}
+
+
+/*!
+ * @brief enters the real-time mode and runs the event loop of the thread
+ *
+ * realTimeModeIncomplete() is emitted with the parts that could not be
+ * applied, joined into one line.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CRealTimeThread::run()
+{
+    QStringList problems;
+    if (!m_mode.enter(&problems))
+    {
+        emit realTimeModeIncomplete(problems.join("; "));
+    }
+    exec();
+}
@@ -0,0 +1,79 @@
+/*!
+ * @file RealTime.h
+ * @brief Declares the real-time mode of the serial timing
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | thread that enters the mode itself
+ *
+*/
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+class CSettings;
+
+
+/*!
+ * Scheduling of the thread the engines and their serial I/O run in.
+ *
+ * The settle delays and timeouts are only as good as the wakeups of that
+ * thread, and on a shared line PC a wakeup can be late by many ms.  On
+ * Linux enter() puts the calling thread at a SCHED_FIFO priority, pins it
+ * to one CPU, lowers its timer slack and locks the process in memory.
+ * Each of these is tried on its own, so missing privileges cost only the
+ * parts that need them.  The resulting wakeup latency is in the metrics.
+ */
+class CRealTimeMode
+{
+public:
+    CRealTimeMode();
+    static CRealTimeMode fromSettings(const CSettings *settings);
+
+    bool enter(QStringList *problems) const;
+
+public:
+    bool    m_enabled;
+    int     m_priority;         // SCHED_FIFO priority, clamped to what the system allows
+    int     m_cpu;              // CPU to pin the thread to, -1 for any
+    bool    m_lockMemory;       // lock the current and future pages of the process
+    int     m_timerSlackNs;     // timer slack of the thread, the kernel default is 50000
+};
+
+
+/*!
+ * Thread of an engine and its serial I/O, in the real-time mode.
+ *
+ * The thread enters the mode itself before its event loop starts, so the
+ * priority, CPU and timer slack apply to it alone and never to the GUI
+ * thread that created it.  Only the memory lock covers the whole process.
+ */
+class CRealTimeThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    CRealTimeThread(const CRealTimeMode &mode, QObject *parent = 0);
+
+signals:
+    void realTimeModeIncomplete(QString problems);
+
+protected:
+    void run();
+
+private:
+    CRealTimeMode   m_mode;
+};
+
+#endif // REALTIME_H
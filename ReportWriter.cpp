@@ -0,0 +1,200 @@
+/*!
+ * @file ReportWriter.cpp
+ * @brief Implements the background writer of the calibration report files
+ *
+ * Every calibration run is written as one JSON object per line so the
+ * report can be read by people and by scripts.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QFile>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include "ReportWriter.h"
+#include "CalibrationEngine.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//
+// Batching parameters
+//
+const int c_batchIntervalMS = 500;      // longest a record waits before it is written
+const int c_batchSize       = 64;       // records that trigger an immediate write
+const int c_syncIntervalMS  = 5000;     // interval between syncs to disk
+
+
+CReportWriter::CReportWriter(QObject *parent) :
+    QThread(parent)
+{
+    m_stopping = false;
+    m_dirty = false;
+    start(QThread::LowPriority);
+}
+
+
+/*!
+ * @brief destructor
+ *
+ * All queued records are written and synced before the thread exits.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CReportWriter::~CReportWriter()
+{
+    stop();
+    wait();
+}
+
+
+/*!
+ * @brief queues a record for a report file
+ *
+ * @param[in] fileName - report file, created if needed
+ * @param[in] record - data to append, including the line terminator
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CReportWriter::write(QString fileName, const QByteArray &record)
+{
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    CRecord r;
+    r.m_fileName = fileName;
+    r.m_data = record;
+
+    QMutexLocker lock(&m_mutex);
+    m_pending.append(r);
+    if (m_pending.size() >= c_batchSize)
+    {
+        m_wake.wakeOne();
+    }
+}
+
+
+/*!
+ * @brief queues the record of one calibration run
+ *
+ * @param[in] fileName - report file
+ * @param[in] result - outcome of the run
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CReportWriter::write(QString fileName, const CCalibrationResult &result)
+{
+    QByteArray record = QJsonDocument(result.toJson()).toJson(QJsonDocument::Compact);
+    record.append('\n');
+    write(fileName, record);
+}
+
+
+void CReportWriter::stop()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stopping = true;
+    m_wake.wakeOne();
+}
+
+
+/*!
+ * @brief writer thread
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CReportWriter::run()
+{
+    QElapsedTimer sinceSync;
+    sinceSync.start();
+
+    bool stopping = false;
+    while (!stopping)
+    {
+        QList<CRecord> batch;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (!m_stopping && (m_pending.size() < c_batchSize))
+            {
+                m_wake.wait(&m_mutex, c_batchIntervalMS);
+            }
+            batch.swap(m_pending);
+            stopping = m_stopping;
+        }
+
+        writeBatch(batch);
+
+        if (m_dirty && (stopping || sinceSync.hasExpired(c_syncIntervalMS)))
+        {
+            syncFiles();
+            sinceSync.restart();
+        }
+    }
+
+    qDeleteAll(m_files);
+    m_files.clear();
+}
+
+
+void CReportWriter::writeBatch(const QList<CRecord> &batch)
+{
+    QList<QFile *> written;
+    for (int i=0; i<batch.size(); i++)
+    {
+        QFile *file = m_files.value(batch[i].m_fileName, 0);
+        if (!file)
+        {
+            file = new QFile(batch[i].m_fileName);
+            if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+            {
+                delete file;
+                continue;
+            }
+            m_files.insert(batch[i].m_fileName, file);
+        }
+        file->write(batch[i].m_data);
+        if (!written.contains(file))
+        {
+            written.append(file);
+        }
+    }
+
+    for (int i=0; i<written.size(); i++)
+    {
+        written[i]->flush();
+        m_dirty = true;
+    }
+}
+
+
+void CReportWriter::syncFiles()
+{
+    QHash<QString, QFile *>::iterator it;
+    for (it = m_files.begin(); it != m_files.end(); ++it)
+    {
+#ifdef Q_OS_WIN
+        _commit(it.value()->handle());
+#else
+        fsync(it.value()->handle());
+#endif
+    }
+    m_dirty = false;
+}
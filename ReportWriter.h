@@ -0,0 +1,75 @@
+/*!
+ * @file ReportWriter.h
+ * @brief Declares the background writer of the calibration report files
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+
+class QFile;
+class CCalibrationResult;
+
+
+/*!
+ * Appends records to report files from a background thread.
+ *
+ * write() only queues the record, so callers never wait for the disk.
+ * The thread writes queued records in batches, flushes after each batch
+ * and syncs the files to disk periodically and on shutdown.
+ */
+class CReportWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit CReportWriter(QObject *parent = 0);
+    ~CReportWriter();
+
+    void write(QString fileName, const QByteArray &record);
+    void write(QString fileName, const CCalibrationResult &result);
+    void stop();
+
+protected:
+    void run();
+
+private:
+    class CRecord
+    {
+    public:
+        QString    m_fileName;
+        QByteArray m_data;
+    };
+
+    void writeBatch(const QList<CRecord> &batch);
+    void syncFiles();
+
+private:
+    QMutex              m_mutex;
+    QWaitCondition      m_wake;
+    QList<CRecord>      m_pending;      // records waiting to be written
+    bool                m_stopping;
+
+    QHash<QString, QFile *> m_files;    // open report files, used by the writer thread only
+    bool                m_dirty;        // data written since the last sync
+};
+
+#endif // REPORTWRITER_H
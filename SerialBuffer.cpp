@@ -4,19 +4,196 @@
 #include <QMessageBox>
 #include "SerialBuffer.h"
 #include "Snooze.h"
+#include "Metrics.h"
+#include "Settings.h"
+#include "TraceFile.h"
 
+//
+// Longest wait between two retries
+//
+const int c_maxBackoffMS = 200;
 
-CSerialBuffer::CSerialBuffer()
+//
+// How a failed transaction of a command may be retried
+//
+enum RetryRule
+{
+    Retry_Always,           // idempotent: a query, or sets an absolute value
+    Retry_IfNotReceived,    // only if nothing came back, i.e. the controller never saw the command
+    Retry_Never             // has effects that must not be repeated
+};
+
+//
+// Commands that are not freely repeatable, matched by prefix.  Every other
+// command is a query or sets an absolute value and may be retried.
+//
+static const struct
+{
+    const char *m_prefix;
+    RetryRule   m_rule;
+} c_retryRules[] =
+{
+    { "led_cal=",   Retry_IfNotReceived },  // writes the calibration to flash
+    { "cc_reset",   Retry_Never }
+};
+
+
+CLinkParameters::CLinkParameters()
+{
+    m_baudRate = QSerialPort::Baud115200;
+    m_dataBits = QSerialPort::Data8;
+    m_parity = QSerialPort::NoParity;
+    m_stopBits = QSerialPort::OneStop;
+    m_flowControl = QSerialPort::NoFlowControl;
+    m_retries = 0;
+    m_retryBackoffMS = 10;
+    m_echoTimeoutMS = 500;
+    m_preciseTimers = false;
+}
+
+
+/*!
+ * @brief reads the link parameters of this fixture from the settings
+ *
+ * Values that are not understood keep the 115200 8N1 default.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CLinkParameters CLinkParameters::fromSettings(const CSettings *settings)
+{
+    CLinkParameters link;
+    if (settings->m_linkBaudRate > 0)
+    {
+        link.m_baudRate = settings->m_linkBaudRate;
+    }
+    if ((settings->m_linkDataBits >= 5) && (settings->m_linkDataBits <= 8))
+    {
+        link.m_dataBits = (QSerialPort::DataBits)settings->m_linkDataBits;
+    }
+
+    QString parity = settings->m_linkParity.toLower();
+    if (parity == "even")
+    {
+        link.m_parity = QSerialPort::EvenParity;
+    }
+    else if (parity == "odd")
+    {
+        link.m_parity = QSerialPort::OddParity;
+    }
+    else if (parity == "space")
+    {
+        link.m_parity = QSerialPort::SpaceParity;
+    }
+    else if (parity == "mark")
+    {
+        link.m_parity = QSerialPort::MarkParity;
+    }
+
+    if (settings->m_linkStopBits == 2)
+    {
+        link.m_stopBits = QSerialPort::TwoStop;
+    }
+
+    link.m_retries = qMax(settings->m_linkRetries, 0);
+    link.m_retryBackoffMS = qMax(settings->m_linkRetryBackoffMS, 0);
+    if (settings->m_linkEchoTimeoutMS > 0)
+    {
+        link.m_echoTimeoutMS = settings->m_linkEchoTimeoutMS;
+    }
+
+    link.m_preciseTimers = settings->m_realTimeEnabled;
+
+    QString flowControl = settings->m_linkFlowControl.toLower();
+    if (flowControl == "hardware")
+    {
+        link.m_flowControl = QSerialPort::HardwareControl;
+    }
+    else if (flowControl == "software")
+    {
+        link.m_flowControl = QSerialPort::SoftwareControl;
+    }
+    return(link);
+}
+
+
+/*!
+ * @brief returns the rates the negotiation may try, fastest first
+ *
+ * Empty if the settings give no command to change the controller's rate.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QList<qint32> CLinkParameters::fastRates(const CSettings *settings)
+{
+    QList<qint32> rates;
+    if (settings->m_linkBaudCommand.isEmpty())
+    {
+        return(rates);
+    }
+    for (int i=0; i<settings->m_linkFastRates.size(); i++)
+    {
+        qint32 rate = settings->m_linkFastRates[i].trimmed().toInt();
+        if (rate > 0)
+        {
+            rates.append(rate);
+        }
+    }
+    return(rates);
+}
+
+
+CLinkQuality::CLinkQuality()
+{
+    m_retries = 0;
+    m_timeouts = 0;
+    m_garbageBytes = 0;
+}
+
+
+CLinkThroughput::CLinkThroughput()
+{
+    m_baudRate = 0;
+    m_rounds = 0;
+    m_failures = 0;
+    m_rttMs = 0.0;
+    m_bytesPerSecond = 0.0;
+}
+
+
+CSerialBuffer::CSerialBuffer(QObject *parent) :
+    QObject(parent),
+    m_txTimer(this)
 {
     m_serialPort = new QSerialPort(this);
     m_timeoutMS = 3000;
+    m_command = CMetrics::Command_Other;
+    m_awaitingResponse = false;
+    m_eventFilter = 0;
+    m_baudRate = m_link.m_baudRate;
+    m_timedOut = false;
+    m_trace = 0;
+
+    m_txState = Tx_Idle;
+    m_txLines = 0;
+    m_txAttempt = 0;
+    m_txReceived = 0;
+    m_notifyEvents = false;
+    m_txTimer.setSingleShot(true);
+    connect(&m_txTimer, SIGNAL(timeout()), this, SLOT(onTransactionTimer()));
+    connect(m_serialPort, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
 }
 
 CSerialBuffer::~CSerialBuffer()
 {
+    //
+    // Commands written without waiting for their echo (see writeCommand())
+    // still go out when the port is closed
+    //
     if (m_serialPort)
     {
-        m_serialPort->clear();
+        m_serialPort->clear(QSerialPort::Input);
         m_serialPort->close();
     }
 }
@@ -49,6 +226,16 @@ bool CSerialBuffer::openPort(QString portName)
         return(false);
     }
 
+    //
+    // A controller keeps a negotiated rate while the port is closed, so the
+    // same port is reopened at the rate it was left at.
+    //
+    if (portName != m_portName)
+    {
+        m_portName = portName;
+        m_baudRate = m_link.m_baudRate;
+    }
+
     m_serialPort->setPortName(portName);
     m_serialPort->open(QSerialPort::ReadWrite);
     if (!m_serialPort->isOpen())
@@ -56,11 +243,11 @@ bool CSerialBuffer::openPort(QString portName)
         return(false);
     }
 
-    m_serialPort->setBaudRate(QSerialPort::Baud115200);
-    m_serialPort->setDataBits(QSerialPort::Data8);
-    m_serialPort->setParity(QSerialPort::NoParity);
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    m_serialPort->setBaudRate(m_baudRate);
+    m_serialPort->setDataBits(m_link.m_dataBits);
+    m_serialPort->setParity(m_link.m_parity);
+    m_serialPort->setStopBits(m_link.m_stopBits);
+    m_serialPort->setFlowControl(m_link.m_flowControl);
     m_serialPort->setDataTerminalReady(true);
 
     m_serialPort->clearError();
@@ -70,6 +257,187 @@ bool CSerialBuffer::openPort(QString portName)
     return(true);
 }
 
+
+bool CSerialBuffer::isOpen() const
+{
+    return(m_serialPort->isOpen());
+}
+
+
+/*!
+ * @brief sets the parameters the port is opened with
+ *
+ * A coarse timer may fire 5% early or late, so in real-time mode the
+ * timeouts and backoffs of the transactions run on a precise timer.
+ *
+ * @param[in] link - the parameters
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::setLinkParameters(const CLinkParameters &link)
+{
+    m_link = link;
+    m_txTimer.setTimerType(m_link.m_preciseTimers ? Qt::PreciseTimer : Qt::CoarseTimer);
+}
+
+
+/*!
+ * @brief checks the link with several echoes
+ *
+ * @return true if all LINK_CHECKS echoes came back
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::checkLink()
+{
+    for (int i=0; i<LINK_CHECKS; i++)
+    {
+        if (!checkForEcho())
+        {
+            return(false);
+        }
+    }
+    return(true);
+}
+
+
+/*!
+ * @brief switches the controller and the port to another baud rate
+ *
+ * The command is sent at the current rate; the controller is assumed to
+ * change its rate once the command has been echoed.  If the link does not
+ * work at the new rate, the command for the old rate is sent at the new
+ * rate and the port goes back to the old rate, so a rate the adapter or
+ * the cable cannot carry never loses the controller.
+ *
+ * @param[in] commandFormat - command with %1 for the rate, e.g. "baud=%1"
+ * @param[in] rate - the new rate
+ * @return true if the link works at the new rate
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::changeBaudRate(const QString &commandFormat, qint32 rate)
+{
+    if (!m_serialPort->isOpen())
+    {
+        return(false);
+    }
+
+    qint32 previous = m_baudRate;
+    if (rate == previous)
+    {
+        return(true);
+    }
+
+    //
+    // The echo of the command may already be at the new rate, so it is
+    // neither checked nor retried.
+    //
+    int received;
+    sendCommand(commandFormat.arg(rate).toLocal8Bit().data(), &received);
+    m_serialPort->flush();
+    snooze(LINK_BAUD_SETTLE_MS);
+    setPortBaudRate(rate);
+    if (checkLink())
+    {
+        return(true);
+    }
+
+    //
+    // Fall back
+    //
+    sendCommand(commandFormat.arg(previous).toLocal8Bit().data(), &received);
+    m_serialPort->flush();
+    snooze(LINK_BAUD_SETTLE_MS);
+    setPortBaudRate(previous);
+    checkLink();
+    return(false);
+}
+
+
+/*!
+ * @brief switches the port to another baud rate, without telling the controller
+ *
+ * Data pending in either direction was sent or is read at the old rate, so
+ * it is discarded.
+ *
+ * @param[in] rate - the new rate
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::setPortBaudRate(qint32 rate)
+{
+    m_serialPort->setBaudRate(rate);
+    m_serialPort->clear();
+    m_baudRate = rate;
+}
+
+
+/*!
+ * @brief measures the round trip time and the throughput at the current rate
+ *
+ * Each round is an echo check, timed for the round trip, and a "version"
+ * command, timed from the write to the last response line for the bytes
+ * received per second.  The flush before each command is not counted.
+ *
+ * @param[in] rounds - number of rounds
+ * @return the measurements
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CLinkThroughput CSerialBuffer::measureThroughput(int rounds)
+{
+    CLinkThroughput throughput;
+    throughput.m_baudRate = m_baudRate;
+    throughput.m_rounds = rounds;
+
+    qint64 rttNs = 0;
+    int echoes = 0;
+    qint64 bytes = 0;
+    qint64 transferNs = 0;
+    for (int i=0; i<rounds; i++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        if (!checkForEcho())
+        {
+            throughput.m_failures++;
+            continue;
+        }
+        rttNs += timer.nsecsElapsed();
+        echoes++;
+
+        if (!writeLine("version"))
+        {
+            throughput.m_failures++;
+            continue;
+        }
+        qint64 received = strlen("version") + 2;
+        for (int line=0; line<3; line++)
+        {
+            received += readString().length();
+        }
+        bytes += received;
+        transferNs += m_commandTimer.nsecsElapsed();
+    }
+
+    if (echoes > 0)
+    {
+        throughput.m_rttMs = rttNs / 1e6 / echoes;
+    }
+    if (transferNs > 0)
+    {
+        throughput.m_bytesPerSecond = bytes * 1e9 / transferNs;
+    }
+    return(throughput);
+}
+
+
 #if 0
 /*!
  * @brief sleeps for specified milliseconds
@@ -88,7 +456,18 @@ void CSerialBuffer::snooze(int ms)
 
 void CSerialBuffer::flush()
 {
-    m_serialPort->clear();
+    //
+    // Anything still pending before a command is counted as garbage
+    //
+    if (m_eventFilter)
+    {
+        drainEvents();
+    }
+    else
+    {
+        countLink(CMetrics::Link_GarbageBytes, m_serialPort->bytesAvailable());
+        m_serialPort->clear();
+    }
     const int bufferSize = 1024;
     char buffer[bufferSize];
     snooze(1);
@@ -96,7 +475,9 @@ void CSerialBuffer::flush()
     int ticks = 0;
     while (ticks < 10)
     {
-        if (readLine(buffer, bufferSize, 1) == 0)
+        bool line = readLine(buffer, bufferSize, 1);
+        countLink(CMetrics::Link_GarbageBytes, strlen(buffer));
+        if (!line)
         {
             snooze(1);
             ticks++;
@@ -117,13 +498,24 @@ bool CSerialBuffer::checkForEcho()
     }
 
     //
-    // Flush the incoming data.
+    // Flush the incoming data, passing any complete events on first.
     //
-    m_serialPort->clear();
+    if (m_eventFilter)
+    {
+        drainEvents();
+    }
+    else
+    {
+        countLink(CMetrics::Link_GarbageBytes, m_serialPort->bytesAvailable());
+        m_serialPort->clear();
+    }
 
     //
     // Write a new-line
     //
+    m_command = CMetrics::Command_Echo;
+    m_awaitingResponse = false;
+    m_commandTimer.start();
     if (m_serialPort->write("\n") == 0)
     {
         return(false);
@@ -134,10 +526,25 @@ bool CSerialBuffer::checkForEcho()
     //
     char buffer[3];
     buffer[0] = '\0';
-    if ( (readLine(buffer, 3, m_timeoutMS) == false) || (buffer[0] != '\r') )
+    bool echoed = readLine(buffer, 3, m_timeoutMS);
+    if (m_trace)
     {
+        m_trace->command(QByteArray(), echoed && (buffer[0] == '\r'), m_commandTimer.elapsed());
+    }
+    if (!echoed)
+    {
+        CMetrics::instance()->countTimeout(m_command);
+        countLink(CMetrics::Link_Timeouts, 1);
+        countLink(CMetrics::Link_GarbageBytes, strlen(buffer));
         return(false);
     }
+    if (buffer[0] != '\r')
+    {
+        CMetrics::instance()->countEchoMismatch(m_command);
+        countLink(CMetrics::Link_GarbageBytes, strlen(buffer));
+        return(false);
+    }
+    CMetrics::instance()->observeRoundTrip(m_command, CMetrics::Stage_Echo, m_commandTimer.elapsed());
 
     return(true);
 }
@@ -146,6 +553,10 @@ bool CSerialBuffer::checkForEcho()
 /*!
  * @brief Write a command to the device.
  *
+ * A command whose echo is lost or garbled is sent again, up to the
+ * configured number of retries with a doubling wait, if its retry rule
+ * allows it.
+ *
  * @param[in] command - string to be sent to device
  * @return true if write is successful, false otherwise
  *
@@ -153,9 +564,173 @@ bool CSerialBuffer::checkForEcho()
  * @date 01/13/2015
 */
 bool CSerialBuffer::writeLine(const char *command)
+{
+    for (int attempt=0; ; attempt++)
+    {
+        int received = 0;
+        if (sendCommand(command, &received))
+        {
+            return(true);
+        }
+        if (!retryAllowed(command, attempt, received))
+        {
+            return(false);
+        }
+    }
+}
+
+
+/*!
+ * @brief writes a command without waiting for its echo
+ *
+ * For commands whose echo can not be relied on, such as a change of the
+ * baud rate, and for the last commands before the port is closed.  The
+ * echo is left in the port and taken out as garbage by the next command.
+ *
+ * @param[in] command - string to be sent to device
+ * @return false if the port is not open or the command could not be written
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::writeCommand(const QString &command)
+{
+    if (!m_serialPort->isOpen())
+    {
+        return(false);
+    }
+
+    QByteArray data = command.toLocal8Bit();
+    m_command = CMetrics::commandIndex(data.constData());
+    m_awaitingResponse = false;
+    m_commandTimer.start();
+    if (m_trace)
+    {
+        m_trace->command(data, false, 0);
+    }
+    data.append('\n');
+    if (m_serialPort->write(data) < data.size())
+    {
+        return(false);
+    }
+    m_serialPort->flush();
+    return(true);
+}
+
+
+/*!
+ * @brief decides whether a failed transaction is retried, and waits if so
+ *
+ * @param[in] command - the command
+ * @param[in] attempt - number of the attempt that failed, 0 for the first
+ * @param[in] received - bytes that came back for the failed attempt
+ * @return true if the command should be sent again
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::retryAllowed(const char *command, int attempt, int received)
+{
+    if (!mayRetry(command, attempt, received))
+    {
+        return(false);
+    }
+    snooze(retryBackoff(attempt));
+    return(true);
+}
+
+
+/*!
+ * @brief decides whether a failed transaction is retried, without waiting
+ *
+ * A retry that is allowed is counted.
+ *
+ * @param[in] command - the command
+ * @param[in] attempt - number of the attempt that failed, 0 for the first
+ * @param[in] received - bytes that came back for the failed attempt
+ * @return true if the command should be sent again
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::mayRetry(const char *command, int attempt, int received)
+{
+    if ((attempt >= m_link.m_retries) || !m_serialPort->isOpen())
+    {
+        return(false);
+    }
+
+    RetryRule rule = Retry_Always;
+    for (size_t i=0; i<sizeof(c_retryRules)/sizeof(c_retryRules[0]); i++)
+    {
+        if (strncmp(command, c_retryRules[i].m_prefix, strlen(c_retryRules[i].m_prefix)) == 0)
+        {
+            rule = c_retryRules[i].m_rule;
+            break;
+        }
+    }
+    if ((rule == Retry_Never) || ((rule == Retry_IfNotReceived) && (received > 0)))
+    {
+        return(false);
+    }
+
+    countLink(CMetrics::Link_Retries, 1);
+    return(true);
+}
+
+
+int CSerialBuffer::retryBackoff(int attempt) const
+{
+    return(qMin(m_link.m_retryBackoffMS << qMin(attempt, 8), c_maxBackoffMS));
+}
+
+
+/*!
+ * @brief adds to a link quality counter of this port
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::countLink(int counter, qint64 n)
+{
+    if (n <= 0)
+    {
+        return;
+    }
+    switch (counter)
+    {
+    case CMetrics::Link_Retries:
+        m_quality.m_retries += n;
+        break;
+    case CMetrics::Link_Timeouts:
+        m_quality.m_timeouts += n;
+        break;
+    default:
+        m_quality.m_garbageBytes += n;
+        break;
+    }
+    CMetrics::instance()->countLink(m_portName, counter, n);
+}
+
+
+/*!
+ * @brief writes a command once and checks its echo
+ *
+ * With retries enabled the echo is given the short echo timeout, so a
+ * lost echo is retried quickly; a response can take much longer.
+ *
+ * @param[in] command - string to be sent to device
+ * @param[out] received - number of bytes that came back as the echo
+ * @return true if the command was echoed correctly
+ *
+ * @author J. Peterson
+ * @date 01/13/2015
+*/
+bool CSerialBuffer::sendCommand(const char *command, int *received)
 {
     int bytesWritten = 0;
     int commandLength = strlen(command);
+    *received = 0;
 
     //
     // Check that the port is open
@@ -173,6 +748,9 @@ bool CSerialBuffer::writeLine(const char *command)
     //
     // Write the command.
     //
+    m_command = CMetrics::commandIndex(command);
+    m_awaitingResponse = false;
+    m_commandTimer.start();
     bytesWritten += m_serialPort->write(command);
     m_serialPort->write("\n");
 
@@ -189,12 +767,29 @@ bool CSerialBuffer::writeLine(const char *command)
     //
     // Check that the echoed data is the same as the command sent.
     //
+    int echoTimeoutMS = (m_link.m_retries > 0) ? qMin(m_link.m_echoTimeoutMS, m_timeoutMS) : m_timeoutMS;
     char *buffer = new char[commandLength+100];
     if (buffer)
     {
-        readLine(buffer, commandLength+100, m_timeoutMS);
-        if (strncmp(command, buffer, commandLength) != 0)
+        bool echoed = readLine(buffer, commandLength+100, echoTimeoutMS);
+        *received = strlen(buffer);
+        bool matched = (strncmp(command, buffer, commandLength) == 0);
+        if (m_trace)
         {
+            m_trace->command(command, echoed && matched, m_commandTimer.elapsed());
+        }
+        if (!echoed)
+        {
+            CMetrics::instance()->countTimeout(m_command);
+            countLink(CMetrics::Link_Timeouts, 1);
+        }
+        if (!matched)
+        {
+            if (echoed)
+            {
+                CMetrics::instance()->countEchoMismatch(m_command);
+            }
+            countLink(CMetrics::Link_GarbageBytes, *received);
             //QString title = "Debug";
             //QString msg = "Unexpected response:\n";
             //msg.append(buffer);
@@ -206,6 +801,8 @@ bool CSerialBuffer::writeLine(const char *command)
             return(false);
         }
         delete buffer;
+        CMetrics::instance()->observeRoundTrip(m_command, CMetrics::Stage_Echo, m_commandTimer.elapsed());
+        m_awaitingResponse = true;
     }
 
     return(true);
@@ -249,6 +846,12 @@ bool CSerialBuffer::readLine(char *buffer, int bufferSize, int timeoutMS)
             buffer[index] = '\0';
             if (buffer[index-1] == '\n')
             {
+                if (isEvent(buffer))
+                {
+                    index = 0;
+                    buffer[index] = '\0';
+                    continue;
+                }
                 break;
             }
         }
@@ -264,6 +867,48 @@ bool CSerialBuffer::readLine(char *buffer, int bufferSize, int timeoutMS)
 }
 
 
+/*!
+ * @brief hands the complete lines waiting in the port to the event filter
+ *
+ * Used while no command is in progress.  Lines the filter does not take
+ * are unsolicited output of no interest and are dropped.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::drainEvents()
+{
+    if (!m_serialPort->isOpen())
+    {
+        return;
+    }
+
+    while (m_serialPort->canReadLine())
+    {
+        QByteArray line = m_serialPort->readLine();
+        if (!m_eventFilter || !m_eventFilter->filterLine(QString::fromLatin1(line).trimmed()))
+        {
+            countLink(CMetrics::Link_GarbageBytes, line.size());
+        }
+    }
+}
+
+
+/*!
+ * @brief passes a complete line to the event filter
+ *
+ * @param[in] line - the line, including the terminator
+ * @return true if the line was an event and must be skipped
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::isEvent(const char *line)
+{
+    return(m_eventFilter && m_eventFilter->filterLine(QString::fromLatin1(line).trimmed()));
+}
+
+
 QString CSerialBuffer::readString()
 {
     const int bufferSize = 1024;
@@ -282,6 +927,7 @@ QString CSerialBuffer::readString()
     //
     if (!m_serialPort->isOpen())
     {
+        m_timedOut = true;
         return(str);
     }
 
@@ -293,6 +939,12 @@ QString CSerialBuffer::readString()
             buffer[index] = '\0';
             if (buffer[index-1] == '\n')
             {
+                if (isEvent(buffer))
+                {
+                    index = 0;
+                    buffer[index] = '\0';
+                    continue;
+                }
                 break;
             }
         }
@@ -304,8 +956,286 @@ QString CSerialBuffer::readString()
         }
     }
 
+    m_timedOut = (tickCount >= m_timeoutMS);
+    if (m_timedOut)
+    {
+        CMetrics::instance()->countTimeout(m_command);
+        countLink(CMetrics::Link_Timeouts, 1);
+    }
+    else if (m_awaitingResponse)
+    {
+        CMetrics::instance()->observeRoundTrip(m_command, CMetrics::Stage_Response, m_commandTimer.elapsed());
+    }
+    m_awaitingResponse = false;
+    if (m_trace)
+    {
+        m_trace->response(buffer, !m_timedOut, m_commandTimer.elapsed());
+    }
+
     str.append(buffer);
 
     return (str);
 }
 
+
+/*!
+ * @brief sends a command and collects its response without waiting
+ *
+ * transactionFinished() is emitted with the response lines once the echo
+ * and responseLines lines have arrived, or with ok false when the port is
+ * closed or the echo or a response line timed out.  Failed attempts are
+ * retried by the same rules as writeLine(); the backoff runs on a timer.
+ * The signal is never emitted from within this call.
+ *
+ * Lines that come in before the echo are left over from an earlier
+ * command and are skipped, as flush() would have discarded them.  Event
+ * lines go to the event filter.
+ *
+ * @param[in] command - command to send, empty for a bare echo check
+ * @param[in] responseLines - number of response lines to wait for after the echo
+ * @return false if another transaction is still in progress
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSerialBuffer::startTransaction(const QString &command, int responseLines)
+{
+    if (m_txState != Tx_Idle)
+    {
+        return(false);
+    }
+
+    m_txCommand = command.toLocal8Bit();
+    m_txLines = responseLines;
+    m_txAttempt = 0;
+    sendTransaction();
+    return(true);
+}
+
+
+/*!
+ * @brief abandons the transaction in progress, transactionFinished() is not emitted
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::cancelTransaction()
+{
+    m_txTimer.stop();
+    m_txState = Tx_Idle;
+    m_awaitingResponse = false;
+}
+
+
+/*!
+ * @brief sends the command of the transaction, for the first time or again
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::sendTransaction()
+{
+    m_txResponse.clear();
+    m_txReceived = 0;
+    if (!m_serialPort->isOpen())
+    {
+        m_txState = Tx_Failed;
+        m_txTimer.start(0);
+        return;
+    }
+
+    //
+    // Take out what is pending, as flush() does, but without waiting for
+    // the line to go quiet
+    //
+    if (m_eventFilter)
+    {
+        drainEvents();
+    }
+    else
+    {
+        countLink(CMetrics::Link_GarbageBytes, m_serialPort->bytesAvailable());
+        m_serialPort->clear();
+    }
+
+    m_command = m_txCommand.isEmpty() ? (int)CMetrics::Command_Echo : CMetrics::commandIndex(m_txCommand.constData());
+    m_awaitingResponse = false;
+    m_commandTimer.start();
+    if (    (m_serialPort->write(m_txCommand) < m_txCommand.size())
+         || (m_serialPort->write("\n") != 1) )
+    {
+        m_txState = Tx_Failed;
+        m_txTimer.start(0);
+        return;
+    }
+
+    m_txState = Tx_Echo;
+    m_txTimer.start((m_link.m_retries > 0) ? qMin(m_link.m_echoTimeoutMS, m_timeoutMS) : m_timeoutMS);
+}
+
+
+/*!
+ * @brief takes the complete lines that arrived into the transaction
+ *
+ * While no transaction is in progress the data is left for the blocking
+ * calls, unless event notification is on; then the events are handed to
+ * the filter as they arrive and eventsReceived() is emitted.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::onReadyRead()
+{
+    if ((m_txState != Tx_Echo) && (m_txState != Tx_Response))
+    {
+        if ((m_txState == Tx_Idle) && m_notifyEvents && m_eventFilter)
+        {
+            drainEvents();
+            emit eventsReceived();
+        }
+        return;
+    }
+
+    while (m_serialPort->canReadLine())
+    {
+        QByteArray line = m_serialPort->readLine();
+        if (isEvent(line.constData()))
+        {
+            continue;
+        }
+        m_txReceived += line.size();
+
+        if (m_txState == Tx_Echo)
+        {
+            bool echoed = m_txCommand.isEmpty() ? line.startsWith('\r') || (line == "\n")
+                                                : line.startsWith(m_txCommand);
+            if (!echoed)
+            {
+                countLink(CMetrics::Link_GarbageBytes, line.size());
+                continue;
+            }
+            CMetrics::instance()->observeRoundTrip(m_command, CMetrics::Stage_Echo, m_commandTimer.elapsed());
+            if (m_trace)
+            {
+                m_trace->command(m_txCommand, true, m_commandTimer.elapsed());
+            }
+            if (m_txLines == 0)
+            {
+                finishTransaction(true);
+                return;
+            }
+            m_awaitingResponse = true;
+            m_txState = Tx_Response;
+            continue;
+        }
+
+        if (m_awaitingResponse)
+        {
+            CMetrics::instance()->observeRoundTrip(m_command, CMetrics::Stage_Response, m_commandTimer.elapsed());
+            m_awaitingResponse = false;
+        }
+        if (m_trace)
+        {
+            m_trace->response(line, true, m_commandTimer.elapsed());
+        }
+        m_txResponse.append(QString::fromLatin1(line));
+        if (m_txResponse.size() >= m_txLines)
+        {
+            finishTransaction(true);
+            return;
+        }
+    }
+
+    //
+    // The timeouts run from the last data received, as in readLine()
+    //
+    m_txTimer.start((m_txState == Tx_Echo) && (m_link.m_retries > 0) ? qMin(m_link.m_echoTimeoutMS, m_timeoutMS)
+                                                                        : m_timeoutMS);
+}
+
+
+/*!
+ * @brief handles a timeout or the end of a backoff of the transaction
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::onTransactionTimer()
+{
+    switch (m_txState)
+    {
+    case Tx_Failed:
+        if (m_trace)
+        {
+            m_trace->command(m_txCommand, false, m_commandTimer.elapsed());
+        }
+        finishTransaction(false);
+        break;
+
+    case Tx_Backoff:
+        sendTransaction();
+        break;
+
+    case Tx_Echo:
+        CMetrics::instance()->countTimeout(m_command);
+        countLink(CMetrics::Link_Timeouts, 1);
+        if (m_trace)
+        {
+            m_trace->command(m_txCommand, false, m_commandTimer.elapsed());
+        }
+        //
+        // A garbled echo was already taken out as garbage, but it still
+        // shows the controller saw the command
+        //
+        retryTransaction(m_txReceived + m_serialPort->bytesAvailable());
+        break;
+
+    case Tx_Response:
+        CMetrics::instance()->countTimeout(m_command);
+        countLink(CMetrics::Link_Timeouts, 1);
+        if (m_trace)
+        {
+            m_trace->response(QByteArray(), false, m_commandTimer.elapsed());
+        }
+        retryTransaction(1);
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/*!
+ * @brief sends the command again after the backoff, or fails the transaction
+ *
+ * @param[in] received - bytes that came back for the failed attempt
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialBuffer::retryTransaction(int received)
+{
+    if (!mayRetry(m_txCommand.constData(), m_txAttempt, received))
+    {
+        finishTransaction(false);
+        return;
+    }
+    m_txState = Tx_Backoff;
+    m_txTimer.start(retryBackoff(m_txAttempt));
+    m_txAttempt++;
+}
+
+
+void CSerialBuffer::finishTransaction(bool ok)
+{
+    m_txTimer.stop();
+    m_txState = Tx_Idle;
+    m_awaitingResponse = false;
+
+    //
+    // The receiver may start the next transaction from the signal
+    //
+    QStringList lines = m_txResponse;
+    emit transactionFinished(ok, lines);
+}
@@ -1,31 +1,186 @@
+#ifndef SERIALBUFFER_H
+#define SERIALBUFFER_H
+
 #include <QSerialPort>
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QTimer>
+
+class CSettings;
+class CTraceWriter;
 
 #define INPUT_BUFFER_SIZE
 
-class CSerialBuffer : QObject
+#define LINK_BAUD_SETTLE_MS     50      // time the controller is given to switch to a new baud rate
+#define LINK_CHECKS             3       // echo checks that must pass before a link is trusted
+
+/*!
+ * Receives the lines read from the controller before the command/response
+ * code sees them, so unsolicited event lines can be taken out of the data.
+ */
+class CSerialEventFilter
+{
+public:
+    virtual ~CSerialEventFilter() {}
+
+    //! returns true if the line was an event and must not be returned to the reader
+    virtual bool filterLine(const QString &line) = 0;
+};
+
+/*!
+ * Framing and speed of the serial link
+ */
+class CLinkParameters
+{
+public:
+    CLinkParameters();
+    static CLinkParameters fromSettings(const CSettings *settings);
+    static QList<qint32> fastRates(const CSettings *settings);
+
+public:
+    qint32                   m_baudRate;
+    QSerialPort::DataBits    m_dataBits;
+    QSerialPort::Parity      m_parity;
+    QSerialPort::StopBits    m_stopBits;
+    QSerialPort::FlowControl m_flowControl;
+    int                      m_retries;         // retries of a failed transaction
+    int                      m_retryBackoffMS;  // wait before the first retry, doubled per retry
+    int                      m_echoTimeoutMS;   // timeout of an echo when retries are enabled
+    bool                     m_preciseTimers;   // time the transactions with precise timers, in real-time mode
+};
+
+
+/*!
+ * Link quality counters of one port since it was first opened
+ */
+class CLinkQuality
+{
+public:
+    CLinkQuality();
+
+public:
+    qint64  m_retries;
+    qint64  m_timeouts;
+    qint64  m_garbageBytes;
+};
+
+
+/*!
+ * Result of a throughput test of the link
+ */
+class CLinkThroughput
+{
+public:
+    CLinkThroughput();
+
+public:
+    qint32  m_baudRate;
+    int     m_rounds;           // transactions attempted
+    int     m_failures;         // transactions that timed out or were garbled
+    double  m_rttMs;            // mean time from a new-line to its echo
+    double  m_bytesPerSecond;   // bytes received per second while a response was due
+};
+
+
+/*!
+ * Command/response access to the controller on one serial port.
+ *
+ * The blocking calls (writeLine(), readString(), ...) wait for their data
+ * in place.  startTransaction() does the same exchange without waiting: it
+ * returns at once and transactionFinished() is emitted when the echo and
+ * the response lines have arrived, or when they did not.  Only one
+ * transaction can be in progress, and the blocking calls must not be used
+ * while it is.
+ */
+class CSerialBuffer : public QObject
 {
     Q_OBJECT
 
 public:
-    CSerialBuffer();
+    CSerialBuffer(QObject *parent = 0);
     ~CSerialBuffer();
 
 public:
     bool openPort(QString serialPort);
+    bool isOpen() const;
+    void setLinkParameters(const CLinkParameters &link);
+    qint32 baudRate() const { return(m_baudRate); }
+    bool changeBaudRate(const QString &commandFormat, qint32 rate);
+    void setPortBaudRate(qint32 rate);
+    CLinkThroughput measureThroughput(int rounds);
+    const CLinkQuality &linkQuality() const { return(m_quality); }
     bool checkForEcho();
     void flush();
     bool writeLine(const char *command);
+    bool writeCommand(const QString &command);
     bool readLine(char *buffer, int bufferSize, int timeoutMS);
     QString readString();
+    void setTimeout(int timeoutMS) { m_timeoutMS = timeoutMS; }
+    void setEventFilter(CSerialEventFilter *filter) { m_eventFilter = filter; }
+    void drainEvents();
+    bool startTransaction(const QString &command, int responseLines);
+    void cancelTransaction();
+    bool transactionPending() const { return(m_txState != Tx_Idle); }
+    void setEventNotification(bool on) { m_notifyEvents = on; }
+    void setTrace(CTraceWriter *trace) { m_trace = trace; }
 
+signals:
+    void transactionFinished(bool ok, QStringList lines);
+    void eventsReceived();
+
+private slots:
+    void onReadyRead();
+    void onTransactionTimer();
 
 private:
+    bool isEvent(const char *line);
+    bool checkLink();
+    bool sendCommand(const char *command, int *received);
+    bool retryAllowed(const char *command, int attempt, int received);
+    bool mayRetry(const char *command, int attempt, int received);
+    int  retryBackoff(int attempt) const;
+    void sendTransaction();
+    void retryTransaction(int received);
+    void finishTransaction(bool ok);
+    void countLink(int counter, qint64 n);
 #if 0
     void snooze(int ms);
 #endif
 
+private:
+    //! progress of the transaction started by startTransaction()
+    enum TransactionState
+    {
+        Tx_Idle,
+        Tx_Failed,          // could not be sent, finishes on the next timer tick
+        Tx_Backoff,         // waiting to be sent again
+        Tx_Echo,            // sent, waiting for the echo
+        Tx_Response         // echoed, waiting for the response lines
+    };
+
 private:
     QSerialPort   *m_serialPort;
     int            m_timeoutMS;
+    int            m_command;           // CMetrics series of the last command sent
+    bool           m_awaitingResponse;  // no response line read since the command was sent
+    QElapsedTimer  m_commandTimer;      // started when the last command was sent
+    CSerialEventFilter *m_eventFilter;  // gets every line read first, 0 if none
+    CLinkParameters m_link;             // parameters the port is opened with
+    QString        m_portName;          // port of the last openPort()
+    qint32         m_baudRate;          // rate the controller was last set to
+    CLinkQuality   m_quality;           // counters of this port
+    bool           m_timedOut;          // the last readString() timed out
+    CTraceWriter  *m_trace;             // gets the commands and responses, 0 if none
+
+    TransactionState m_txState;
+    QByteArray     m_txCommand;         // command of the transaction
+    int            m_txLines;           // response lines expected after the echo
+    int            m_txAttempt;         // number of the attempt in progress, 0 for the first
+    int            m_txReceived;        // bytes other than events received for the attempt in progress
+    QStringList    m_txResponse;        // response lines received so far
+    QTimer         m_txTimer;           // timeout of the echo or response, or the retry backoff; child, so it moves with the buffer
+    bool           m_notifyEvents;      // drain events as they arrive while no transaction is in progress
 };
 
+#endif // SERIALBUFFER_H
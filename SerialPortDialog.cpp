@@ -3,6 +3,11 @@
  * @brief Implements a dialog box for selecting COM ports
  *
  * When created this dialog populates a ComboBox with the available COM ports.
+ * Every port is probed for a controller in a thread of its own, so all
+ * ports are identified in about the time of one probe, and each entry is
+ * labelled with the firmware versions of the controller it found.  The
+ * list of ports is rescanned once a second to pick up adapters that are
+ * plugged in or removed while the dialog is open.
  *
  * @author    	J. Peterson
  * @date        01/12/2015
@@ -13,12 +18,27 @@
  *  Version | Author       | Date        | Description
  *  :--:    | :-----       | :--:        | :----------
  *   1      | J. Peterson  | 01/12/2015  | initial version
+ *   2      | agent        | 10/18/2026  | ports probed in parallel and labelled, hotplug
  *
 */
 
 #include <QSerialPortInfo>
+#include <QThread>
 #include "serialportdialog.h"
 #include "ui_SerialPortDialog.h"
+#include "PortProbe.h"
+
+//
+// Timeout of the echo and version reads of a probe.  A controller answers
+// within a few ms; a port with nothing attached costs this much.
+//
+const int c_probeTimeoutMS = 300;
+
+//
+// Interval between scans for added or removed ports
+//
+const int c_hotplugMS = 1000;
+
 
 /*!
  * @brief constructor
@@ -37,12 +57,18 @@ CSerialPortDialog::CSerialPortDialog(QWidget *parent) :
 
     ui->setupUi(this);
     ui->label_Instructions->setWordWrap(true);
+    m_userSelected = false;
+    connect(ui->comboBox_serialPorts, SIGNAL(activated(int)), this, SLOT(onUserSelection(int)));
     refreshSerialPortList();
+    m_timerID = startTimer(c_hotplugMS);
 }
 
 /*!
  * @brief destructor
  *
+ * Waits for the probes that are still running; each ends within a few
+ * probe timeouts.
+ *
  * @param[in] none
  * @param[out] none
  * @return none
@@ -52,12 +78,19 @@ CSerialPortDialog::CSerialPortDialog(QWidget *parent) :
 */
 CSerialPortDialog::~CSerialPortDialog()
 {
+    killTimer(m_timerID);
+    for (int i=0; i<m_threads.size(); i++)
+    {
+        m_threads[i]->wait();
+    }
     delete ui;
 }
 
 
 /*!
- * @brief initializes the Combo-Box with the available comm ports
+ * @brief probes all ports again
+ *
+ * Called when the Refresh button is pressed.
  *
  * @param[in] none
  * @param[out] none
@@ -67,19 +100,171 @@ CSerialPortDialog::~CSerialPortDialog()
  * @date 01/12/2015
 */
 void CSerialPortDialog::refreshSerialPortList()
+{
+    updatePortList(true);
+}
+
+
+/*!
+ * @brief hotplug scan
+ *
+ * Listing the ports does not open them, so this is cheap enough for a
+ * timer; only ports that appeared since the last scan are probed.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialPortDialog::timerEvent(QTimerEvent *)
+{
+    updatePortList(false);
+}
+
+
+/*!
+ * @brief rescans the ports and starts the probes
+ *
+ * @param[in] reprobe - true to probe every port, false for new ports only
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialPortDialog::updatePortList(bool reprobe)
+{
+    QStringList ports;
+    QList<QSerialPortInfo> commPortList = QSerialPortInfo::availablePorts();
+    for (int i=0; i<commPortList.size(); i++)
+    {
+        ports.append(commPortList[i].portName());
+    }
+
+    if (!reprobe && (ports == m_ports))
+    {
+        return;
+    }
+
+    for (int i=0; i<m_ports.size(); i++)
+    {
+        if (!ports.contains(m_ports[i]))
+        {
+            m_labels.remove(m_ports[i]);
+            m_controllers.remove(m_ports[i]);
+        }
+    }
+    m_ports = ports;
+
+    for (int i=0; i<m_ports.size(); i++)
+    {
+        if (    (reprobe || !m_labels.contains(m_ports[i]))
+             && !m_probing.contains(m_ports[i]) )
+        {
+            startProbe(m_ports[i]);
+        }
+    }
+
+    fillComboBox();
+}
+
+
+/*!
+ * @brief probes one port in a thread of its own
+ *
+ * @param[in] portName - the port
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialPortDialog::startProbe(QString portName)
+{
+    m_labels[portName] = "(probing...)";
+    m_controllers.remove(portName);
+    m_probing.append(portName);
+
+    QThread *thread = new QThread(this);
+    CPortProbe *probe = new CPortProbe(portName, c_probeTimeoutMS);
+    probe->moveToThread(thread);
+    connect(thread, SIGNAL(started()), probe, SLOT(probe()));
+    connect(probe, SIGNAL(probed(QString,int,QString,QString,QString)),
+            this, SLOT(onProbed(QString,int,QString,QString,QString)));
+    connect(probe, SIGNAL(probed(QString,int,QString,QString,QString)), thread, SLOT(quit()));
+    connect(thread, SIGNAL(finished()), probe, SLOT(deleteLater()));
+    m_threads.append(thread);
+    thread->start();
+}
+
+
+/*!
+ * @brief labels a port with the outcome of its probe
+ *
+ * When all probes are done and exactly one controller was found, it is
+ * selected, unless the operator already picked a port.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSerialPortDialog::onProbed(QString portName, int state, QString arm, QString dsp, QString fpga)
+{
+    m_probing.removeAll(portName);
+    if (!m_ports.contains(portName))
+    {
+        return;
+    }
+
+    switch (state)
+    {
+    case CPortProbe::Probe_Controller:
+        m_controllers[portName] = QString("ARM %1, DSP %2, FPGA %3").arg(arm).arg(dsp).arg(fpga);
+        m_labels[portName] = "(" + m_controllers[portName] + ")";
+        break;
+    case CPortProbe::Probe_Unavailable:
+        m_labels[portName] = "(in use)";
+        break;
+    default:
+        m_labels[portName] = "(no controller)";
+        break;
+    }
+    fillComboBox();
+
+    if (!m_userSelected && m_probing.isEmpty() && (m_controllers.size() == 1))
+    {
+        int index = ui->comboBox_serialPorts->findData(m_controllers.firstKey());
+        if (index >= 0)
+        {
+            ui->comboBox_serialPorts->setCurrentIndex(index);
+        }
+    }
+}
+
+
+void CSerialPortDialog::onUserSelection(int)
+{
+    m_userSelected = true;
+}
+
+
+/*!
+ * @brief initializes the Combo-Box with the available comm ports
+ *
+ * The port name is kept as the item data; the text adds the label.
+ *
+ * @param[in] none
+ * @param[out] none
+ * @return none
+ *
+ * @author J. Peterson
+ * @date 01/12/2015
+*/
+void CSerialPortDialog::fillComboBox()
 {
     QString currentSelection = getSelection();
     int currentIndex = 0;
 
     ui->comboBox_serialPorts->clear();
-    QList<QSerialPortInfo> commPortList = QSerialPortInfo::availablePorts();
     ui->comboBox_serialPorts->setEnabled(false);
-    ui->comboBox_serialPorts->addItem("<select>");
-    for (int i=0; i<commPortList.size(); i++)
+    ui->comboBox_serialPorts->addItem("<select>", QString());
+    for (int i=0; i<m_ports.size(); i++)
     {
-        QSerialPortInfo portInfo = commPortList[i];
-        ui->comboBox_serialPorts->addItem(portInfo.portName());
-        if (currentSelection == portInfo.portName())
+        ui->comboBox_serialPorts->addItem(m_ports[i] + "  " + m_labels.value(m_ports[i]), m_ports[i]);
+        if (currentSelection == m_ports[i])
         {
             currentIndex = i + 1;
         }
@@ -101,11 +286,10 @@ void CSerialPortDialog::refreshSerialPortList()
 */
 QString CSerialPortDialog::getSelection()
 {
-    QString name = ui->comboBox_serialPorts->currentText();
-    if (name == "<select>")
+    int index = ui->comboBox_serialPorts->currentIndex();
+    if (index < 0)
     {
-        name = "";
+        return(QString());
     }
-    return(name);
+    return(ui->comboBox_serialPorts->itemData(index).toString());
 }
-
@@ -11,10 +11,18 @@
  *  Version | Author       | Date        | Description
  *  :--:    | :-----       | :--:        | :----------
  *   1      | J. Peterson  | 01/23/2015  | initial version
+ *   2      | agent        | 10/18/2026  | calibration profiles, reloaded when the ini file changes
+ *   3      | agent        | 10/18/2026  | number of LED channels in the profile
+ *   4      | agent        | 10/18/2026  | controller protocol
+ *   5      | agent        | 10/18/2026  | verification of the saved calibration in the profile
+ *   6      | agent        | 10/18/2026  | binary trace file
+ *   7      | agent        | 10/18/2026  | real-time mode of the serial timing
  *
 */
 
 #include "Settings.h"
+#include "LedChannels.h"
+#include <QFileInfo>
 
 //
 // INI file name
@@ -39,6 +47,248 @@ const char *c_VersionDSP_default  = "2.1.2250";
 const char *c_VersionFPGA_key     = "version/FPGA";
 const char *c_VersionFPGA_default = "2.02";
 
+const char *c_Protocol_key        = "version/protocol";
+const char *c_Protocol_default    = "auto";
+
+const char *c_ExposureFrames_key  = "exposure/frames";
+const int   c_ExposureFrames_default = 1;
+
+const char *c_StationPorts_key    = "stations/ports";
+
+const char *c_MaxParallelStations_key     = "stations/maxParallel";
+const int   c_MaxParallelStations_default = 0;
+
+const char *c_HistoryFile_key     = "history/file";
+const char *c_HistoryFile_default = "LED_cal_history.db";
+
+const char *c_TraceFile_key       = "trace/file";
+const char *c_TraceFile_default   = "";
+
+const char *c_FixtureName_key     = "fixture/name";
+const char *c_FixtureName_default = "";
+
+const char *c_MetricsFile_key     = "metrics/file";
+const char *c_MetricsFile_default = "";
+
+const char *c_MetricsSocket_key     = "metrics/socket";
+const char *c_MetricsSocket_default = "";
+
+const char *c_MetricsInterval_key     = "metrics/intervalMS";
+const int   c_MetricsInterval_default = 15000;
+
+const char *c_AutomationServer_key     = "automation/server";
+const char *c_AutomationServer_default = "LED_cal";
+
+const char *c_MonitorTick_key         = "monitor/tickMS";
+const int   c_MonitorTick_default     = 250;
+
+const char *c_MonitorVoltage_key      = "monitor/voltageMS";
+const int   c_MonitorVoltage_default  = 1000;
+
+const char *c_MonitorExposure_key     = "monitor/exposureMS";
+const int   c_MonitorExposure_default = 1000;
+
+const char *c_MonitorDac_key          = "monitor/dacMS";
+const int   c_MonitorDac_default      = 5000;
+
+const char *c_StreamEnabled_key       = "stream/enabled";
+const bool  c_StreamEnabled_default   = false;
+
+const char *c_StreamStart_key         = "stream/startCommands";
+const char *c_StreamStop_key          = "stream/stopCommands";
+
+const char *c_LinkBaudRate_key        = "link/baudRate";
+const int   c_LinkBaudRate_default    = 115200;
+
+const char *c_LinkDataBits_key        = "link/dataBits";
+const int   c_LinkDataBits_default    = 8;
+
+const char *c_LinkParity_key          = "link/parity";
+const char *c_LinkParity_default      = "none";
+
+const char *c_LinkStopBits_key        = "link/stopBits";
+const int   c_LinkStopBits_default    = 1;
+
+const char *c_LinkFlowControl_key     = "link/flowControl";
+const char *c_LinkFlowControl_default = "none";
+
+const char *c_LinkBaudCommand_key     = "link/baudCommand";
+const char *c_LinkBaudCommand_default = "";
+
+const char *c_LinkFastRates_key       = "link/fastRates";
+
+const char *c_LinkRetries_key         = "link/retries";
+const int   c_LinkRetries_default     = 3;
+
+const char *c_LinkRetryBackoff_key     = "link/retryBackoffMS";
+const int   c_LinkRetryBackoff_default = 10;
+
+const char *c_LinkEchoTimeout_key     = "link/echoTimeoutMS";
+const int   c_LinkEchoTimeout_default = 500;
+
+const char *c_RealTimeEnabled_key         = "realtime/enabled";
+const bool  c_RealTimeEnabled_default     = false;
+
+const char *c_RealTimePriority_key        = "realtime/priority";
+const int   c_RealTimePriority_default    = 20;
+
+const char *c_RealTimeCpu_key             = "realtime/cpu";
+const int   c_RealTimeCpu_default         = -1;
+
+const char *c_RealTimeLockMemory_key      = "realtime/lockMemory";
+const bool  c_RealTimeLockMemory_default  = true;
+
+const char *c_RealTimeTimerSlack_key      = "realtime/timerSlackNs";
+const int   c_RealTimeTimerSlack_default  = 1000;
+
+const char *c_ProfileName_key         = "calibration/profile";
+const char *c_ProfileName_default     = "default";
+
+//
+// Calibration profiles, each in a group "profile.<name>".  A key missing
+// from a profile takes the built-in value.
+//
+const char *c_ProfileGroup            = "profile.%1";
+const char *c_ProfileChannels_key     = "channels";
+const char *c_ProfileBatchHigh_key    = "batchHighSearch";
+const char *c_ProfileVerifySave_key   = "verifySave";
+const char *c_ProfileLowWindow_key    = "lowWindow";
+const char *c_ProfileHighWindow_key   = "highWindow";
+const char *c_ProfileCurrentLimit_key = "currentLimit";
+const char *c_ProfileDacSettle_key    = "dacSettleMS";
+const char *c_ProfileSearchSettle_key = "searchSettleMS";
+const char *c_ProfileHighSettle_key   = "highSettleMS";
+const char *c_ProfileResponseTimeout_key = "responseTimeoutMS";
+const char *c_ProfileStreamTimeout_key   = "streamTimeoutMS";
+
+//
+// Limits checked when a profile is loaded
+//
+const int    c_maxDacCode        = 65535;
+const double c_maxCurrentLimit   = 5.25;    // rating of the LEDs, A
+const int    c_maxSettleMS       = 10000;
+const int    c_minTimeoutMS      = 50;
+const int    c_maxTimeoutMS      = 60000;
+
+//
+// Wait after the last change notification before the ini file is read
+//
+const int    c_reloadDelayMS     = 250;
+
+
+
+/*!
+ * @brief constructor, sets the built-in values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CCalibrationProfile::CCalibrationProfile()
+{
+    m_name = c_ProfileName_default;
+    m_channels = LED_CHANNELS_DEFAULT;
+    m_batchHighSearch = true;
+    m_verifySave = true;
+    m_lowWindow[0] = 0;
+    m_lowWindow[1] = 16384;
+    m_highWindow[0] = 48152;
+    m_highWindow[1] = 65535;
+    m_currentLimit = 5.25;
+    m_dacSettleMS = 100;
+    m_searchSettleMS = 100;
+    m_highSettleMS = 200;
+    m_responseTimeoutMS = 3000;
+    m_streamTimeoutMS = 3000;
+}
+
+
+/*!
+ * @brief checks the profile for values the calibration can not run with
+ *
+ * @param[in] none
+ * @return one message per problem, empty if the profile is usable
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QStringList CCalibrationProfile::validate() const
+{
+    QStringList errors;
+
+    if ((m_channels < 1) || (m_channels > LED_CHANNELS_MAX))
+    {
+        errors << QString("%1 must be from 1 to %2").arg(c_ProfileChannels_key).arg(LED_CHANNELS_MAX);
+    }
+    if ((m_lowWindow[0] < 0) || (m_lowWindow[1] > c_maxDacCode) || (m_lowWindow[0] >= m_lowWindow[1]))
+    {
+        errors << QString("%1 must be two DAC codes from 0 to %2, lowest first").arg(c_ProfileLowWindow_key).arg(c_maxDacCode);
+    }
+    if ((m_highWindow[0] < 0) || (m_highWindow[1] > c_maxDacCode) || (m_highWindow[0] >= m_highWindow[1]))
+    {
+        errors << QString("%1 must be two DAC codes from 0 to %2, lowest first").arg(c_ProfileHighWindow_key).arg(c_maxDacCode);
+    }
+    if ((m_currentLimit <= 0.0) || (m_currentLimit > c_maxCurrentLimit))
+    {
+        errors << QString("%1 must be above 0 and at most %2 A").arg(c_ProfileCurrentLimit_key).arg(c_maxCurrentLimit);
+    }
+
+    const int   settle[3]     = { m_dacSettleMS, m_searchSettleMS, m_highSettleMS };
+    const char *settleKey[3]  = { c_ProfileDacSettle_key, c_ProfileSearchSettle_key, c_ProfileHighSettle_key };
+    for (int i=0; i<3; i++)
+    {
+        if ((settle[i] < 0) || (settle[i] > c_maxSettleMS))
+        {
+            errors << QString("%1 must be from 0 to %2").arg(settleKey[i]).arg(c_maxSettleMS);
+        }
+    }
+
+    const int   timeout[2]    = { m_responseTimeoutMS, m_streamTimeoutMS };
+    const char *timeoutKey[2] = { c_ProfileResponseTimeout_key, c_ProfileStreamTimeout_key };
+    for (int i=0; i<2; i++)
+    {
+        if ((timeout[i] < c_minTimeoutMS) || (timeout[i] > c_maxTimeoutMS))
+        {
+            errors << QString("%1 must be from %2 to %3").arg(timeoutKey[i]).arg(c_minTimeoutMS).arg(c_maxTimeoutMS);
+        }
+    }
+    return(errors);
+}
+
+
+/*!
+ * @brief reads a window of DAC codes written as "low, high"
+ *
+ * @param[in] value - value of the key
+ * @param[out] window - the two codes, unchanged if the key is missing
+ * @return false if the value is not two integers
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static bool readWindow(const QVariant &value, int *window)
+{
+    if (!value.isValid())
+    {
+        return(true);
+    }
+    QStringList codes = value.toStringList();
+    if (codes.size() != 2)
+    {
+        return(false);
+    }
+    bool ok0;
+    bool ok1;
+    int low = codes[0].trimmed().toInt(&ok0);
+    int high = codes[1].trimmed().toInt(&ok1);
+    if (!ok0 || !ok1)
+    {
+        return(false);
+    }
+    window[0] = low;
+    window[1] = high;
+    return(true);
+}
+
 
 
 /*!
@@ -53,12 +303,17 @@ const char *c_VersionFPGA_default = "2.02";
  * to the default value.  If the ini file can not be opened then
  * all parameters will be set to their defaults.
  *
+ * The calibration profile named by calibration/profile is loaded as
+ * well; while the object exists the ini file is watched and the profile
+ * loaded again whenever the file is changed.
+ *
  * Note: There should only be one instance of this class created.
  *
  * @author J. Peterson
  * @date 01/12/2015
 */
-CSettings::CSettings()
+CSettings::CSettings(QObject *parent) :
+    QObject(parent)
 {
     m_qSettings = new QSettings(c_iniFile, QSettings::IniFormat);
     m_qSettings->sync();
@@ -68,6 +323,60 @@ CSettings::CSettings()
     m_versionARM  = m_qSettings->value(c_VersionARM_key, c_VersionARM_default).toString();
     m_versionDSP  = m_qSettings->value(c_VersionDSP_key, c_VersionDSP_default).toString();
     m_versionFPGA = m_qSettings->value(c_VersionFPGA_key, c_VersionFPGA_default).toString();
+    m_protocol    = m_qSettings->value(c_Protocol_key, c_Protocol_default).toString();
+    m_exposureFrames = m_qSettings->value(c_ExposureFrames_key, c_ExposureFrames_default).toInt();
+    m_stationPorts = m_qSettings->value(c_StationPorts_key).toStringList();
+    m_maxParallelStations = m_qSettings->value(c_MaxParallelStations_key, c_MaxParallelStations_default).toInt();
+    m_historyFile = m_qSettings->value(c_HistoryFile_key, c_HistoryFile_default).toString();
+    m_traceFile   = m_qSettings->value(c_TraceFile_key, c_TraceFile_default).toString();
+    m_fixtureName = m_qSettings->value(c_FixtureName_key, c_FixtureName_default).toString();
+    m_metricsFile = m_qSettings->value(c_MetricsFile_key, c_MetricsFile_default).toString();
+    m_metricsSocket = m_qSettings->value(c_MetricsSocket_key, c_MetricsSocket_default).toString();
+    m_metricsIntervalMS = m_qSettings->value(c_MetricsInterval_key, c_MetricsInterval_default).toInt();
+    m_automationServer = m_qSettings->value(c_AutomationServer_key, c_AutomationServer_default).toString();
+    m_monitorTickMS = m_qSettings->value(c_MonitorTick_key, c_MonitorTick_default).toInt();
+    m_monitorVoltageMS = m_qSettings->value(c_MonitorVoltage_key, c_MonitorVoltage_default).toInt();
+    m_monitorExposureMS = m_qSettings->value(c_MonitorExposure_key, c_MonitorExposure_default).toInt();
+    m_monitorDacMS = m_qSettings->value(c_MonitorDac_key, c_MonitorDac_default).toInt();
+    m_streamEnabled = m_qSettings->value(c_StreamEnabled_key, c_StreamEnabled_default).toBool();
+    m_streamStartCommands = m_qSettings->value(c_StreamStart_key, QStringList() << "em_style=0" << "disable_events=0").toStringList();
+    m_streamStopCommands = m_qSettings->value(c_StreamStop_key, QStringList() << "disable_events=1").toStringList();
+    m_linkBaudRate = m_qSettings->value(c_LinkBaudRate_key, c_LinkBaudRate_default).toInt();
+    m_linkDataBits = m_qSettings->value(c_LinkDataBits_key, c_LinkDataBits_default).toInt();
+    m_linkParity = m_qSettings->value(c_LinkParity_key, c_LinkParity_default).toString();
+    m_linkStopBits = m_qSettings->value(c_LinkStopBits_key, c_LinkStopBits_default).toInt();
+    m_linkFlowControl = m_qSettings->value(c_LinkFlowControl_key, c_LinkFlowControl_default).toString();
+    m_linkBaudCommand = m_qSettings->value(c_LinkBaudCommand_key, c_LinkBaudCommand_default).toString();
+    m_linkFastRates = m_qSettings->value(c_LinkFastRates_key, QStringList() << "921600" << "460800" << "230400").toStringList();
+    m_linkRetries = m_qSettings->value(c_LinkRetries_key, c_LinkRetries_default).toInt();
+    m_linkRetryBackoffMS = m_qSettings->value(c_LinkRetryBackoff_key, c_LinkRetryBackoff_default).toInt();
+    m_linkEchoTimeoutMS = m_qSettings->value(c_LinkEchoTimeout_key, c_LinkEchoTimeout_default).toInt();
+    m_realTimeEnabled = m_qSettings->value(c_RealTimeEnabled_key, c_RealTimeEnabled_default).toBool();
+    m_realTimePriority = m_qSettings->value(c_RealTimePriority_key, c_RealTimePriority_default).toInt();
+    m_realTimeCpu = m_qSettings->value(c_RealTimeCpu_key, c_RealTimeCpu_default).toInt();
+    m_realTimeLockMemory = m_qSettings->value(c_RealTimeLockMemory_key, c_RealTimeLockMemory_default).toBool();
+    m_realTimeTimerSlackNs = m_qSettings->value(c_RealTimeTimerSlack_key, c_RealTimeTimerSlack_default).toInt();
+    m_profileName = m_qSettings->value(c_ProfileName_key, c_ProfileName_default).toString();
+
+    //
+    // An unusable profile leaves the built-in values in place, but the
+    // calibration refuses to run with them (see profileErrors()) so a typo
+    // can not silently calibrate a product with the wrong windows.
+    //
+    QString errors;
+    if (!loadProfile(m_profileName, &errors))
+    {
+        QMutexLocker locker(&m_profileMutex);
+        m_profileErrors = errors;
+    }
+
+    m_reloadTimer.setSingleShot(true);
+    connect(&m_reloadTimer, SIGNAL(timeout()), this, SLOT(reloadProfile()));
+    connect(&m_iniWatcher, SIGNAL(fileChanged(QString)), this, SLOT(onIniFileChanged()));
+    if (QFileInfo(m_qSettings->fileName()).exists())
+    {
+        m_iniWatcher.addPath(m_qSettings->fileName());
+    }
 }
 
 
@@ -91,9 +400,234 @@ CSettings::~CSettings()
     m_qSettings->setValue(c_VersionARM_key, m_versionARM);
     m_qSettings->setValue(c_VersionDSP_key, m_versionDSP);
     m_qSettings->setValue(c_VersionFPGA_key, m_versionFPGA);
+    m_qSettings->setValue(c_Protocol_key, m_protocol);
+    m_qSettings->setValue(c_ExposureFrames_key, m_exposureFrames);
+    m_qSettings->setValue(c_StationPorts_key, m_stationPorts);
+    m_qSettings->setValue(c_MaxParallelStations_key, m_maxParallelStations);
+    m_qSettings->setValue(c_HistoryFile_key, m_historyFile);
+    m_qSettings->setValue(c_TraceFile_key, m_traceFile);
+    m_qSettings->setValue(c_FixtureName_key, m_fixtureName);
+    m_qSettings->setValue(c_MetricsFile_key, m_metricsFile);
+    m_qSettings->setValue(c_MetricsSocket_key, m_metricsSocket);
+    m_qSettings->setValue(c_MetricsInterval_key, m_metricsIntervalMS);
+    m_qSettings->setValue(c_AutomationServer_key, m_automationServer);
+    m_qSettings->setValue(c_MonitorTick_key, m_monitorTickMS);
+    m_qSettings->setValue(c_MonitorVoltage_key, m_monitorVoltageMS);
+    m_qSettings->setValue(c_MonitorExposure_key, m_monitorExposureMS);
+    m_qSettings->setValue(c_MonitorDac_key, m_monitorDacMS);
+    m_qSettings->setValue(c_StreamEnabled_key, m_streamEnabled);
+    m_qSettings->setValue(c_StreamStart_key, m_streamStartCommands);
+    m_qSettings->setValue(c_StreamStop_key, m_streamStopCommands);
+    m_qSettings->setValue(c_LinkBaudRate_key, m_linkBaudRate);
+    m_qSettings->setValue(c_LinkDataBits_key, m_linkDataBits);
+    m_qSettings->setValue(c_LinkParity_key, m_linkParity);
+    m_qSettings->setValue(c_LinkStopBits_key, m_linkStopBits);
+    m_qSettings->setValue(c_LinkFlowControl_key, m_linkFlowControl);
+    m_qSettings->setValue(c_LinkBaudCommand_key, m_linkBaudCommand);
+    m_qSettings->setValue(c_LinkFastRates_key, m_linkFastRates);
+    m_qSettings->setValue(c_LinkRetries_key, m_linkRetries);
+    m_qSettings->setValue(c_LinkRetryBackoff_key, m_linkRetryBackoffMS);
+    m_qSettings->setValue(c_LinkEchoTimeout_key, m_linkEchoTimeoutMS);
+    m_qSettings->setValue(c_RealTimeEnabled_key, m_realTimeEnabled);
+    m_qSettings->setValue(c_RealTimePriority_key, m_realTimePriority);
+    m_qSettings->setValue(c_RealTimeCpu_key, m_realTimeCpu);
+    m_qSettings->setValue(c_RealTimeLockMemory_key, m_realTimeLockMemory);
+    m_qSettings->setValue(c_RealTimeTimerSlack_key, m_realTimeTimerSlackNs);
+    m_qSettings->setValue(c_ProfileName_key, m_profileName);
 
     m_qSettings->sync();
 }
 
 
 
+
+
+/*!
+ * @brief reads an integer key of a profile
+ *
+ * @param[in] ini - ini file, positioned in the profile's group
+ * @param[in] key - the key
+ * @param[out] value - the value, unchanged if the key is missing
+ * @param[out] errors - gets a message if the value is not an integer
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static void readProfileInt(QSettings &ini, const char *key, int *value, QStringList *errors)
+{
+    if (!ini.contains(key))
+    {
+        return;
+    }
+    bool ok;
+    int number = ini.value(key).toString().trimmed().toInt(&ok);
+    if (!ok)
+    {
+        *errors << QString("%1 is not an integer").arg(key);
+        return;
+    }
+    *value = number;
+}
+
+
+/*!
+ * @brief reads a calibration profile from the ini file and uses it if it is valid
+ *
+ * The file is read again, not taken from the values cached at start-up, so
+ * this also picks up changes made since.  The "default" profile need not
+ * be in the file; any other must have its group.  An invalid profile
+ * leaves the one in use unchanged.
+ *
+ * @param[in] name - name of the profile
+ * @param[out] errors - why the profile was not used, may be 0
+ * @return true if the profile is now in use
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CSettings::loadProfile(QString name, QString *errors)
+{
+    QSettings ini(m_qSettings->fileName(), QSettings::IniFormat);
+    QString group = QString(c_ProfileGroup).arg(name);
+    QStringList problems;
+
+    CCalibrationProfile profile;
+    profile.m_name = name;
+    if (ini.childGroups().contains(group))
+    {
+        ini.beginGroup(group);
+        readProfileInt(ini, c_ProfileChannels_key, &profile.m_channels, &problems);
+        profile.m_batchHighSearch = ini.value(c_ProfileBatchHigh_key, profile.m_batchHighSearch).toBool();
+        profile.m_verifySave = ini.value(c_ProfileVerifySave_key, profile.m_verifySave).toBool();
+        if (!readWindow(ini.value(c_ProfileLowWindow_key), profile.m_lowWindow))
+        {
+            problems << QString("%1 is not two integers").arg(c_ProfileLowWindow_key);
+        }
+        if (!readWindow(ini.value(c_ProfileHighWindow_key), profile.m_highWindow))
+        {
+            problems << QString("%1 is not two integers").arg(c_ProfileHighWindow_key);
+        }
+        if (ini.contains(c_ProfileCurrentLimit_key))
+        {
+            bool ok;
+            profile.m_currentLimit = ini.value(c_ProfileCurrentLimit_key).toString().trimmed().toDouble(&ok);
+            if (!ok)
+            {
+                problems << QString("%1 is not a number").arg(c_ProfileCurrentLimit_key);
+            }
+        }
+        readProfileInt(ini, c_ProfileDacSettle_key, &profile.m_dacSettleMS, &problems);
+        readProfileInt(ini, c_ProfileSearchSettle_key, &profile.m_searchSettleMS, &problems);
+        readProfileInt(ini, c_ProfileHighSettle_key, &profile.m_highSettleMS, &problems);
+        readProfileInt(ini, c_ProfileResponseTimeout_key, &profile.m_responseTimeoutMS, &problems);
+        readProfileInt(ini, c_ProfileStreamTimeout_key, &profile.m_streamTimeoutMS, &problems);
+        ini.endGroup();
+    }
+    else if (name != c_ProfileName_default)
+    {
+        problems << QString("the ini file has no [%1] group").arg(group);
+    }
+
+    if (problems.isEmpty())
+    {
+        problems = profile.validate();
+    }
+    if (!problems.isEmpty())
+    {
+        if (errors)
+        {
+            *errors = QString("Calibration profile \"%1\": %2.").arg(name).arg(problems.join("; "));
+        }
+        return(false);
+    }
+
+    QMutexLocker locker(&m_profileMutex);
+    m_profile = profile;
+    m_profileErrors.clear();
+    return(true);
+}
+
+
+/*!
+ * @brief returns a copy of the profile the next calibration runs with
+ *
+ * The engines call this from their own threads while a reload may be
+ * replacing the profile in the window's thread.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CCalibrationProfile CSettings::profile() const
+{
+    QMutexLocker locker(&m_profileMutex);
+    return(m_profile);
+}
+
+
+/*!
+ * @brief returns why no valid profile was ever loaded, empty if one was
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QString CSettings::profileErrors() const
+{
+    QMutexLocker locker(&m_profileMutex);
+    return(m_profileErrors);
+}
+
+
+/*!
+ * @brief schedules a reload of the profile after the ini file changed
+ *
+ * Editors write a file in several steps, so the file is read only once
+ * the notifications have stopped for a moment.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSettings::onIniFileChanged()
+{
+    m_reloadTimer.start(c_reloadDelayMS);
+}
+
+
+/*!
+ * @brief loads the profile named in the ini file again
+ *
+ * Reports the outcome through profileLoaded() or profileRejected().  A
+ * rejected edit leaves the last valid profile in use, so production can
+ * go on while the file is corrected.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CSettings::reloadProfile()
+{
+    //
+    // Editors that save by replacing the file end the watch on it
+    //
+    QString fileName = m_qSettings->fileName();
+    if (QFileInfo(fileName).exists() && !m_iniWatcher.files().contains(fileName))
+    {
+        m_iniWatcher.addPath(fileName);
+    }
+
+    QSettings ini(fileName, QSettings::IniFormat);
+    m_profileName = ini.value(c_ProfileName_key, c_ProfileName_default).toString();
+
+    QString errors;
+    if (loadProfile(m_profileName, &errors))
+    {
+        emit profileLoaded(m_profileName);
+        return;
+    }
+    {
+        QMutexLocker locker(&m_profileMutex);
+        if (!m_profileErrors.isEmpty())
+        {
+            m_profileErrors = errors;
+        }
+    }
+    emit profileRejected(m_profileName, errors);
+}
@@ -11,21 +11,65 @@
  *  Version | Author       | Date        | Description
  *  :--:    | :-----       | :--:        | :----------
  *   1      | J. Peterson  | 01/23/2015  | initial version
+ *   2      | agent        | 10/18/2026  | calibration profiles, reloaded when the ini file changes
+ *   3      | agent        | 10/18/2026  | number of LED channels in the profile
+ *   4      | agent        | 10/18/2026  | controller protocol
+ *   5      | agent        | 10/18/2026  | verification of the saved calibration in the profile
+ *   6      | agent        | 10/18/2026  | binary trace file
+ *   7      | agent        | 10/18/2026  | real-time mode of the serial timing
+ *   8      | agent        | 10/18/2026  | profile read from the engine threads under a lock
  *
 */
 
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include <QObject>
 #include <QSettings>
 #include <QString>
+#include <QStringList>
+#include <QFileSystemWatcher>
+#include <QMutex>
+#include <QTimer>
 
-class CSettings
+
+/*!
+ * Parameters of the threshold searches, kept in the ini file under a name
+ * so each product or fixture can have its own.
+ */
+class CCalibrationProfile
+{
+public:
+    CCalibrationProfile();
+    QStringList validate() const;
+
+public:
+    QString m_name;               // name of the profile, "default" for the built-in values
+    int     m_channels;           // LED channels of the product
+    bool    m_batchHighSearch;    // search the high thresholds of all channels at once
+    bool    m_verifySave;         // read back and probe the thresholds after saving them
+    int     m_lowWindow[2];       // DAC codes searched for the low (exposure) thresholds
+    int     m_highWindow[2];      // DAC codes searched for the high (current) thresholds
+    double  m_currentLimit;       // highest LED current at the high threshold, A
+    int     m_dacSettleMS;        // wait after setting the DACs before measuring
+    int     m_searchSettleMS;     // wait after the first measurement of a search
+    int     m_highSettleMS;       // wait before judging a probe of a high threshold
+    int     m_responseTimeoutMS;  // timeout of the echo and of each response line
+    int     m_streamTimeoutMS;    // longest wait for a streamed reading
+};
+
+
+class CSettings : public QObject
 {
+    Q_OBJECT
+
 public:
-    CSettings();
+    CSettings(QObject *parent = 0);
     ~CSettings();
     bool load(QString filename);
+    CCalibrationProfile profile() const;
+    QString profileErrors() const;
+    bool loadProfile(QString name, QString *errors);
 
 public:
     QString m_reportFile;     // file name of the report file
@@ -33,9 +77,56 @@ public:
     QString m_versionARM;     // version of ARM firmware
     QString m_versionDSP;     // version of DSP firmware
     QString m_versionFPGA;    // version of FPGA firmware
+    QString m_protocol;       // firmware protocol of the controller, "auto" to go by its version response
+    int     m_exposureFrames; // number of exposure frames averaged per reading
+    QStringList m_stationPorts;   // serial ports of the additional calibration stations
+    int     m_maxParallelStations; // maximum number of stations calibrating at once, 0 for no limit
+    QString m_historyFile;    // calibration history database, empty to disable
+    QString m_traceFile;      // binary trace of the serial traffic and the measurements, empty to disable
+    QString m_fixtureName;    // name of this fixture in the history, empty to use the serial port name
+    QString m_metricsFile;    // Prometheus textfile, empty to disable
+    QString m_metricsSocket;  // local socket serving the metrics, empty to disable
+    int     m_metricsIntervalMS;  // interval between rewrites of the metrics textfile
+    QString m_automationServer;   // local server name of the automation API, empty to disable
+    int     m_monitorTickMS;      // interval of the idle monitor timer
+    int     m_monitorVoltageMS;   // interval between I/V readings of the idle monitor
+    int     m_monitorExposureMS;  // interval between exposure readings of the idle monitor
+    int     m_monitorDacMS;       // interval between DAC readings of the idle monitor
+    bool    m_streamEnabled;      // read exposure and I/V from the controller's events instead of polling
+    QStringList m_streamStartCommands;  // commands that turn the controller's events on
+    QStringList m_streamStopCommands;   // commands that turn the controller's events off
+    int     m_linkBaudRate;       // baud rate the controller starts with
+    int     m_linkDataBits;       // 5 to 8
+    QString m_linkParity;         // none, even, odd, space or mark
+    int     m_linkStopBits;       // 1 or 2
+    QString m_linkFlowControl;    // none, hardware or software
+    QString m_linkBaudCommand;    // command that changes the controller's rate, %1 is the rate; empty to never change it
+    QStringList m_linkFastRates;  // rates tried by the negotiation, fastest first
+    int     m_linkRetries;        // retries of a failed transaction, 0 to never retry
+    int     m_linkRetryBackoffMS; // wait before the first retry, doubled for every further retry
+    int     m_linkEchoTimeoutMS;  // timeout of a command's echo when retries are enabled
+    bool    m_realTimeEnabled;    // run the serial timing at a real-time priority (Linux)
+    int     m_realTimePriority;   // SCHED_FIFO priority, 1 to 99
+    int     m_realTimeCpu;        // CPU the serial timing is pinned to, -1 for any
+    bool    m_realTimeLockMemory; // lock the process in memory
+    int     m_realTimeTimerSlackNs;   // timer slack of the serial timing, nanoseconds
+    QString m_profileName;        // calibration profile in use
+
+signals:
+    void profileLoaded(QString name);
+    void profileRejected(QString name, QString errors);
+
+private slots:
+    void onIniFileChanged();
+    void reloadProfile();
 
 private:
     QSettings  *m_qSettings;  //! QT QSettings object that provides the interface to the ini file
+    mutable QMutex m_profileMutex;      // guards the profile, which the engines read from their threads
+    CCalibrationProfile m_profile;      // profile the next calibration runs with
+    QString     m_profileErrors;        // why no valid profile was ever loaded, empty if one was
+    QFileSystemWatcher  m_iniWatcher;   // reports edits of the ini file
+    QTimer      m_reloadTimer;          // collects the change notifications of one edit
 };
 
 
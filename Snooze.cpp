@@ -1,7 +1,57 @@
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include "Snooze.h"
+#include "Metrics.h"
+
+#if defined(Q_OS_WIN)
 #include <windows.h>
-#include "snooze.h"
+#elif defined(Q_OS_LINUX)
+#include <time.h>
+#include <errno.h>
+#else
+#include <unistd.h>
+#endif
 
+/*!
+ * @brief sleeps for the given number of milliseconds
+ *
+ * On Linux the sleep is to an absolute deadline on the monotonic clock,
+ * so an interrupted sleep resumes to the same deadline instead of starting
+ * over.  How late the thread woke up is recorded in the metrics.
+ *
+ * @param[in] milliseconds - time to sleep
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
 void snooze(int milliseconds)
 {
+#if defined(Q_OS_LINUX)
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += milliseconds / 1000;
+    deadline.tv_nsec += (milliseconds % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0) == EINTR)
+    {
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    qint64 lateNs = (qint64)(now.tv_sec - deadline.tv_sec) * 1000000000LL + (now.tv_nsec - deadline.tv_nsec);
+    CMetrics::instance()->observeWakeup(CMetrics::Wakeup_Snooze, lateNs / 1000);
+#else
+    QElapsedTimer timer;
+    timer.start();
+#if defined(Q_OS_WIN)
     Sleep(milliseconds);
+#else
+    usleep(milliseconds * 1000);
+#endif
+    CMetrics::instance()->observeWakeup(CMetrics::Wakeup_Snooze, timer.nsecsElapsed() / 1000 - milliseconds * 1000LL);
+#endif
 }
@@ -0,0 +1,373 @@
+/*!
+ * @file StationScheduler.cpp
+ * @brief Runs calibrations on several stations at the same time
+ *
+ * Each station is a serial port listed in the ini file with an engine of
+ * its own in its own thread.  The engines do not wait on the controller,
+ * but the run history, the drift check and the journal still touch the
+ * disk, so one fixture is never held up by another's.  Requests are queued and dispatched in order to whichever
+ * requested station is free, subject to the configured maximum number of
+ * parallel runs.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | engines share the scheduler's thread
+ *   3      | agent        | 10/18/2026  | each engine in its own thread again
+ *   4      | agent        | 10/18/2026  | engine threads in the real-time mode
+ *
+*/
+
+#include <QFileInfo>
+#include <QRegExp>
+#include "StationScheduler.h"
+#include "ReportWriter.h"
+
+
+CStation::CStation()
+{
+    m_thread = 0;
+    m_engine = 0;
+    m_busy = false;
+}
+
+
+/*!
+ * @brief constructor
+ *
+ * One engine and thread is created for every port in m_stationPorts.
+ * The threads enter the real-time mode of the settings as they start.
+ *
+ * @param[in] settings - application settings, must outlive the scheduler
+ * @param[in] reportWriter - writer of the station reports, must outlive the scheduler
+ * @param[in] parent - owner of the scheduler
+ * @return none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CStationScheduler::CStationScheduler(CSettings *settings, CReportWriter *reportWriter, QObject *parent) :
+    QObject(parent),
+    m_settings(settings),
+    m_reportWriter(reportWriter)
+{
+    qRegisterMetaType<CCalibrationResult>("CCalibrationResult");
+
+    m_maxParallel = m_settings->m_maxParallelStations;
+    CRealTimeMode realTime = CRealTimeMode::fromSettings(m_settings);
+
+    for (int i=0; i<m_settings->m_stationPorts.size(); i++)
+    {
+        CStation station;
+        station.m_port = m_settings->m_stationPorts[i].trimmed();
+        if (station.m_port.isEmpty())
+        {
+            continue;
+        }
+
+        station.m_thread = new CRealTimeThread(realTime, this);
+        station.m_engine = new CCalibrationEngine(m_settings);
+        station.m_engine->setSerialPortName(station.m_port);
+        station.m_engine->moveToThread(station.m_thread);
+        connect(station.m_thread, SIGNAL(finished()), station.m_engine, SLOT(deleteLater()));
+        connect(station.m_thread, SIGNAL(realTimeModeIncomplete(QString)),
+                this, SIGNAL(realTimeModeIncomplete(QString)));
+
+        connect(station.m_engine, SIGNAL(statusChanged(QString)),
+                this, SLOT(onStatusChanged(QString)));
+        connect(station.m_engine, SIGNAL(errorOccurred(QString)),
+                this, SLOT(onErrorOccurred(QString)));
+        connect(station.m_engine, SIGNAL(confirmationRequested(QString)),
+                this, SLOT(onConfirmationRequested(QString)));
+        connect(station.m_engine, SIGNAL(calibrationFinished(CCalibrationResult)),
+                this, SLOT(onCalibrationFinished(CCalibrationResult)));
+
+        station.m_thread->start();
+        station.m_status = "idle";
+        m_stations.append(station);
+    }
+}
+
+
+/*!
+ * @brief destructor
+ *
+ * Stops all station threads.  The engines are deleted in their threads as
+ * these finish; a calibration that is still running is abandoned with the
+ * LEDs off and resumes from its journal next time.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CStationScheduler::~CStationScheduler()
+{
+    m_queue.clear();
+    for (int i=0; i<m_stations.size(); i++)
+    {
+        m_stations[i].m_thread->quit();
+    }
+    for (int i=0; i<m_stations.size(); i++)
+    {
+        m_stations[i].m_thread->wait();
+    }
+}
+
+
+QString CStationScheduler::stationPort(int station) const
+{
+    if ((station < 0) || (station >= m_stations.size()))
+    {
+        return(QString());
+    }
+    return(m_stations[station].m_port);
+}
+
+QString CStationScheduler::stationStatus(int station) const
+{
+    if ((station < 0) || (station >= m_stations.size()))
+    {
+        return(QString());
+    }
+    return(m_stations[station].m_status);
+}
+
+bool CStationScheduler::isBusy(int station) const
+{
+    if ((station < 0) || (station >= m_stations.size()))
+    {
+        return(false);
+    }
+    return(m_stations[station].m_busy);
+}
+
+bool CStationScheduler::isIdle() const
+{
+    return(m_queue.isEmpty() && (runningCount() == 0));
+}
+
+
+/*!
+ * @brief sets the maximum number of stations calibrating at the same time
+ *
+ * @param[in] maxParallel - limit, 0 for no limit
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CStationScheduler::setMaxParallel(int maxParallel)
+{
+    m_maxParallel = (maxParallel > 0) ? maxParallel : 0;
+    dispatch();
+}
+
+
+/*!
+ * @brief queues a calibration on a station
+ *
+ * @param[in] station - index of the station
+ * @param[in] operatorName - operator running the calibration
+ * @param[in] serialNumber - serial number of the unit in the fixture
+ * @return false if the station does not exist or already has work queued
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CStationScheduler::enqueue(int station, QString operatorName, QString serialNumber)
+{
+    if ((station < 0) || (station >= m_stations.size()) || m_stations[station].m_busy)
+    {
+        return(false);
+    }
+    for (int i=0; i<m_queue.size(); i++)
+    {
+        if (m_queue[i].m_station == station)
+        {
+            return(false);
+        }
+    }
+
+    CStationJob job;
+    job.m_station = station;
+    job.m_operator = operatorName;
+    job.m_serialNumber = serialNumber;
+    m_queue.append(job);
+
+    m_stations[station].m_status = "queued";
+    emit stationStatusChanged(station, m_stations[station].m_status);
+
+    dispatch();
+    return(true);
+}
+
+
+int CStationScheduler::runningCount() const
+{
+    int running = 0;
+    for (int i=0; i<m_stations.size(); i++)
+    {
+        if (m_stations[i].m_busy)
+        {
+            running++;
+        }
+    }
+    return(running);
+}
+
+
+int CStationScheduler::stationOf(QObject *engine) const
+{
+    for (int i=0; i<m_stations.size(); i++)
+    {
+        if (m_stations[i].m_engine == engine)
+        {
+            return(i);
+        }
+    }
+    return(-1);
+}
+
+
+/*!
+ * @brief starts queued jobs on free stations
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CStationScheduler::dispatch()
+{
+    int running = runningCount();
+    int i = 0;
+    while (i < m_queue.size())
+    {
+        if ((m_maxParallel > 0) && (running >= m_maxParallel))
+        {
+            break;
+        }
+
+        CStation &station = m_stations[m_queue[i].m_station];
+        if (station.m_busy)
+        {
+            i++;
+            continue;
+        }
+
+        CStationJob job = m_queue.takeAt(i);
+
+        //
+        // The engine belongs to its thread, so the run is handed over with
+        // a queued call; calibrationFinished() comes back as a queued
+        // signal and can not re-enter this loop.
+        //
+        station.m_busy = true;
+        QMetaObject::invokeMethod(station.m_engine, "start", Qt::QueuedConnection,
+                                  Q_ARG(QString, job.m_operator),
+                                  Q_ARG(QString, job.m_serialNumber));
+        running++;
+    }
+}
+
+
+void CStationScheduler::onStatusChanged(QString text)
+{
+    int station = stationOf(sender());
+    if (station < 0)
+    {
+        return;
+    }
+    m_stations[station].m_status = text;
+    emit stationStatusChanged(station, text);
+}
+
+
+void CStationScheduler::onErrorOccurred(QString text)
+{
+    int station = stationOf(sender());
+    if (station < 0)
+    {
+        return;
+    }
+    m_stations[station].m_status = text.section('\n', 0, 0);
+    emit stationStatusChanged(station, m_stations[station].m_status);
+}
+
+
+void CStationScheduler::onConfirmationRequested(QString text)
+{
+    int station = stationOf(sender());
+    if (station < 0)
+    {
+        return;
+    }
+    emit stationConfirmationRequested(station, text);
+}
+
+
+/*!
+ * @brief answers the question of stationConfirmationRequested()
+ *
+ * @param[in] station - index of the station that asked
+ * @param[in] proceed - true if its run may go on
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CStationScheduler::confirm(int station, bool proceed)
+{
+    if ((station < 0) || (station >= m_stations.size()))
+    {
+        return;
+    }
+    QMetaObject::invokeMethod(m_stations[station].m_engine, "confirm", Qt::QueuedConnection,
+                              Q_ARG(bool, proceed));
+}
+
+
+void CStationScheduler::onCalibrationFinished(CCalibrationResult result)
+{
+    int station = stationOf(sender());
+    if (station < 0)
+    {
+        return;
+    }
+
+    m_stations[station].m_busy = false;
+    m_stations[station].m_status = result.m_success ? "passed" : "failed";
+    m_reportWriter->write(reportFileName(result.m_station), result);
+
+    emit stationStatusChanged(station, m_stations[station].m_status);
+    emit stationFinished(station, result);
+
+    dispatch();
+}
+
+
+/*!
+ * @brief returns the name of a station's report file
+ *
+ * Each station gets its own file, named after the report file with the
+ * port name appended, e.g. Spyglass_LED_Calibration_COM3.log.  A port
+ * given as a device path (/dev/ttyUSB0) contributes only its last part.
+ *
+ * @param[in] station - port name of the station
+ * @return file name
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+QString CStationScheduler::reportFileName(QString station) const
+{
+    QFileInfo info(m_settings->m_reportFile);
+    QString port = station.section(QRegExp("[/\\\\]"), -1);
+    QString fileName = info.path() + "/" + info.completeBaseName() + "_" + port;
+    if (!info.suffix().isEmpty())
+    {
+        fileName += "." + info.suffix();
+    }
+    return(fileName);
+}
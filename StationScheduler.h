@@ -0,0 +1,110 @@
+/*!
+ * @file StationScheduler.h
+ * @brief Declares the scheduler that runs calibrations on several stations
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | engine threads in the real-time mode
+ *
+*/
+
+#ifndef STATIONSCHEDULER_H
+#define STATIONSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include "CalibrationEngine.h"
+#include "RealTime.h"
+
+class CReportWriter;
+
+
+/*!
+ * One calibration fixture: a serial port with its own engine.
+ */
+class CStation
+{
+public:
+    CStation();
+
+public:
+    QString             m_port;         // serial port of the fixture
+    CRealTimeThread    *m_thread;       // thread of the engine, child of the scheduler
+    CCalibrationEngine *m_engine;       // engine, deleted when its thread finishes
+    bool                m_busy;         // true while a calibration is running
+    QString             m_status;       // last status reported by the engine
+};
+
+
+/*!
+ * A pending calibration request.
+ */
+class CStationJob
+{
+public:
+    int     m_station;
+    QString m_operator;
+    QString m_serialNumber;
+};
+
+
+/*!
+ * Owns one engine per configured station and dispatches queued calibration
+ * requests to them.  Each engine runs in a thread of its own, in the
+ * real-time mode if it is enabled, so the stations calibrate concurrently;
+ * the scheduler limits how many run at once.
+ */
+class CStationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    CStationScheduler(CSettings *settings, CReportWriter *reportWriter, QObject *parent = 0);
+    ~CStationScheduler();
+
+    int     stationCount() const { return(m_stations.size()); }
+    QString stationPort(int station) const;
+    QString stationStatus(int station) const;
+    bool    isBusy(int station) const;
+    bool    isIdle() const;
+    int     pendingCount() const { return(m_queue.size()); }
+
+    void    setMaxParallel(int maxParallel);
+    bool    enqueue(int station, QString operatorName, QString serialNumber);
+    void    confirm(int station, bool proceed);
+
+signals:
+    void stationStatusChanged(int station, QString text);
+    void stationFinished(int station, CCalibrationResult result);
+    void stationConfirmationRequested(int station, QString text);
+    void realTimeModeIncomplete(QString problems);
+
+private slots:
+    void onStatusChanged(QString text);
+    void onErrorOccurred(QString text);
+    void onConfirmationRequested(QString text);
+    void onCalibrationFinished(CCalibrationResult result);
+
+private:
+    int  stationOf(QObject *engine) const;
+    int  runningCount() const;
+    void dispatch();
+    QString reportFileName(QString station) const;
+
+private:
+    CSettings          *m_settings;
+    CReportWriter      *m_reportWriter;
+    QList<CStation>     m_stations;
+    QList<CStationJob>  m_queue;
+    int                 m_maxParallel;  // 0 means no limit
+};
+
+#endif // STATIONSCHEDULER_H
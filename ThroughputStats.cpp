@@ -0,0 +1,200 @@
+/*!
+ * @file ThroughputStats.cpp
+ * @brief Implements the station throughput statistics
+ *
+ * The window holds at most a few hundred runs, so the percentiles are
+ * simply selected from the runs when the dashboard is refreshed.
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QDateTime>
+#include <QVector>
+#include <algorithm>
+#include "ThroughputStats.h"
+
+//
+// Shortest span used for the rate, so the first few units do not show
+// an absurd number of units per hour
+//
+const qint64 c_minRateSpanMs = 5 * 60 * 1000;
+
+
+CThroughputStats::CThroughputStats(int windowMinutes)
+{
+    m_windowMs = (qint64)windowMinutes * 60 * 1000;
+}
+
+
+/*!
+ * @brief adds a finished calibration run
+ *
+ * @param[in] result - outcome of the run
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CThroughputStats::add(const CCalibrationResult &result)
+{
+    expire();
+
+    CRun run;
+    run.m_time = QDateTime::currentMSecsSinceEpoch();
+    run.m_serialNumber = result.m_serialNumber;
+    run.m_success = result.m_success;
+    run.m_retry = false;
+    for (int i=0; i<m_runs.size(); i++)
+    {
+        if (m_runs[i].m_serialNumber == run.m_serialNumber)
+        {
+            run.m_retry = true;
+            break;
+        }
+    }
+    for (int i=0; i<TIMING_PHASES; i++)
+    {
+        run.m_phaseMs[i] = result.m_phaseMs[i];
+    }
+    m_runs.append(run);
+}
+
+
+void CThroughputStats::clear()
+{
+    m_runs.clear();
+}
+
+
+void CThroughputStats::expire()
+{
+    qint64 oldest = QDateTime::currentMSecsSinceEpoch() - m_windowMs;
+    while (!m_runs.isEmpty() && (m_runs.first().m_time < oldest))
+    {
+        m_runs.removeFirst();
+    }
+}
+
+
+int CThroughputStats::runCount()
+{
+    expire();
+    return(m_runs.size());
+}
+
+
+/*!
+ * @brief returns the number of passed units per hour within the window
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+double CThroughputStats::unitsPerHour()
+{
+    expire();
+    if (m_runs.isEmpty())
+    {
+        return(0.0);
+    }
+
+    int passed = 0;
+    for (int i=0; i<m_runs.size(); i++)
+    {
+        if (m_runs[i].m_success)
+        {
+            passed++;
+        }
+    }
+    qint64 span = QDateTime::currentMSecsSinceEpoch() - m_runs.first().m_time;
+    span = qBound(c_minRateSpanMs, span, m_windowMs);
+    return(passed * 3600000.0 / span);
+}
+
+
+double CThroughputStats::failureRate()
+{
+    expire();
+    if (m_runs.isEmpty())
+    {
+        return(0.0);
+    }
+
+    int failed = 0;
+    for (int i=0; i<m_runs.size(); i++)
+    {
+        if (!m_runs[i].m_success)
+        {
+            failed++;
+        }
+    }
+    return((double)failed / m_runs.size());
+}
+
+
+/*!
+ * @brief returns the fraction of runs that repeated a unit already run within the window
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+double CThroughputStats::retryRate()
+{
+    expire();
+    if (m_runs.isEmpty())
+    {
+        return(0.0);
+    }
+
+    int retries = 0;
+    for (int i=0; i<m_runs.size(); i++)
+    {
+        if (m_runs[i].m_retry)
+        {
+            retries++;
+        }
+    }
+    return((double)retries / m_runs.size());
+}
+
+
+/*!
+ * @brief returns a percentile of the time spent in a step
+ *
+ * Runs that did not reach the step are left out.
+ *
+ * @param[in] timing - one of the CalibrationTiming values
+ * @param[in] fraction - 0.5 for the median, 0.95 for p95
+ * @return time in ms, -1 if no run reached the step
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+qint64 CThroughputStats::phasePercentile(int timing, double fraction)
+{
+    expire();
+
+    QVector<qint64> times;
+    for (int i=0; i<m_runs.size(); i++)
+    {
+        if (m_runs[i].m_phaseMs[timing] >= 0)
+        {
+            times.append(m_runs[i].m_phaseMs[timing]);
+        }
+    }
+    if (times.isEmpty())
+    {
+        return(-1);
+    }
+
+    int index = (int)(fraction * (times.size() - 1) + 0.5);
+    std::nth_element(times.begin(), times.begin() + index, times.end());
+    return(times[index]);
+}
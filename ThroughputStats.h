@@ -0,0 +1,61 @@
+/*!
+ * @file ThroughputStats.h
+ * @brief Declares the station throughput statistics
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef THROUGHPUTSTATS_H
+#define THROUGHPUTSTATS_H
+
+#include <QList>
+#include <QString>
+#include "CalibrationEngine.h"
+
+
+/*!
+ * Throughput and per-phase timing of the calibrations finished within a
+ * rolling time window, fed from the results the engines already produce.
+ */
+class CThroughputStats
+{
+public:
+    explicit CThroughputStats(int windowMinutes = 60);
+
+    void    add(const CCalibrationResult &result);
+    void    clear();
+
+    int     runCount();
+    double  unitsPerHour();
+    double  failureRate();
+    double  retryRate();
+    qint64  phasePercentile(int timing, double fraction);
+
+private:
+    class CRun
+    {
+    public:
+        qint64  m_time;                     // when the run finished, ms since epoch
+        QString m_serialNumber;
+        bool    m_success;
+        bool    m_retry;                    // the unit was already run within the window
+        qint64  m_phaseMs[TIMING_PHASES];
+    };
+
+    void expire();
+
+private:
+    qint64      m_windowMs;
+    QList<CRun> m_runs;                     // oldest first
+};
+
+#endif // THROUGHPUTSTATS_H
@@ -0,0 +1,1012 @@
+/*!
+ * @file TraceFile.cpp
+ * @brief Implements the binary trace of the serial traffic and the measurements
+ *
+ * Block header, little endian:
+ *
+ *   0   4   magic "LCT1"
+ *   4   4   reserved, 0
+ *   8   8   time of the first record, microseconds since the epoch
+ *   16  8   number of the first record
+ *
+ * Record: a type byte (0 ends the block), the zigzag varint time delta,
+ * then by type
+ *
+ *   command, response   flags (1 = ok), varint ms, varint length, Latin-1 text
+ *   sample              varint channels, per channel the deltas of the DAC
+ *                       code, uV and uA, then the deltas of the 25 zones
+ *   run                 varint length, UTF-8 serial number
+ *
+ * Serial number index, one entry per run record in the order written:
+ *
+ *   varint number of the run record, varint length, UTF-8 serial number
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | serial number index of the runs
+ *
+*/
+
+#include <QtEndian>
+#include <QDateTime>
+#include <QFileInfo>
+#include <algorithm>
+#include "TraceFile.h"
+
+#define TRACE_MAGIC     0x3154434C      // "LCT1"
+
+
+static void putVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80)
+    {
+        out.append((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append((char)value);
+}
+
+
+static void putSigned(QByteArray &out, qint64 value)
+{
+    putVarint(out, ((quint64)value << 1) ^ (quint64)(value >> 63));
+}
+
+
+static bool getVarint(const uchar *data, qint64 end, qint64 *pos, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift=0; shift<64; shift+=7)
+    {
+        if (*pos >= end)
+        {
+            return(false);
+        }
+        uchar byte = data[(*pos)++];
+        result |= (quint64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return(true);
+        }
+    }
+    return(false);
+}
+
+
+static bool getSigned(const uchar *data, qint64 end, qint64 *pos, qint64 *value)
+{
+    quint64 u;
+    if (!getVarint(data, end, pos, &u))
+    {
+        return(false);
+    }
+    *value = (qint64)(u >> 1) ^ -(qint64)(u & 1);
+    return(true);
+}
+
+
+static QByteArray runEntry(qint64 number, const QByteArray &serialNumber)
+{
+    QByteArray entry;
+    putVarint(entry, number);
+    putVarint(entry, serialNumber.size());
+    entry.append(serialNumber);
+    return(entry);
+}
+
+
+/*!
+ * @brief decodes the entries of a serial number index
+ *
+ * @param[in] data, size - the index file
+ * @param[in] records - records in the trace; entries of later records
+ *                      end the index, -1 to keep them
+ * @param[out] runs - the entries, in the order of the file
+ * @return the end of the last entry kept
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static qint64 readRuns(const uchar *data, qint64 size, qint64 records, QList<CTraceRun> *runs)
+{
+    qint64 pos = 0;
+    qint64 end = 0;
+    quint64 number;
+    quint64 n;
+    while (    getVarint(data, size, &pos, &number)
+            && getVarint(data, size, &pos, &n)
+            && (n <= (quint64)(size - pos))
+            && ((records < 0) || ((qint64)number < records)) )
+    {
+        CTraceRun run;
+        run.m_number = (qint64)number;
+        run.m_serialNumber = QString::fromUtf8((const char *)data + pos, (int)n);
+        runs->append(run);
+        pos += n;
+        end = pos;
+    }
+    return(end);
+}
+
+
+static bool runBefore(const CTraceRun &a, const CTraceRun &b)
+{
+    return(a.m_serialNumber < b.m_serialNumber);
+}
+
+
+CTraceRecord::CTraceRecord()
+{
+    m_type = Trace_None;
+    m_number = 0;
+    m_time = 0;
+    m_ok = false;
+    m_ms = 0;
+    m_channels = 0;
+    for (int c=0; c<LED_CHANNELS_MAX; c++)
+    {
+        m_dac[c] = 0;
+        m_V[c] = m_I[c] = 0.0;
+    }
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        m_zones[i] = 0;
+    }
+}
+
+
+void CTraceState::reset(qint64 time)
+{
+    m_time = time;
+    for (int c=0; c<LED_CHANNELS_MAX; c++)
+    {
+        m_dac[c] = m_uV[c] = m_uA[c] = 0;
+    }
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        m_zones[i] = 0;
+    }
+}
+
+
+CTraceWriter::CTraceWriter()
+{
+    m_epoch = 0;
+    m_blockUsed = 0;
+    m_records = 0;
+    m_state.reset(0);
+}
+
+
+CTraceWriter::~CTraceWriter()
+{
+    close();
+}
+
+
+/*!
+ * @brief opens a trace for appending, creating it if needed
+ *
+ * @param[in] fileName - the trace file
+ * @return false if it could not be opened, or exists and is not a trace
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceWriter::open(QString fileName)
+{
+    close();
+
+    //
+    // Continue after the last complete record; the delta state of the
+    // last block is not kept, so the records go to a new block
+    //
+    qint64 end = 0;
+    m_records = 0;
+    if (QFileInfo(fileName).size() > 0)
+    {
+        CTraceReader reader;
+        if (!reader.open(fileName) || !reader.seekEnd())
+        {
+            return(false);
+        }
+        end = reader.position();
+        m_records = reader.recordNumber();
+    }
+
+    m_file.setFileName(fileName);
+    if (    !m_file.open(QIODevice::ReadWrite | QIODevice::Unbuffered)
+         || !m_file.resize(end)
+         || !m_file.seek(end) )
+    {
+        m_file.close();
+        return(false);
+    }
+
+    m_blockUsed = end % TRACE_BLOCK_SIZE;
+    if (m_blockUsed > 0)
+    {
+        m_file.write(QByteArray(TRACE_BLOCK_SIZE - m_blockUsed, '\0'));
+        m_blockUsed = 0;
+    }
+
+    m_epoch = QDateTime::currentMSecsSinceEpoch() * 1000;
+    m_clock.start();
+
+    openIndex(fileName);
+    return(true);
+}
+
+
+void CTraceWriter::close()
+{
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+    if (m_index.isOpen())
+    {
+        m_index.close();
+    }
+}
+
+
+/*!
+ * @brief opens the serial number index of the trace for appending
+ *
+ * Entries of runs the trace lost in a crash are cut off.  An index that
+ * does not exist or can not be read is rebuilt by reading the whole trace
+ * once.  Without an index the trace is still written; the readers then
+ * scan for serial numbers.
+ *
+ * @param[in] fileName - the trace file
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::openIndex(const QString &fileName)
+{
+    QString indexName = fileName + TRACE_INDEX_SUFFIX;
+    QByteArray rebuilt;
+    qint64 end = 0;
+
+    QFile file(indexName);
+    if (file.open(QIODevice::ReadOnly))
+    {
+        QByteArray data = file.readAll();
+        QList<CTraceRun> runs;
+        end = readRuns((const uchar *)data.constData(), data.size(), m_records, &runs);
+        file.close();
+    }
+    else if (m_records > 0)
+    {
+        CTraceReader reader;
+        CTraceRecord record;
+        if (reader.open(fileName))
+        {
+            while (reader.next(&record) && (record.m_number < m_records))
+            {
+                if (record.m_type == CTraceRecord::Trace_Run)
+                {
+                    rebuilt.append(runEntry(record.m_number, record.m_text.toUtf8()));
+                }
+            }
+        }
+    }
+
+    m_index.setFileName(indexName);
+    if (    !m_index.open(QIODevice::ReadWrite | QIODevice::Unbuffered)
+         || !m_index.resize(end)
+         || !m_index.seek(end)
+         || (m_index.write(rebuilt) != rebuilt.size()) )
+    {
+        m_index.close();
+        m_index.remove();
+    }
+}
+
+
+/*!
+ * @brief appends the run about to be recorded to the serial number index
+ *
+ * The entry goes first: a crash before the run record leaves an entry
+ * past the end of the trace, which the next open cuts off, and never a
+ * run the index does not know.  An index that can not be written is
+ * removed, so the next open rebuilds it.
+ *
+ * @param[in] serialNumber - UTF-8 serial number of the unit
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::indexRun(const QByteArray &serialNumber)
+{
+    if (!m_index.isOpen())
+    {
+        return;
+    }
+
+    QByteArray entry = runEntry(m_records, serialNumber);
+    if (m_index.write(entry) != entry.size())
+    {
+        m_index.close();
+        m_index.remove();
+    }
+}
+
+
+/*!
+ * @brief records a command and whether it was echoed
+ *
+ * @param[in] command - the command without the line end
+ * @param[in] ok - true if the echo arrived and matched
+ * @param[in] ms - time from sending the command to the echo or the timeout
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::command(const QByteArray &command, bool ok, int ms)
+{
+    text(CTraceRecord::Trace_Command, command, ok, ms);
+}
+
+
+/*!
+ * @brief records a response line, or that it timed out
+ *
+ * @param[in] line - the line, partial if it timed out
+ * @param[in] ok - false if it timed out
+ * @param[in] ms - time since the command was sent
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::response(const QByteArray &line, bool ok, int ms)
+{
+    text(CTraceRecord::Trace_Response, line, ok, ms);
+}
+
+
+/*!
+ * @brief records one measured exposure frame with its DAC codes and I/V readings
+ *
+ * @param[in] channels - LED channels
+ * @param[in] dac, V, I - per channel
+ * @param[in] zones - EXPOSURE_ZONES values
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::sample(int channels, const int *dac, const double *V, const double *I, const int *zones)
+{
+    if (!m_file.isOpen())
+    {
+        return;
+    }
+
+    channels = qBound(0, channels, LED_CHANNELS_MAX);
+    begin(CTraceRecord::Trace_Sample, 16 + 30*channels + 10*EXPOSURE_ZONES);
+    putVarint(m_record, channels);
+    for (int c=0; c<channels; c++)
+    {
+        qint64 uV = qRound64(V[c] * 1e6);
+        qint64 uA = qRound64(I[c] * 1e6);
+        putSigned(m_record, dac[c] - m_state.m_dac[c]);
+        putSigned(m_record, uV - m_state.m_uV[c]);
+        putSigned(m_record, uA - m_state.m_uA[c]);
+        m_state.m_dac[c] = dac[c];
+        m_state.m_uV[c] = uV;
+        m_state.m_uA[c] = uA;
+    }
+    for (int i=0; i<EXPOSURE_ZONES; i++)
+    {
+        putSigned(m_record, zones[i] - m_state.m_zones[i]);
+        m_state.m_zones[i] = zones[i];
+    }
+    write();
+}
+
+
+/*!
+ * @brief records the start of a calibration
+ *
+ * @param[in] serialNumber - serial number of the unit
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::run(const QString &serialNumber)
+{
+    if (!m_file.isOpen())
+    {
+        return;
+    }
+
+    QByteArray utf8 = serialNumber.toUtf8().left(TRACE_TEXT_MAX);
+    indexRun(utf8);
+    begin(CTraceRecord::Trace_Run, 16 + utf8.size());
+    putVarint(m_record, utf8.size());
+    m_record.append(utf8);
+    write();
+}
+
+
+/*!
+ * @brief returns microseconds since the epoch, never going back while open
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+qint64 CTraceWriter::now() const
+{
+    return(m_epoch + m_clock.nsecsElapsed() / 1000);
+}
+
+
+/*!
+ * @brief starts encoding a record, and a new block if it might not fit
+ *
+ * @param[in] type - one of the RecordType values
+ * @param[in] maxSize - most bytes the record can take
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::begin(int type, int maxSize)
+{
+    qint64 time = now();
+
+    if ((m_blockUsed > 0) && (m_blockUsed + maxSize > TRACE_BLOCK_SIZE))
+    {
+        m_file.write(QByteArray(TRACE_BLOCK_SIZE - m_blockUsed, '\0'));
+        m_blockUsed = 0;
+    }
+    if (m_blockUsed == 0)
+    {
+        QByteArray header(TRACE_HEADER_SIZE, '\0');
+        uchar *h = (uchar *)header.data();
+        qToLittleEndian<quint32>(TRACE_MAGIC, h);
+        qToLittleEndian<qint64>(time, h+8);
+        qToLittleEndian<qint64>(m_records, h+16);
+        m_file.write(header);
+        m_blockUsed = TRACE_HEADER_SIZE;
+        m_state.reset(time);
+    }
+
+    m_record.clear();
+    m_record.append((char)type);
+    putSigned(m_record, time - m_state.m_time);
+    m_state.m_time = time;
+}
+
+
+void CTraceWriter::text(int type, const QByteArray &text, bool ok, int ms)
+{
+    if (!m_file.isOpen())
+    {
+        return;
+    }
+
+    QByteArray line = text.left(TRACE_TEXT_MAX);
+    while (line.endsWith('\n') || line.endsWith('\r'))
+    {
+        line.chop(1);
+    }
+    begin(type, 32 + line.size());
+    m_record.append((char)(ok ? 1 : 0));
+    putVarint(m_record, qMax(ms, 0));
+    putVarint(m_record, line.size());
+    m_record.append(line);
+    write();
+}
+
+
+/*!
+ * @brief writes the encoded record
+ *
+ * A trace that can not be written is closed, so a full disk leaves a
+ * file that still reads to its last complete record.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceWriter::write()
+{
+    if (m_file.write(m_record) != m_record.size())
+    {
+        close();
+        return;
+    }
+    m_blockUsed += m_record.size();
+    m_records++;
+}
+
+
+CTraceReader::CTraceReader()
+{
+    m_data = 0;
+    m_size = 0;
+    m_blocks = 0;
+    m_block = 0;
+    m_pos = 0;
+    m_number = 0;
+    m_state.reset(0);
+    m_indexed = false;
+}
+
+
+CTraceReader::~CTraceReader()
+{
+    close();
+}
+
+
+/*!
+ * @brief maps a trace and positions at its first record
+ *
+ * @param[in] fileName - the trace file
+ * @return false if it could not be mapped or is not a trace
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::open(QString fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return(false);
+    }
+    m_size = m_file.size();
+    m_data = (m_size >= TRACE_HEADER_SIZE) ? m_file.map(0, m_size) : 0;
+    if (!m_data)
+    {
+        close();
+        return(false);
+    }
+    m_blocks = (m_size + TRACE_BLOCK_SIZE - 1) / TRACE_BLOCK_SIZE;
+
+    if (!startBlock(0))
+    {
+        close();
+        return(false);
+    }
+
+    loadIndex(fileName);
+    return(true);
+}
+
+
+void CTraceReader::close()
+{
+    if (m_data)
+    {
+        m_file.unmap((uchar *)m_data);
+        m_data = 0;
+    }
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+    m_size = 0;
+    m_blocks = 0;
+    m_runs.clear();
+    m_indexed = false;
+}
+
+
+/*!
+ * @brief positions at the first record at or after a time
+ *
+ * @param[in] time - microseconds since the epoch
+ * @return false if there is no such record
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::seekTime(qint64 time)
+{
+    return(seek(true, time));
+}
+
+
+/*!
+ * @brief positions at a record
+ *
+ * @param[in] number - number of the record, from 0
+ * @return false if the trace has fewer records
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::seekRecord(qint64 number)
+{
+    return(seek(false, number));
+}
+
+
+/*!
+ * @brief positions at the run record of a unit
+ *
+ * The record numbers of the unit's runs are found by a binary search of
+ * the serial number index.  A trace without an index is read from the
+ * start instead.
+ *
+ * @param[in] serialNumber - serial number of the unit
+ * @param[in] run - which of the unit's runs, from 0 for the first;
+ *                  negative counts back from the last, which is -1
+ * @return false if the trace has no such run
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::seekSerial(const QString &serialNumber, int run)
+{
+    if (!m_data)
+    {
+        return(false);
+    }
+
+    CTraceRecord record;
+    QList<qint64> numbers;
+    if (m_indexed)
+    {
+        CTraceRun key;
+        key.m_serialNumber = serialNumber;
+        QList<CTraceRun>::const_iterator it =
+            std::lower_bound(m_runs.constBegin(), m_runs.constEnd(), key, runBefore);
+        for ( ; (it != m_runs.constEnd()) && (it->m_serialNumber == serialNumber); ++it)
+        {
+            numbers.append(it->m_number);
+        }
+    }
+    else if (startBlock(0))
+    {
+        while (next(&record))
+        {
+            if ((record.m_type == CTraceRecord::Trace_Run) && (record.m_text == serialNumber))
+            {
+                numbers.append(record.m_number);
+            }
+        }
+    }
+
+    if (run < 0)
+    {
+        run += numbers.size();
+    }
+    if ((run < 0) || (run >= numbers.size()))
+    {
+        return(false);
+    }
+
+    //
+    // Until the trace is opened for appending again, the index can still
+    // hold a run the trace lost in a crash
+    //
+    if (    !seekRecord(numbers[run])
+         || !next(&record)
+         || (record.m_type != CTraceRecord::Trace_Run)
+         || (record.m_text != serialNumber) )
+    {
+        return(false);
+    }
+    return(seekRecord(numbers[run]));
+}
+
+
+/*!
+ * @brief positions after the last complete record
+ *
+ * position() is then where a writer continues and recordNumber() the
+ * number of records in the file.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::seekEnd()
+{
+    if (!m_data)
+    {
+        return(false);
+    }
+
+    //
+    // The header of the last block can be cut off, too
+    //
+    qint64 block = m_blocks - 1;
+    while ((block > 0) && !startBlock(block))
+    {
+        block--;
+    }
+    if ((block == 0) && !startBlock(0))
+    {
+        return(false);
+    }
+
+    CTraceRecord record;
+    while (decode(&record))
+    {
+    }
+    return(true);
+}
+
+
+/*!
+ * @brief reads the next record
+ *
+ * @param[out] record - the record
+ * @return false at the end of the trace
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::next(CTraceRecord *record)
+{
+    while (m_data)
+    {
+        if (decode(record))
+        {
+            return(true);
+        }
+
+        //
+        // The rest of the block is padding, or a record cut off by a crash
+        //
+        if (!startBlock(m_block+1))
+        {
+            return(false);
+        }
+    }
+    return(false);
+}
+
+
+bool CTraceReader::readHeader(qint64 block, qint64 *time, qint64 *number) const
+{
+    qint64 offset = block * TRACE_BLOCK_SIZE;
+    if ((block < 0) || (offset + TRACE_HEADER_SIZE > m_size))
+    {
+        return(false);
+    }
+
+    const uchar *h = m_data + offset;
+    if (qFromLittleEndian<quint32>(h) != TRACE_MAGIC)
+    {
+        return(false);
+    }
+    *time = qFromLittleEndian<qint64>(h+8);
+    *number = qFromLittleEndian<qint64>(h+16);
+    return(true);
+}
+
+
+bool CTraceReader::startBlock(qint64 block)
+{
+    qint64 time;
+    qint64 number;
+    if (!readHeader(block, &time, &number))
+    {
+        return(false);
+    }
+    m_block = block;
+    m_pos = block * TRACE_BLOCK_SIZE + TRACE_HEADER_SIZE;
+    m_number = number;
+    m_state.reset(time);
+    return(true);
+}
+
+
+/*!
+ * @brief binary search for the block to start looking for a time or record in
+ *
+ * @param[in] byTime - true to search by time, false by record number
+ * @param[in] value - the time or record number
+ * @return the last block whose first record is before the value, 0 if none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+qint64 CTraceReader::findBlock(bool byTime, qint64 value) const
+{
+    qint64 time;
+    qint64 number;
+
+    qint64 lo = 0;
+    qint64 hi = m_blocks - 1;
+    while ((hi > 0) && !readHeader(hi, &time, &number))
+    {
+        hi--;
+    }
+    while (lo < hi)
+    {
+        qint64 mid = (lo + hi + 1) / 2;
+        if (!readHeader(mid, &time, &number) || ((byTime ? time : number) < value))
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return(lo);
+}
+
+
+bool CTraceReader::seek(bool byTime, qint64 value)
+{
+    if (!m_data || !startBlock(findBlock(byTime, value)))
+    {
+        return(false);
+    }
+
+    CTraceRecord record;
+    for (;;)
+    {
+        qint64 block = m_block;
+        qint64 pos = m_pos;
+        qint64 number = m_number;
+        CTraceState state = m_state;
+        if (!next(&record))
+        {
+            return(false);
+        }
+        if ((byTime ? record.m_time : record.m_number) >= value)
+        {
+            m_block = block;
+            m_pos = pos;
+            m_number = number;
+            m_state = state;
+            return(true);
+        }
+    }
+}
+
+
+/*!
+ * @brief decodes the record at m_pos of the current block
+ *
+ * @param[out] record - the record
+ * @return false at the end of the block's records or at a cut-off
+ *         record; nothing is consumed then
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool CTraceReader::decode(CTraceRecord *record)
+{
+    qint64 end = qMin((m_block+1) * TRACE_BLOCK_SIZE, m_size);
+    qint64 pos = m_pos;
+    CTraceState state = m_state;
+
+    if ((pos >= end) || (m_data[pos] == CTraceRecord::Trace_None))
+    {
+        return(false);
+    }
+    int type = m_data[pos++];
+
+    qint64 delta;
+    if (!getSigned(m_data, end, &pos, &delta))
+    {
+        return(false);
+    }
+    state.m_time += delta;
+
+    quint64 n;
+    switch (type)
+    {
+    case CTraceRecord::Trace_Command:
+    case CTraceRecord::Trace_Response:
+        {
+            if (pos >= end)
+            {
+                return(false);
+            }
+            record->m_ok = (m_data[pos++] & 1) != 0;
+            quint64 ms;
+            if (    !getVarint(m_data, end, &pos, &ms)
+                 || !getVarint(m_data, end, &pos, &n)
+                 || (n > (quint64)(end - pos)) )
+            {
+                return(false);
+            }
+            record->m_ms = (int)ms;
+            record->m_text = QString::fromLatin1((const char *)m_data + pos, (int)n);
+            pos += n;
+        }
+        break;
+
+    case CTraceRecord::Trace_Sample:
+        if (!getVarint(m_data, end, &pos, &n) || (n > LED_CHANNELS_MAX))
+        {
+            return(false);
+        }
+        record->m_channels = (int)n;
+        for (int c=0; c<record->m_channels; c++)
+        {
+            qint64 dDac, dV, dI;
+            if (    !getSigned(m_data, end, &pos, &dDac)
+                 || !getSigned(m_data, end, &pos, &dV)
+                 || !getSigned(m_data, end, &pos, &dI) )
+            {
+                return(false);
+            }
+            state.m_dac[c] += dDac;
+            state.m_uV[c] += dV;
+            state.m_uA[c] += dI;
+            record->m_dac[c] = (int)state.m_dac[c];
+            record->m_V[c] = state.m_uV[c] / 1e6;
+            record->m_I[c] = state.m_uA[c] / 1e6;
+        }
+        for (int i=0; i<EXPOSURE_ZONES; i++)
+        {
+            qint64 d;
+            if (!getSigned(m_data, end, &pos, &d))
+            {
+                return(false);
+            }
+            state.m_zones[i] += d;
+            record->m_zones[i] = (int)state.m_zones[i];
+        }
+        break;
+
+    case CTraceRecord::Trace_Run:
+        if (!getVarint(m_data, end, &pos, &n) || (n > (quint64)(end - pos)))
+        {
+            return(false);
+        }
+        record->m_text = QString::fromUtf8((const char *)m_data + pos, (int)n);
+        pos += n;
+        break;
+
+    default:
+        return(false);
+    }
+
+    record->m_type = type;
+    record->m_time = state.m_time;
+    record->m_number = m_number;
+    m_pos = pos;
+    m_state = state;
+    m_number++;
+    return(true);
+}
+
+
+/*!
+ * @brief reads the serial number index of the trace and sorts it by serial number
+ *
+ * The entries are in record order and the sort is stable, so the runs of
+ * a unit stay in the order they were recorded.
+ *
+ * @param[in] fileName - the trace file
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTraceReader::loadIndex(const QString &fileName)
+{
+    m_runs.clear();
+
+    QFile file(fileName + TRACE_INDEX_SUFFIX);
+    m_indexed = file.open(QIODevice::ReadOnly);
+    if (!m_indexed)
+    {
+        return;
+    }
+
+    QByteArray data = file.readAll();
+    readRuns((const uchar *)data.constData(), data.size(), -1, &m_runs);
+    std::stable_sort(m_runs.begin(), m_runs.end(), runBefore);
+}
@@ -0,0 +1,204 @@
+/*!
+ * @file TraceFile.h
+ * @brief Declares the binary trace of the serial traffic and the measurements
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *   2      | agent        | 10/18/2026  | serial number index of the runs
+ *
+*/
+
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QFile>
+#include <QElapsedTimer>
+#include "LedChannels.h"
+#include "ExposureAccumulator.h"
+
+#define TRACE_BLOCK_SIZE    65536       // bytes of a block, the unit of seeking
+#define TRACE_HEADER_SIZE   24          // bytes of the header at the start of every block
+#define TRACE_TEXT_MAX      1024        // longest command or response kept, longer ones are cut
+#define TRACE_INDEX_SUFFIX  ".runs"     // serial number index, next to the trace
+
+
+/*!
+ * One record of a trace
+ */
+class CTraceRecord
+{
+public:
+    //! kind of record
+    enum RecordType
+    {
+        Trace_None,
+        Trace_Command,          // a command was sent; m_ok if it was echoed
+        Trace_Response,         // a response line; not m_ok if it timed out
+        Trace_Sample,           // DAC codes, I/V and exposure of one measured frame
+        Trace_Run               // a calibration started; m_text is the unit's serial number
+    };
+
+public:
+    CTraceRecord();
+
+public:
+    int     m_type;
+    qint64  m_number;           // number of the record in the file, from 0
+    qint64  m_time;             // microseconds since the epoch (UTC)
+    bool    m_ok;
+    int     m_ms;               // command and response: ms since the command was sent
+    QString m_text;             // command, response or serial number
+    int     m_channels;         // sample: LED channels
+    int     m_dac[LED_CHANNELS_MAX];
+    double  m_V[LED_CHANNELS_MAX];
+    double  m_I[LED_CHANNELS_MAX];
+    int     m_zones[EXPOSURE_ZONES];
+};
+
+
+/*!
+ * One entry of the serial number index: a Trace_Run record
+ */
+class CTraceRun
+{
+public:
+    QString m_serialNumber;
+    qint64  m_number;           // number of the run record in the trace
+};
+
+
+/*!
+ * What the records of a block are delta encoded against.  Reset at the
+ * start of every block so decoding can begin at any block.
+ */
+class CTraceState
+{
+public:
+    void reset(qint64 time);
+
+public:
+    qint64  m_time;             // time of the previous record
+    qint64  m_dac[LED_CHANNELS_MAX];    // values of the previous sample
+    qint64  m_uV[LED_CHANNELS_MAX];
+    qint64  m_uA[LED_CHANNELS_MAX];
+    qint64  m_zones[EXPOSURE_ZONES];
+};
+
+
+/*!
+ * Appends records to a trace file.
+ *
+ * The file is a sequence of TRACE_BLOCK_SIZE blocks.  Every block starts
+ * with a header holding the time and number of its first record; the
+ * records follow, with all numbers as varints and the times and sample
+ * values as zigzag deltas of the previous record in the block.  A record
+ * that does not fit into the rest of a block starts the next one, the
+ * rest is zero.  A typical record takes 3 to 30 bytes, a sample 40 or so
+ * unless the exposure jumps.
+ *
+ * Records are written as they happen and never rewritten.  Reopening a
+ * file cuts off a record left incomplete by a crash and continues in a
+ * new block.
+ *
+ * Serial numbers are in no order, so the run records can not be found
+ * through the block headers.  Every run is also appended to a small
+ * index file next to the trace (TRACE_INDEX_SUFFIX).  A missing index is
+ * rebuilt from the trace when it is opened for appending.
+ */
+class CTraceWriter
+{
+public:
+    CTraceWriter();
+    ~CTraceWriter();
+
+public:
+    bool open(QString fileName);
+    void close();
+    bool isOpen() const { return(m_file.isOpen()); }
+    QString fileName() const { return(m_file.fileName()); }
+
+    void command(const QByteArray &command, bool ok, int ms);
+    void response(const QByteArray &line, bool ok, int ms);
+    void sample(int channels, const int *dac, const double *V, const double *I, const int *zones);
+    void run(const QString &serialNumber);
+
+private:
+    qint64 now() const;
+    void   begin(int type, int maxSize);
+    void   text(int type, const QByteArray &text, bool ok, int ms);
+    void   write();
+    void   openIndex(const QString &fileName);
+    void   indexRun(const QByteArray &serialNumber);
+
+private:
+    QFile          m_file;
+    QFile          m_index;         // serial number index, closed if it could not be written
+    QElapsedTimer  m_clock;         // monotonic time since m_epoch
+    qint64         m_epoch;         // wall clock time of the open, microseconds
+    qint64         m_blockUsed;     // bytes of the current block written, 0 at a block boundary
+    qint64         m_records;       // records in the file
+    CTraceState    m_state;
+    QByteArray     m_record;        // record being encoded
+};
+
+
+/*!
+ * Reads a trace file through a memory mapping.
+ *
+ * Opening maps the file and reads only the serial number index, so a
+ * trace of any size opens at once.  seekTime() and seekRecord() binary
+ * search the block headers and then decode forward within one block;
+ * seekSerial() binary searches the index for the record number.
+ */
+class CTraceReader
+{
+public:
+    CTraceReader();
+    ~CTraceReader();
+
+public:
+    bool open(QString fileName);
+    void close();
+    qint64 blockCount() const { return(m_blocks); }
+
+    bool seekTime(qint64 time);
+    bool seekRecord(qint64 number);
+    bool seekSerial(const QString &serialNumber, int run = 0);
+    bool seekEnd();
+    bool hasSerialIndex() const { return(m_indexed); }
+    bool next(CTraceRecord *record);
+    qint64 position() const { return(m_pos); }
+    qint64 recordNumber() const { return(m_number); }
+
+private:
+    bool readHeader(qint64 block, qint64 *time, qint64 *number) const;
+    bool startBlock(qint64 block);
+    qint64 findBlock(bool byTime, qint64 value) const;
+    bool seek(bool byTime, qint64 value);
+    bool decode(CTraceRecord *record);
+    void loadIndex(const QString &fileName);
+
+private:
+    QFile        m_file;
+    const uchar *m_data;        // the mapped file, 0 if not open
+    qint64       m_size;
+    qint64       m_blocks;      // blocks in the file, the last one possibly partial
+    qint64       m_block;       // block being read
+    qint64       m_pos;         // offset of the next record
+    qint64       m_number;      // number of the next record
+    CTraceState  m_state;
+    QList<CTraceRun> m_runs;    // the serial number index, sorted by serial number
+    bool         m_indexed;     // the index was found
+};
+
+#endif // TRACEFILE_H
@@ -0,0 +1,334 @@
+/*!
+ * @file TrendPlot.cpp
+ * @brief Implements the live time-series plot of the measurements
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#include <QPainter>
+#include <QPolygonF>
+#include "TrendPlot.h"
+
+//
+// Interval between repaints
+//
+const int c_repaintMS = 50;
+
+//
+// The time axis shows at least this many buckets, so a short run does not
+// fill the whole width
+//
+const int c_minVisibleBuckets = 300;
+
+//
+// Colours and names of the series, in the order of TrendSeries
+//
+static const Qt::GlobalColor c_seriesColor[TREND_SERIES] =
+{
+    Qt::blue, Qt::red, Qt::blue, Qt::red, Qt::blue, Qt::red, Qt::darkGreen
+};
+static const char *c_seriesName[TREND_SERIES] =
+{
+    "DAC1", "DAC2", "I1", "I2", "V1", "V2", "Exposure"
+};
+
+
+void CTrendBucket::clear()
+{
+    for (int i=0; i<TREND_SERIES; i++)
+    {
+        m_valid[i] = false;
+    }
+}
+
+
+void CTrendBucket::add(int series, double value)
+{
+    if (!m_valid[series])
+    {
+        m_valid[series] = true;
+        m_min[series] = m_max[series] = value;
+    }
+    else
+    {
+        m_min[series] = qMin(m_min[series], (float)value);
+        m_max[series] = qMax(m_max[series], (float)value);
+    }
+    m_last[series] = value;
+}
+
+
+/*!
+ * @brief adds a later bucket into this one
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTrendBucket::merge(const CTrendBucket &other)
+{
+    for (int i=0; i<TREND_SERIES; i++)
+    {
+        if (!other.m_valid[i])
+        {
+            continue;
+        }
+        if (!m_valid[i])
+        {
+            m_valid[i] = true;
+            m_min[i] = other.m_min[i];
+            m_max[i] = other.m_max[i];
+        }
+        else
+        {
+            m_min[i] = qMin(m_min[i], other.m_min[i]);
+            m_max[i] = qMax(m_max[i], other.m_max[i]);
+        }
+        m_last[i] = other.m_last[i];
+    }
+}
+
+
+CTrendBuffer::CTrendBuffer()
+{
+    clear();
+}
+
+
+void CTrendBuffer::clear()
+{
+    m_count = 0;
+    m_bucketMS = TREND_BUCKET_MS;
+}
+
+
+/*!
+ * @brief adds a sample
+ *
+ * @param[in] series - one of the TrendSeries values
+ * @param[in] timeMS - time of the sample since the start of the run
+ * @param[in] value - the sample
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTrendBuffer::add(int series, qint64 timeMS, double value)
+{
+    if ((series < 0) || (series >= TREND_SERIES) || (timeMS < 0))
+    {
+        return;
+    }
+
+    while (timeMS / m_bucketMS >= TREND_BUCKETS)
+    {
+        decimate();
+    }
+
+    int index = timeMS / m_bucketMS;
+    while (m_count <= index)
+    {
+        m_buckets[m_count++].clear();
+    }
+    m_buckets[index].add(series, value);
+}
+
+
+/*!
+ * @brief halves the time resolution by merging neighbouring buckets
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTrendBuffer::decimate()
+{
+    int count = 0;
+    for (int i=0; i<m_count; i+=2)
+    {
+        m_buckets[count] = m_buckets[i];
+        if (i+1 < m_count)
+        {
+            m_buckets[count].merge(m_buckets[i+1]);
+        }
+        count++;
+    }
+    m_count = count;
+    m_bucketMS *= 2;
+}
+
+
+/*!
+ * @brief constructor
+ *
+ * @param[in] parent - parent widget
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+CTrendPlot::CTrendPlot(QWidget *parent) :
+    QWidget(parent)
+{
+    m_clock.start();
+
+    m_repaintTimer.setSingleShot(true);
+    m_repaintTimer.setInterval(c_repaintMS);
+    connect(&m_repaintTimer, SIGNAL(timeout()), this, SLOT(update()));
+}
+
+
+/*!
+ * @brief forgets all samples and restarts the time axis
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTrendPlot::clear()
+{
+    m_buffer.clear();
+    m_clock.restart();
+    update();
+}
+
+
+void CTrendPlot::addSample(int series, double value)
+{
+    m_buffer.add(series, m_clock.elapsed(), value);
+    if (!m_repaintTimer.isActive())
+    {
+        m_repaintTimer.start();
+    }
+}
+
+
+QSize CTrendPlot::sizeHint() const
+{
+    return(QSize(400, 240));
+}
+
+
+QSize CTrendPlot::minimumSizeHint() const
+{
+    return(QSize(200, 160));
+}
+
+
+/*!
+ * @brief draws the four panes and the length of the time axis
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTrendPlot::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    int footer = fontMetrics().height();
+    double paneHeight = (height() - footer) / 4.0;
+    paintPane(painter, QRectF(0, 0*paneHeight, width(), paneHeight), Trend_Dac1, Trend_Dac2, "DAC");
+    paintPane(painter, QRectF(0, 1*paneHeight, width(), paneHeight), Trend_I1, Trend_I2, "A");
+    paintPane(painter, QRectF(0, 2*paneHeight, width(), paneHeight), Trend_V1, Trend_V2, "V");
+    paintPane(painter, QRectF(0, 3*paneHeight, width(), paneHeight), Trend_Exposure, Trend_Exposure, "Exposure");
+
+    int visible = qMax(m_buffer.count(), c_minVisibleBuckets);
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(QRectF(0, height() - footer, width(), footer), Qt::AlignRight | Qt::AlignVCenter,
+                     QString("%1 s").arg(visible * m_buffer.bucketMS() / 1000.0, 0, 'f', 0));
+}
+
+
+/*!
+ * @brief draws the series first..last into one pane with a common scale
+ *
+ * Every bucket contributes its minimum and maximum, so the line shows the
+ * full range of the samples however many were merged into a bucket.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void CTrendPlot::paintPane(QPainter &painter, const QRectF &area, int first, int last, const char *title)
+{
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawRect(area.adjusted(0, 0, -1, -1));
+
+    //
+    // Scale of the pane
+    //
+    bool found = false;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    for (int i=0; i<m_buffer.count(); i++)
+    {
+        const CTrendBucket &bucket = m_buffer.bucket(i);
+        for (int s=first; s<=last; s++)
+        {
+            if (!bucket.m_valid[s])
+            {
+                continue;
+            }
+            if (!found)
+            {
+                minimum = bucket.m_min[s];
+                maximum = bucket.m_max[s];
+                found = true;
+            }
+            minimum = qMin(minimum, (double)bucket.m_min[s]);
+            maximum = qMax(maximum, (double)bucket.m_max[s]);
+        }
+    }
+    if (maximum - minimum < 1e-6)
+    {
+        maximum = minimum + 1.0;
+    }
+
+    QRectF plot = area.adjusted(2, 2, -2, -2);
+    double xScale = plot.width() / qMax(m_buffer.count(), c_minVisibleBuckets);
+    double yScale = plot.height() / (maximum - minimum);
+
+    //
+    // Series, with the last value of each in the legend
+    //
+    QString legend = QString("%1  ").arg(title);
+    for (int s=first; s<=last; s++)
+    {
+        QPolygonF line;
+        double latest = 0.0;
+        for (int i=0; i<m_buffer.count(); i++)
+        {
+            const CTrendBucket &bucket = m_buffer.bucket(i);
+            if (!bucket.m_valid[s])
+            {
+                continue;
+            }
+            double x = plot.left() + (i + 0.5) * xScale;
+            line << QPointF(x, plot.bottom() - (bucket.m_min[s] - minimum) * yScale);
+            if (bucket.m_max[s] != bucket.m_min[s])
+            {
+                line << QPointF(x, plot.bottom() - (bucket.m_max[s] - minimum) * yScale);
+            }
+            latest = bucket.m_last[s];
+        }
+        if (line.isEmpty())
+        {
+            continue;
+        }
+        painter.setPen(c_seriesColor[s]);
+        painter.drawPolyline(line);
+        legend.append(QString("%1=%2  ").arg(c_seriesName[s]).arg(latest, 0, 'g', 5));
+    }
+
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(plot, Qt::AlignLeft | Qt::AlignTop, legend);
+    if (found)
+    {
+        painter.drawText(plot, Qt::AlignRight | Qt::AlignTop, QString::number(maximum, 'g', 5));
+        painter.drawText(plot, Qt::AlignRight | Qt::AlignBottom, QString::number(minimum, 'g', 5));
+    }
+}
@@ -0,0 +1,128 @@
+/*!
+ * @file TrendPlot.h
+ * @brief Declares the live time-series plot of the measurements
+ *
+ * @author    	agent
+ * @date        10/18/2026
+ * @copyright	(C) Copyright Enercon Technologies 2026, All rights reserved.
+ *
+ * Revision History
+ * ----------------
+ *  Version | Author       | Date        | Description
+ *  :--:    | :-----       | :--:        | :----------
+ *   1      | agent        | 10/18/2026  | initial version
+ *
+*/
+
+#ifndef TRENDPLOT_H
+#define TRENDPLOT_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#define TREND_BUCKETS       512     // buckets kept, whatever the length of the run
+#define TREND_BUCKET_MS     100     // width of a bucket before any decimation
+
+
+/*!
+ * Quantities shown by the plot
+ */
+enum TrendSeries
+{
+    Trend_Dac1,
+    Trend_Dac2,
+    Trend_I1,
+    Trend_I2,
+    Trend_V1,
+    Trend_V2,
+    Trend_Exposure,         // total exposure over all zones
+    TREND_SERIES
+};
+
+
+/*!
+ * Minimum, maximum and last value of every series over one time bucket
+ */
+class CTrendBucket
+{
+public:
+    void    clear();
+    void    add(int series, double value);
+    void    merge(const CTrendBucket &other);
+
+public:
+    bool    m_valid[TREND_SERIES];
+    float   m_min[TREND_SERIES];
+    float   m_max[TREND_SERIES];
+    float   m_last[TREND_SERIES];
+};
+
+
+/*!
+ * Fixed-size store of the samples with min/max decimation.
+ *
+ * Samples are binned into TREND_BUCKETS buckets of equal width.  When the
+ * run outgrows the buckets, neighbouring buckets are merged pairwise and
+ * the width doubles, so the whole run is kept at a resolution that adapts
+ * to its length.  Memory and drawing time are the same for a 30 s
+ * calibration and a soak test of several hours, and a spike survives the
+ * decimation in the bucket's maximum.
+ */
+class CTrendBuffer
+{
+public:
+    CTrendBuffer();
+
+    void    clear();
+    void    add(int series, qint64 timeMS, double value);
+
+    int     count() const       { return(m_count); }
+    qint64  bucketMS() const    { return(m_bucketMS); }
+    const CTrendBucket &bucket(int i) const { return(m_buckets[i]); }
+
+private:
+    void    decimate();
+
+private:
+    CTrendBucket m_buckets[TREND_BUCKETS];
+    int          m_count;       // buckets in use
+    qint64       m_bucketMS;    // width of a bucket
+};
+
+
+/*!
+ * Plots the DAC codes, the LED currents and voltages and the total
+ * exposure against time, in four panes sharing the time axis.
+ *
+ * Samples only mark the plot dirty; it is repainted at most once per
+ * c_repaintMS however fast the samples arrive.
+ *
+ * Used as a promoted widget in mainwindow.ui.
+ */
+class CTrendPlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CTrendPlot(QWidget *parent = 0);
+
+    void    clear();
+    void    addSample(int series, double value);
+
+    QSize   sizeHint() const;
+    QSize   minimumSizeHint() const;
+
+protected:
+    void    paintEvent(QPaintEvent *event);
+
+private:
+    void    paintPane(QPainter &painter, const QRectF &area, int first, int last, const char *title);
+
+private:
+    CTrendBuffer  m_buffer;
+    QElapsedTimer m_clock;          // time since clear()
+    QTimer        m_repaintTimer;   // pending repaint, single shot
+};
+
+#endif // TRENDPLOT_H
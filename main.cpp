@@ -1,8 +1,20 @@
 #include "mainwindow.h"
+#include "CommandLine.h"
 #include <QApplication>
+#include <QCoreApplication>
 
 int main(int argc, char *argv[])
 {
+    //
+    // Headless mode: no QApplication, so no display server is needed
+    //
+    if (CCommandLine::isRequested(argc, argv))
+    {
+        QCoreApplication app(argc, argv);
+        CCommandLine commandLine;
+        return(commandLine.run(app.arguments()));
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -11,21 +11,77 @@
  *  Version | Author       | Date        | Description
  *  :--:    | :-----       | :--:        | :----------
  *   1      | J. Peterson  | 01/12/2015  | initial version
+ *   2      | agent        | 10/18/2026  | calibration moved to CCalibrationEngine, added stations
+ *   3      | agent        | 10/18/2026  | calibration runs without blocking the window
+ *   4      | agent        | 10/18/2026  | reports reloads of the calibration profile
+ *   5      | agent        | 10/18/2026  | readings and thresholds as one value per LED channel
+ *   6      | agent        | 10/18/2026  | real-time mode of the serial timing
+ *   7      | agent        | 10/18/2026  | real-time mode only in the engine threads
  *
 */
 
 #include <QMessageBox>
 #include <QFileInfo>
 #include <QDir>
+#include <QTableWidgetItem>
+#include <QDateTime>
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
-#include "SerialPortDialog.h"
+#include "TrendPlot.h"
+#include "serialportdialog.h"
 #include "Snooze.h"
 
 
 #define NOT_SELECTED "not selected"
 
 
+/*!
+ * @brief sets the text of a field only if it changed
+ *
+ * The monitor refreshes the same values over and over; skipping unchanged
+ * text avoids needless repaints.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static void setFieldText(QLineEdit *field, const QString &text)
+{
+    if (field->text() != text)
+    {
+        field->setText(text);
+    }
+}
+
+//
+// The form has fields for LED 1 and 2; further channels are in the
+// results and reports only.
+//
+#define FORM_CHANNELS   2
+
+
+/*!
+ * @brief shows the thresholds of the channels the form has fields for
+ *
+ * @param[in] lowField, highField - fields of each channel
+ * @param[in] low, high - thresholds of each channel, -1 for none
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+static void setThresholdFields(QLineEdit **lowField, QLineEdit **highField,
+                               const QVector<int> &low, const QVector<int> &high)
+{
+    QString numStr;
+    for (int c=0; c<FORM_CHANNELS; c++)
+    {
+        int lowValue = low.value(c, -1);
+        int highValue = high.value(c, -1);
+        setFieldText(lowField[c], (lowValue < 0) ? "" : numStr.setNum(lowValue));
+        setFieldText(highField[c], (highValue < 0) ? "" : numStr.setNum(highValue));
+    }
+}
+
+
 /*!
  * @brief constructor for the main window
  *
@@ -60,15 +116,93 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->lineEdit_serialPort->setText(m_serialPortName);
 
     //
-    // initial DAC values
+    // The calibration profile is reloaded whenever the ini file is edited
+    //
+    connect(&m_settings, SIGNAL(profileLoaded(QString)), this, SLOT(onProfileLoaded(QString)));
+    connect(&m_settings, SIGNAL(profileRejected(QString,QString)), this, SLOT(onProfileRejected(QString,QString)));
+
+    //
+    // All report files are written in the background
     //
-    m_dac1 = 0;
-    m_dac2 = 0;
+    m_reportWriter = new CReportWriter(this);
+
+    //
+    // Metrics for the plant monitoring
+    //
+    m_metricsExporter = new CMetricsExporter(&m_settings, this);
+
+    //
+    // Engine for the controller on the primary serial port.  It runs in a
+    // thread of its own, which enters the real-time mode; this thread
+    // never does, so the window does not compete with the serial timing.
+    //
+    m_engineThread = new CRealTimeThread(CRealTimeMode::fromSettings(&m_settings), this);
+    m_engine = new CCalibrationEngine(&m_settings);
+    m_engine->moveToThread(m_engineThread);
+    connect(m_engineThread, SIGNAL(finished()), m_engine, SLOT(deleteLater()));
+    connect(m_engineThread, SIGNAL(realTimeModeIncomplete(QString)),
+            this, SLOT(onRealTimeModeIncomplete(QString)));
+    connect(m_engine, SIGNAL(statusChanged(QString)), this, SLOT(onStatusChanged(QString)));
+    connect(m_engine, SIGNAL(errorOccurred(QString)), this, SLOT(onErrorOccurred(QString)));
+    connect(m_engine, SIGNAL(confirmationRequested(QString)),
+            this, SLOT(onConfirmationRequested(QString)));
+    connect(m_engine, SIGNAL(firmwareVersionChanged(QString,QString,QString)),
+            this, SLOT(onFirmwareVersionChanged(QString,QString,QString)));
+    connect(m_engine, SIGNAL(storedCalibrationChanged(QVector<int>,QVector<int>)),
+            this, SLOT(onStoredCalibrationChanged(QVector<int>,QVector<int>)));
+    connect(m_engine, SIGNAL(currentAndVoltageChanged(bool,QVector<double>,QVector<double>)),
+            this, SLOT(onCurrentAndVoltageChanged(bool,QVector<double>,QVector<double>)));
+    connect(m_engine, SIGNAL(exposureChanged(bool,QVector<double>,QVector<double>,int)),
+            this, SLOT(onExposureChanged(bool,QVector<double>,QVector<double>,int)));
+    connect(m_engine, SIGNAL(dacValuesChanged(bool,QVector<int>)),
+            this, SLOT(onDacValuesChanged(bool,QVector<int>)));
+    connect(m_engine, SIGNAL(newCalibrationChanged(QVector<int>,QVector<int>)),
+            this, SLOT(onNewCalibrationChanged(QVector<int>,QVector<int>)));
+    connect(m_engine, SIGNAL(calibrationFinished(CCalibrationResult)),
+            this, SLOT(onCalibrationFinished(CCalibrationResult)));
+    connect(m_engine, SIGNAL(monitorStateChanged(int)), this, SLOT(onMonitorStateChanged(int)));
+    m_engineThread->start();
+
+    //
+    // Additional stations, each with its own engine in its own thread
+    //
+    m_scheduler = new CStationScheduler(&m_settings, m_reportWriter, this);
+    connect(m_scheduler, SIGNAL(stationStatusChanged(int,QString)),
+            this, SLOT(onStationStatusChanged(int,QString)));
+    connect(m_scheduler, SIGNAL(stationFinished(int,CCalibrationResult)),
+            this, SLOT(onStationFinished(int,CCalibrationResult)));
+    connect(m_scheduler, SIGNAL(stationConfirmationRequested(int,QString)),
+            this, SLOT(onStationConfirmationRequested(int,QString)));
+    connect(m_scheduler, SIGNAL(realTimeModeIncomplete(QString)),
+            this, SLOT(onRealTimeModeIncomplete(QString)));
+    initStationTable();
+
+    //
+    // Automation API for the line-management software
+    //
+    m_automation = 0;
+    if (!m_settings.m_automationServer.isEmpty())
+    {
+        m_automation = new CAutomationServer(m_settings.m_automationServer, this);
+        connect(m_engine, SIGNAL(statusChanged(QString)), m_automation, SLOT(jobStatusChanged(QString)));
+        connect(m_engine, SIGNAL(errorOccurred(QString)), m_automation, SLOT(jobStatusChanged(QString)));
+        connect(m_engine, SIGNAL(calibrationFinished(CCalibrationResult)),
+                m_automation, SLOT(jobFinished(CCalibrationResult)));
+    }
+
+    //
+    // Production queue
+    //
+    m_productionMode = false;
+    m_engineMessage = 0;
+    m_waitForRemoval = false;
+    m_runOrigin = Origin_Operator;
+    m_engineRunning = false;
 
     //
     // Start timer
     //
-    m_timerID = startTimer(3000);
+    m_timerID = startTimer(qMax(m_settings.m_monitorTickMS, 50));
 }
 
 
@@ -86,6 +220,16 @@ MainWindow::~MainWindow()
 {
     killTimer(m_timerID);
 
+    //
+    // The engines use m_settings, so their threads must finish before it
+    // goes; each engine is deleted in its thread as that finishes.  The
+    // report writer goes last so it can write their final records.
+    //
+    delete m_scheduler;
+    m_engineThread->quit();
+    m_engineThread->wait();
+    delete m_reportWriter;
+
     //
     // Save the settings
     //
@@ -99,91 +243,100 @@ MainWindow::~MainWindow()
 void MainWindow::timerEvent(QTimerEvent *)
 {
     //
-    // Try to lock the mutex.
-    // If we can't get it it means that a calibration is in progress.
+    // The monitor shares the port with the calibration, so it pauses
+    // while one is in progress.  The engine does not start a pass while
+    // the last one is still waiting on the controller; the outcome comes
+    // in through onMonitorStateChanged().
     //
-    if (!m_mutex.tryLock())
+    if (!m_engineRunning)
     {
-        return;
+        QMetaObject::invokeMethod(m_engine, "setSerialPortName", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_serialPortName));
+        QMetaObject::invokeMethod(m_engine, "poll", Qt::QueuedConnection);
     }
 
     //
-    // Try to open the serial port
+    // Let old runs age out of the dashboard while the line is idle
     //
-    if (!m_serialBuffer.openPort(m_serialPortName))
+    if (!m_dashboardRefresh.isValid() || m_dashboardRefresh.hasExpired(5000))
     {
-        m_mutex.unlock();
-        clearInfoFields();
-        ui->label_status->setText("idle: No serial connection");
-        qApp->processEvents();
-        return;
+        m_dashboardRefresh.start();
+        updateDashboard();
     }
+}
 
-    //
-    // See if the controller is running
-    //
-    if (m_serialBuffer.checkForEcho() == false)
+
+/*!
+ * @brief shows the outcome of a pass of the idle monitor
+ *
+ * In production mode, or with automation jobs waiting, a newly inserted
+ * unit starts the next calibration.
+ *
+ * @param[in] state - CCalibrationEngine::PollState of the controller
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::onMonitorStateChanged(int state)
+{
+    if (m_engineRunning)
     {
-        m_mutex.unlock();
-        clearInfoFields();
-        ui->label_status->setText("idle: serial connection opened, no communication with controller");
-        qApp->processEvents();
         return;
     }
 
-    //
-    // Turn off the event echoing
-    //
-    if (    (!m_serialBuffer.writeLine("disable_events=1"))
-         || (!m_serialBuffer.writeLine("em_style=0")) )
+    switch (state)
     {
-        m_mutex.unlock();
+    case CCalibrationEngine::Poll_NoSerialPort:
+        clearInfoFields();
+        ui->label_status->setText("idle: No serial connection");
+        break;
+
+    case CCalibrationEngine::Poll_NoEcho:
+        clearInfoFields();
+        ui->label_status->setText("idle: serial connection opened, no communication with controller");
+        break;
+
+    case CCalibrationEngine::Poll_NoResponse:
         clearInfoFields();
         ui->label_status->setText("idle: communication with controller established, but no response to commands.");
-        qApp->processEvents();
-        return;
-    }
-    m_serialBuffer.readString();
+        break;
 
-    //
-    // Get the firmware version
-    //
-    getFirmwareVersion();
+    case CCalibrationEngine::Poll_NoScope:
+        ui->label_status->setText("idle: communication with controller established, no scope detected");
+        clearExposureAndDacFields();
+        break;
 
-    //
-    // Get the current calibration values
-    //
-    getCurrentCalibrationValues();
+    case CCalibrationEngine::Poll_ScopeDetected:
+        ui->label_status->setText("idle: communication with controller established, scope detected");
+        break;
+    }
 
     //
-    // Read the Current and Voltage data
+    // A unit has been removed once the scope is no longer seen
     //
-    getCurrentAndVoltage();
+    bool scopeDetected = (state == CCalibrationEngine::Poll_ScopeDetected);
+    if (!scopeDetected)
+    {
+        m_waitForRemoval = false;
+    }
 
     //
-    // Read the exposure data
+    // In production mode a newly inserted unit starts the next calibration
     //
-    if (!getExposure())
+    if (    m_productionMode
+         && scopeDetected
+         && !m_waitForRemoval
+         && (ui->listWidget_queue->count() > 0) )
     {
-        ui->label_status->setText("idle: communication with controller established, no scope detected");
-        clearExposureAndDacFields();
-        qApp->processEvents();
+        startNextQueuedUnit();
     }
-    else
+    else if (    m_automation
+              && scopeDetected
+              && !m_waitForRemoval
+              && m_automation->hasPendingJob() )
     {
-        ui->label_status->setText("idle: communication with controller established, scope detected");
-        //
-        // Read the LED DAC values
-        //
-        getDacValues();
-        qApp->processEvents();
+        startNextAutomationJob();
     }
-
-
-    //
-    // Unlock the mutex
-    //
-    m_mutex.unlock();
 }
 
 void MainWindow::errorMessage(QString msg)
@@ -204,6 +357,58 @@ bool MainWindow::yesNoMessage(QString msg)
 }
 
 
+/*!
+ * @brief shows an error of a calibration engine without waiting for the operator
+ *
+ * A modal box would hold up the window's handling of every station until
+ * it is closed.  The errors go to a single non-modal box instead, which
+ * shows the latest of them.
+ *
+ * @param[in] msg text of the error
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::engineMessage(QString msg)
+{
+    if (!m_engineMessage)
+    {
+        QString title = QFileInfo( QCoreApplication::applicationFilePath() ).fileName();
+        m_engineMessage = new QMessageBox(QMessageBox::Warning, title, "", QMessageBox::Ok, this);
+        m_engineMessage->setModal(false);
+    }
+    m_engineMessage->setText(msg);
+    m_engineMessage->show();
+    m_engineMessage->raise();
+    ui->statusBar->showMessage(msg.section('\n', 0, 0));
+}
+
+
+/*!
+ * @brief asks the operator whether a calibration may go on
+ *
+ * Nobody is there to answer for a run started by the production queue or
+ * by an automation job, so such a run does not go on and the question is
+ * shown as an error instead of waiting.
+ *
+ * @param[in] msg question to ask
+ * @param[in] unattended - the run was not started by the operator
+ * @return true if the run may go on
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool MainWindow::engineConfirmation(QString msg, bool unattended)
+{
+    if (unattended)
+    {
+        engineMessage(msg.section('\n', 0, 0) + "\nNot confirmed: the run was started by the production queue or automation.");
+        return(false);
+    }
+    return(yesNoMessage(msg));
+}
+
+
 
 
 /*!
@@ -239,29 +444,45 @@ void MainWindow::selectSerialPort()
 */
 void MainWindow::startCalibration()
 {
-    ui->pushButton->setEnabled(false);
+    runCalibration(Origin_Operator);
+}
 
-    m_mutex.lock();
 
-    if (    !checkFields()
-         || !establishConnectionToController()
-         || !getCurrentCalibrationValues()
-         || !checkScope() )
-    {
-        ui->pushButton->setEnabled(true);
-        m_mutex.unlock();
-        return;
-    }
-
-    if (findCalibration())
+/*!
+ * @brief starts a calibration of the unit on the primary serial port
+ *
+ * The outcome arrives in onCalibrationFinished(); the window stays
+ * responsive while the calibration runs.
+ *
+ * @param[in] origin - RunOrigin of the calibration
+ * @param[out] none
+ * @return true if the calibration was started
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+bool MainWindow::runCalibration(int origin)
+{
+    if (m_engineRunning || !checkFields())
     {
-        saveCalibration();
+        return(false);
     }
 
-    m_serialBuffer.writeLine("led=0");
-
-    m_mutex.unlock();
-    ui->pushButton->setEnabled(true);
+    //
+    // The engine is idle, so the run it is handed can not be refused;
+    // the calls are queued in order behind any pass of the monitor.
+    //
+    QMetaObject::invokeMethod(m_engine, "setSerialPortName", Qt::QueuedConnection,
+                              Q_ARG(QString, m_serialPortName));
+    QMetaObject::invokeMethod(m_engine, "start", Qt::QueuedConnection,
+                              Q_ARG(QString, m_operator),
+                              Q_ARG(QString, m_serialNumber));
+    ui->trendPlot->clear();
+
+    m_engineRunning = true;
+    m_runOrigin = origin;
+    ui->pushButton->setEnabled(false);
+    return(true);
 }
 
 
@@ -315,583 +536,563 @@ bool MainWindow::checkFields()
 }
 
 
+void MainWindow::clearInfoFields()
+{
+    setFieldText(ui->lineEdit_ver_ARM, QString());
+    setFieldText(ui->lineEdit_ver_DSP, QString());
+    setFieldText(ui->lineEdit_ver_FPGA, QString());
+    setFieldText(ui->lineEdit_LED1_high, QString());
+    setFieldText(ui->lineEdit_LED1_low, QString());
+    setFieldText(ui->lineEdit_LED2_high, QString());
+    setFieldText(ui->lineEdit_LED2_low, QString());
+    setFieldText(ui->lineEdit_amps1, QString());
+    setFieldText(ui->lineEdit_amps2, QString());
+    setFieldText(ui->lineEdit_volts1, QString());
+    setFieldText(ui->lineEdit_volts2, QString());
+
+    clearExposureAndDacFields();
+}
+
+void MainWindow::clearExposureAndDacFields()
+{
+    ui->exposureHeatmap->clear();
+
+    setFieldText(ui->lineEdit_dac1, QString());
+    setFieldText(ui->lineEdit_dac2, QString());
+}
+
+
 /*!
- * @brief
+ * @brief fills the station table with the configured stations
  *
- * @param[in] none
- * @param[out] none
- * @return none
+ * The group is hidden when no additional stations are configured.
  *
- * @author J. Peterson
- * @date 01/23/2015
+ * @author agent
+ * @date 10/18/2026
 */
-bool MainWindow::establishConnectionToController()
+void MainWindow::initStationTable()
 {
-    //
-    // Open the COM port
-    //
-    ui->label_status->setText("Opening Serial Port...");
-    if (!m_serialBuffer.openPort(m_serialPortName))
-    {
-        QString msg = "The specified serial port could not be opened.";
-        errorMessage(msg);
-        return(false);
-    }
+    int count = m_scheduler->stationCount();
+    ui->groupBox_stations->setVisible(count > 0);
 
-    //
-    // Check that the controller is running
-    //
-    ui->label_status->setText("Checking communication with controller...");
-    if (m_serialBuffer.checkForEcho() == false)
+    ui->tableWidget_stations->setRowCount(count);
+    for (int i=0; i<count; i++)
     {
-        QString msg = "Communication with the controller could not be established.\n\nPort opend successfully.\nCommands are not echoed.";
-        errorMessage(msg);
-        return(false);
-    }
+        QTableWidgetItem *item = new QTableWidgetItem(m_scheduler->stationPort(i));
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        ui->tableWidget_stations->setItem(i, 0, item);
 
-    //
-    // Disable excessive echoing of commands
-    //
-    ui->label_status->setText("Initializing controller settings...");
-    m_serialBuffer.writeLine("disable_events=1");
-    m_serialBuffer.readString();
-#if 0
-    m_serialBuffer.writeLine("gamma=1.0");
-    m_serialBuffer.readString();
-    m_serialBuffer.writeLine("cc_reset");
-    m_serialBuffer.readString();
-#endif
+        ui->tableWidget_stations->setItem(i, 1, new QTableWidgetItem(""));
 
-    //
-    // Check version of the firmware
-    //
-    ui->label_status->setText("Checking firmware version...");
-    int i;
-    m_serialBuffer.writeLine("version");
-    QString ver_FPGA = m_serialBuffer.readString();
-    i = ver_FPGA.indexOf("FPGA: ");
-    ver_FPGA.remove(0, i+6);
-    i = ver_FPGA.indexOf("\r\n");
-    ver_FPGA.truncate(i);
+        item = new QTableWidgetItem(m_scheduler->stationStatus(i));
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        ui->tableWidget_stations->setItem(i, 2, item);
 
-    QString ver_ARM  = m_serialBuffer.readString();
-    i = ver_ARM.indexOf("ARM: ");
-    ver_ARM.remove(0, i+5);
-    i = ver_ARM.indexOf(" ");
-    ver_ARM.truncate(i);
+        item = new QTableWidgetItem("");
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        ui->tableWidget_stations->setItem(i, 3, item);
+    }
+}
 
-    QString ver_DSP  = m_serialBuffer.readString();
-    i = ver_DSP.indexOf("DSP: ");
-    ver_DSP.remove(0, i+5);
-    i = ver_DSP.indexOf(" ");
-    ver_DSP.truncate(i);
 
-    ui->lineEdit_ver_ARM->setText(ver_ARM);
-    ui->lineEdit_ver_DSP->setText(ver_DSP);
-    ui->lineEdit_ver_FPGA->setText(ver_FPGA);
-    qApp->processEvents();
+/*!
+ * @brief called when the "Start Stations" button is pressed
+ *
+ * Queues a calibration on every idle station that has a serial number.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::startStations()
+{
+    m_operator = ui->lineEdit_operator->text();
+    if (m_operator.isEmpty())
+    {
+        errorMessage("An operator name must be entered.");
+        ui->lineEdit_operator->setFocus();
+        return;
+    }
 
-    // jgp - the versions should come from the ini file
-    // jgp - should give the option to continue
-    if (   (ver_ARM != m_settings.m_versionARM)
-           || (ver_DSP != m_settings.m_versionDSP)
-           || (ver_FPGA != m_settings.m_versionFPGA) )
+    int queued = 0;
+    for (int i=0; i<m_scheduler->stationCount(); i++)
     {
-        if (!yesNoMessage("Controller version does not match expected.\nContinue?"))
+        QString serialNumber = ui->tableWidget_stations->item(i, 1)->text().trimmed();
+        if (serialNumber.isEmpty() || m_scheduler->isBusy(i))
+        {
+            continue;
+        }
+        ui->tableWidget_stations->item(i, 3)->setText("");
+        if (m_scheduler->enqueue(i, m_operator, serialNumber))
         {
-            return(false);
+            queued++;
         }
     }
 
-    return(true);
+    if (queued == 0)
+    {
+        errorMessage("Enter a serial number for each idle station to be calibrated.");
+    }
+}
+
+
+void MainWindow::onStatusChanged(QString text)
+{
+    ui->label_status->setText(text);
+}
+
+void MainWindow::onErrorOccurred(QString text)
+{
+    engineMessage(text);
 }
 
 /*!
- * @brief
+ * @brief reports a calibration profile loaded after an edit of the ini file
  *
- * @param[in] none
- * @param[out] none
- * @return none
- *
- * @author J. Peterson
- * @date 01/23/2015
+ * @author agent
+ * @date 10/18/2026
 */
-bool MainWindow::getCurrentCalibrationValues()
+void MainWindow::onProfileLoaded(QString name)
 {
-    m_serialBuffer.writeLine("led_cal");
-    QString calString = m_serialBuffer.readString();
-    QString tmpString;
-    QString numberString;
+    ui->statusBar->showMessage(QString("Calibration profile \"%1\" loaded").arg(name), 10000);
+}
 
-    int i;
-    i = calString.indexOf("low=");
-    if (i >= 0)
+/*!
+ * @brief reports an edit of the ini file whose profile could not be used
+ *
+ * Not a message box: the edit may be half done, and the last valid profile,
+ * if there was one, stays in use meanwhile.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::onProfileRejected(QString name, QString errors)
+{
+    Q_UNUSED(name);
+    if (m_settings.profileErrors().isEmpty())
     {
-        calString.remove(0, i+4);
-        tmpString = calString;
-        i = tmpString.indexOf(" ");
-        if (i >= 0)
-        {
-            tmpString.truncate(i);
-            int lowCal1 = tmpString.toInt();
-            numberString.setNum(lowCal1);
-            ui->lineEdit_LED1_low->setText(numberString);
-        }
+        ui->statusBar->showMessage(errors + " The previous profile stays in use.");
     }
-
-    i = calString.indexOf("high=");
-    if (i >= 0)
+    else
     {
-        calString.remove(0, i+5);
-        tmpString = calString;
-        i = tmpString.indexOf(")");
-        if (i >= 0)
-        {
-            tmpString.truncate(i);
-            int highCal1 = tmpString.toInt();
-            numberString.setNum(highCal1);
-            ui->lineEdit_LED1_high->setText(numberString);
-        }
+        ui->statusBar->showMessage(errors + " No calibration can run until it is corrected.");
     }
+}
 
-    i = calString.indexOf("low=");
-    if (i >= 0)
+void MainWindow::onConfirmationRequested(QString text)
+{
+    QMetaObject::invokeMethod(m_engine, "confirm", Qt::QueuedConnection,
+                              Q_ARG(bool, engineConfirmation(text, m_runOrigin != Origin_Operator)));
+}
+
+void MainWindow::onFirmwareVersionChanged(QString arm, QString dsp, QString fpga)
+{
+    setFieldText(ui->lineEdit_ver_ARM, arm);
+    setFieldText(ui->lineEdit_ver_DSP, dsp);
+    setFieldText(ui->lineEdit_ver_FPGA, fpga);
+}
+
+void MainWindow::onStoredCalibrationChanged(QVector<int> low, QVector<int> high)
+{
+    QLineEdit *lowField[FORM_CHANNELS] = { ui->lineEdit_LED1_low, ui->lineEdit_LED2_low };
+    QLineEdit *highField[FORM_CHANNELS] = { ui->lineEdit_LED1_high, ui->lineEdit_LED2_high };
+    setThresholdFields(lowField, highField, low, high);
+}
+
+void MainWindow::onCurrentAndVoltageChanged(bool valid, QVector<double> V, QVector<double> I)
+{
+    QLineEdit *voltsField[FORM_CHANNELS] = { ui->lineEdit_volts1, ui->lineEdit_volts2 };
+    QLineEdit *ampsField[FORM_CHANNELS] = { ui->lineEdit_amps1, ui->lineEdit_amps2 };
+    const int voltsTrend[FORM_CHANNELS] = { Trend_V1, Trend_V2 };
+    const int ampsTrend[FORM_CHANNELS] = { Trend_I1, Trend_I2 };
+
+    QString numStr;
+    for (int c=0; c<FORM_CHANNELS; c++)
     {
-        calString.remove(0, i+4);
-        tmpString = calString;
-        i = tmpString.indexOf(" ");
-        if (i >= 0)
+        if (!valid || (c >= V.size()))
         {
-            tmpString.truncate(i);
-            int lowCal2 = tmpString.toInt();
-            numberString.setNum(lowCal2);
-            ui->lineEdit_LED2_low->setText(numberString);
+            setFieldText(voltsField[c], QString());
+            setFieldText(ampsField[c], QString());
+            continue;
         }
+        ui->trendPlot->addSample(voltsTrend[c], V[c]);
+        ui->trendPlot->addSample(ampsTrend[c], I[c]);
+        setFieldText(voltsField[c], numStr.setNum(V[c], 'f', 2));
+        setFieldText(ampsField[c], numStr.setNum(I[c], 'f', 3));
     }
+}
 
-    i = calString.indexOf("high=");
-    if (i >= 0)
+void MainWindow::onExposureChanged(bool valid, QVector<double> means, QVector<double> variances, int frames)
+{
+    if (!valid)
     {
-        calString.remove(0, i+5);
-        tmpString = calString;
-        if (i >= 0)
-        {
-            i = tmpString.indexOf(")");
-            tmpString.truncate(i);
-            int highCal2 = tmpString.toInt();
-            numberString.setNum(highCal2);
-            ui->lineEdit_LED2_high->setText(numberString);
-        }
+        ui->exposureHeatmap->clear();
+        return;
     }
+    ui->exposureHeatmap->setValues(means, variances, frames);
 
-    qApp->processEvents();
-
-    return(true);
+    double total = 0.0;
+    for (int i=0; i<means.size(); i++)
+    {
+        total += means[i];
+    }
+    ui->trendPlot->addSample(Trend_Exposure, total);
 }
 
-/*!
- * @brief Check that the scope is connected
- *
- * @param[in] none
- * @param[out] none
- * @return none
- *
- * @author J. Peterson
- * @date 01/23/2015
-*/
-bool MainWindow::checkScope()
+void MainWindow::onDacValuesChanged(bool valid, QVector<int> dac)
 {
-    ui->label_status->setText("Checking for scope...");
-    m_serialBuffer.writeLine("em_style=1");
-    m_serialBuffer.readString();
-    m_serialBuffer.writeLine("em=-1");
-    QString em_string = m_serialBuffer.readString();
-    if (em_string.isEmpty())
+    QLineEdit *dacField[FORM_CHANNELS] = { ui->lineEdit_dac1, ui->lineEdit_dac2 };
+    const int dacTrend[FORM_CHANNELS] = { Trend_Dac1, Trend_Dac2 };
+
+    QString numStr;
+    for (int c=0; c<FORM_CHANNELS; c++)
     {
-        QString msg = "Scope not detected.\n\nEnsure that the scope is connected and installed in the calibration fixture.";
-        errorMessage(msg);
-        return(false);
+        if (!valid || (c >= dac.size()))
+        {
+            setFieldText(dacField[c], "");
+            continue;
+        }
+        ui->trendPlot->addSample(dacTrend[c], dac[c]);
+        setFieldText(dacField[c], numStr.setNum(dac[c]));
     }
-    m_serialBuffer.writeLine("em_style=0");
+}
 
-    return(true);
+void MainWindow::onNewCalibrationChanged(QVector<int> low, QVector<int> high)
+{
+    QLineEdit *lowField[FORM_CHANNELS] = { ui->lineEdit_LED1_low_final, ui->lineEdit_LED2_low_final };
+    QLineEdit *highField[FORM_CHANNELS] = { ui->lineEdit_LED1_high_final, ui->lineEdit_LED2_high_final };
+    setThresholdFields(lowField, highField, low, high);
 }
 
+void MainWindow::onCalibrationFinished(CCalibrationResult result)
+{
+    m_engineRunning = false;
+    m_reportWriter->write(ui->lineEdit_logFile->text(), result);
+    showAlerts(result);
+    m_throughput.add(result);
+    updateDashboard();
 
+    //
+    // Whatever the outcome, this unit must leave the fixture before
+    // production mode starts the next calibration.
+    //
+    m_waitForRemoval = true;
+    ui->pushButton->setEnabled(true);
 
+    if (m_runOrigin == Origin_Queue)
+    {
+        m_runOrigin = Origin_Operator;
+        finishQueuedUnit(result.m_success, result.m_serialNumber);
+    }
+}
 
-/*!
- * @brief
- *
- * @param[in] none
- * @param[out] none
- * @return none
- *
- * @author J. Peterson
- * @date 01/23/2015
-*/
-void MainWindow::updateDACValues()
+void MainWindow::onStationStatusChanged(int station, QString text)
 {
-    m_serialBuffer.writeLine("led_dac");
-    QString response = m_serialBuffer.readString();
-    double X1, X2, index;
-    QString tmpStr;
+    QTableWidgetItem *item = ui->tableWidget_stations->item(station, 2);
+    if (item)
+    {
+        item->setText(text);
+    }
+}
 
-    tmpStr = response;
-    index = tmpStr.indexOf("led1=");
-    tmpStr.remove(0, index+5);
-    tmpStr.truncate(tmpStr.indexOf(","));
-    X1 = tmpStr.toDouble();
+void MainWindow::onStationFinished(int station, CCalibrationResult result)
+{
+    showAlerts(result);
+    m_throughput.add(result);
+    updateDashboard();
 
-    tmpStr = response;
-    index = tmpStr.indexOf("led2=");
-    tmpStr.remove(0, index+5);
-    X2 = tmpStr.toDouble();
+    QTableWidgetItem *item = ui->tableWidget_stations->item(station, 3);
+    if (!item)
+    {
+        return;
+    }
 
-    QString numStr;
-    ui->lineEdit_dac1->setText(numStr.setNum(X1));
-    ui->lineEdit_dac2->setText(numStr.setNum(X2));
+    if (result.m_success)
+    {
+        QStringList values;
+        for (int c=0; c<result.m_channels; c++)
+        {
+            values << QString("%1 %2").arg(result.m_low[c]).arg(result.m_high[c]);
+        }
+        item->setText(values.join(" / "));
+        ui->tableWidget_stations->item(station, 1)->setText("");
+    }
+    else
+    {
+        item->setText(result.m_error.section('\n', 0, 0));
+    }
+}
 
-    qApp->processEvents();
+void MainWindow::onStationConfirmationRequested(int station, QString text)
+{
+    QString msg = QString("Station %1:\n").arg(m_scheduler->stationPort(station));
+    msg.append(text);
+    m_scheduler->confirm(station, engineConfirmation(msg, false));
 }
 
 
 /*!
- * @brief
+ * @brief shows the parts of the real-time mode an engine thread could not apply
  *
- * @param[in] none
- * @param[out] none
- * @return none
+ * @param[in] problems - the parts, joined into one line
  *
- * @author J. Peterson
- * @date 01/23/2015
+ * @author agent
+ * @date 10/18/2026
 */
-void MainWindow::setDACValues(int dac1, int dac2)
+void MainWindow::onRealTimeModeIncomplete(QString problems)
 {
-    QString command = QString("led_dac=%1,%2").arg(dac1).arg(dac2);
-    m_serialBuffer.writeLine(command.toLocal8Bit().data());
-    m_serialBuffer.readString();
-
-    snooze(100);
-    updateDACValues();
-    getCurrentAndVoltage();
-    getExposure();
-
-    m_dac1 = dac1;
-    m_dac2 = dac2;
+    ui->statusBar->showMessage("Real-time mode incomplete: " + problems);
 }
 
 
 /*!
- * @brief
+ * @brief turns production mode on or off
  *
- * @param[in] none
- * @param[out] none
- * @return none
+ * In production mode a calibration of the first queued serial number
+ * starts as soon as a new scope is detected.
  *
- * @author J. Peterson
- * @date 01/23/2015
+ * @param[in] on - true to enable production mode
+ *
+ * @author agent
+ * @date 10/18/2026
 */
-bool MainWindow::findCalibration()
+void MainWindow::setProductionMode(bool on)
 {
-    ui->lineEdit_LED1_low_final->setText("");
-    ui->lineEdit_LED2_low_final->setText("");
-    ui->lineEdit_LED1_high_final->setText("");
-    ui->lineEdit_LED2_high_final->setText("");
+    m_productionMode = on;
+    m_waitForRemoval = false;
 
-    int X1, X2, M;
-    QString numStr;
-
-    X1 = 0;
-    X2 = 16384;
-    M = (X1+X2)/2;
-    setDACValues(M, 0);
-    snooze(100);
-    while ( X1 < (X2-1) )
+    if (on)
     {
-        M = (X1+X2)/2;
-        setDACValues(M, 0);
-        if (m_totalExposure == 0)
-        {
-            X1 = M;
-        }
-        else
-        {
-            X2 = M;
-        }
+        ui->lineEdit_queueEntry->setFocus();
     }
-    m_calibrationLow_1 = X1;
-    ui->lineEdit_LED1_low_final->setText(numStr.setNum(m_calibrationLow_1));
+    updateProductionStatus();
+}
 
-    X1 = 0;
-    X2 = 16384;
-    M = (X1+X2)/2;
-    setDACValues(0, M);
-    snooze(100);
-    while ( X1 < (X2-1) )
-    {
-        M = (X1+X2)/2;
-        setDACValues(0, M);
-        if (m_totalExposure == 0)
-        {
-            X1 = M;
-        }
-        else
-        {
-            X2 = M;
-        }
-    }
-    m_calibrationLow_2 = X1;
-    ui->lineEdit_LED2_low_final->setText(numStr.setNum(m_calibrationLow_2));
 
-    X1 = 48152;
-    X2 = 65535;
-    M = (X1+X2)/2;
-    setDACValues(X1, 0);
-    snooze(100);
-    while ( X1 < (X2-1) )
+/*!
+ * @brief adds the scanned/typed serial number to the end of the queue
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::addToQueue()
+{
+    QString serialNumber = ui->lineEdit_queueEntry->text().trimmed();
+    ui->lineEdit_queueEntry->clear();
+    if (serialNumber.isEmpty())
     {
-        M = (X1+X2)/2;
-        setDACValues(M, 0);
-        snooze(200);
-        if (m_I1 <= 5.25)
-        {
-            X1 = M;
-        }
-        else
-        {
-            X2 = M;
-        }
+        return;
     }
-    m_calibrationHigh_1 = X1;
-    ui->lineEdit_LED1_high_final->setText(numStr.setNum(m_calibrationHigh_1));
 
-    X1 = 48152;
-    X2 = 65535;
-    M = (X1+X2)/2;
-    setDACValues(0, X1);
-    snooze(100);
-    while ( X1 < (X2-1) )
+    if (!ui->listWidget_queue->findItems(serialNumber, Qt::MatchExactly).isEmpty())
     {
-        M = (X1+X2)/2;
-        setDACValues(0, M);
-        snooze(200);
-        if (m_I2 <= 5.25)
-        {
-            X1 = M;
-        }
-        else
-        {
-            X2 = M;
-        }
+        errorMessage(QString("Serial number %1 is already queued.").arg(serialNumber));
+        return;
     }
-    m_calibrationHigh_2 = X1;
-    ui->lineEdit_LED2_high_final->setText(numStr.setNum(m_calibrationHigh_2));
 
+    ui->listWidget_queue->addItem(serialNumber);
+    updateProductionStatus();
+}
 
-    setDACValues(m_calibrationLow_1, m_calibrationLow_2);
 
-    qApp->processEvents();
-    return(true);
+void MainWindow::clearQueue()
+{
+    ui->listWidget_queue->clear();
+    updateProductionStatus();
 }
 
+
 /*!
- * @brief
+ * @brief lists the drift and outlier alerts of a calibration run
  *
- * @param[in] none
- * @param[out] none
- * @return none
+ * The newest alert is at the top.  Alerts stay until they are cleared so
+ * an alert raised on a station is not missed.
  *
- * @author J. Peterson
- * @date 01/23/2015
+ * @param[in] result - outcome of the run
+ *
+ * @author agent
+ * @date 10/18/2026
 */
-void MainWindow::saveCalibration()
+void MainWindow::showAlerts(const CCalibrationResult &result)
 {
-    QString response;
-    QString command;
-
-    command = QString("led_cal=0,%1,%2").arg(m_calibrationLow_1).arg(m_calibrationHigh_1);
-    m_serialBuffer.writeLine(command.toLocal8Bit().data());
-    response = m_serialBuffer.readString();
-
-    command = QString("led_cal=1,%1,%2").arg(m_calibrationLow_2).arg(m_calibrationHigh_2);
-    m_serialBuffer.writeLine(command.toLocal8Bit().data());
-    response = m_serialBuffer.readString();
+    for (int i=0; i<result.m_alerts.size(); i++)
+    {
+        QString text = QString("%1 %2 (%3): %4").arg(QDateTime::currentDateTime().toString("hh:mm"))
+                                                .arg(result.m_station)
+                                                .arg(result.m_serialNumber)
+                                                .arg(result.m_alerts[i]);
+        QListWidgetItem *item = new QListWidgetItem(text);
+        item->setForeground(Qt::red);
+        ui->listWidget_alerts->insertItem(0, item);
+    }
+    ui->groupBox_drift->setTitle(QString("Drift Alerts (%1)").arg(ui->listWidget_alerts->count()));
 }
 
 
-
-bool MainWindow::getFirmwareVersion()
+/*!
+ * @brief refreshes the throughput dashboard
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::updateDashboard()
 {
-    int i;
-
-    //
-    // Issue the command and check the return
-    //
-    if (!m_serialBuffer.writeLine("version"))
+    int runs = m_throughput.runCount();
+    if (runs == 0)
     {
-        return(false);
+        ui->label_throughput->setText("no calibrations in the last hour");
     }
-
-    QString ver_FPGA = m_serialBuffer.readString();
-    i = ver_FPGA.indexOf("FPGA: ");
-    if (i >= 0)
+    else
     {
-        ver_FPGA.remove(0, i+6);
-        i = ver_FPGA.indexOf("\r\n");
-        if (i >= 0)
-        {
-            ver_FPGA.truncate(i);
-        }
-        ui->lineEdit_ver_FPGA->setText(ver_FPGA);
+        ui->label_throughput->setText(QString("%1 units/hour    %2 runs    %3% failed    %4% retried")
+                                      .arg(m_throughput.unitsPerHour(), 0, 'f', 1)
+                                      .arg(runs)
+                                      .arg(100.0 * m_throughput.failureRate(), 0, 'f', 0)
+                                      .arg(100.0 * m_throughput.retryRate(), 0, 'f', 0));
     }
 
-    QString ver_ARM  = m_serialBuffer.readString();
-    i = ver_ARM.indexOf("ARM: ");
-    if (i >= 0)
+    for (int i=0; i<TIMING_PHASES; i++)
     {
-        ver_ARM.remove(0, i+5);
-        i = ver_ARM.indexOf(" ");
-        if (i >= 0)
+        qint64 times[2] = { m_throughput.phasePercentile(i, 0.5), m_throughput.phasePercentile(i, 0.95) };
+        for (int column=0; column<2; column++)
         {
-            ver_ARM.truncate(i);
+            QTableWidgetItem *item = ui->tableWidget_phases->item(i, column);
+            if (!item)
+            {
+                item = new QTableWidgetItem();
+                ui->tableWidget_phases->setItem(i, column, item);
+            }
+            item->setText((times[column] < 0) ? QString("-") : QString::number(times[column] / 1000.0, 'f', 1));
         }
-        ui->lineEdit_ver_ARM->setText(ver_ARM);
     }
+}
 
-    QString ver_DSP  = m_serialBuffer.readString();
-    i = ver_DSP.indexOf("DSP: ");
-    if (i >= 0)
-    {
-        ver_DSP.remove(0, i+5);
-        i = ver_DSP.indexOf(" ");
-        if (i >= 0)
-        {
-            ver_DSP.truncate(i);
-        }
-        ui->lineEdit_ver_DSP->setText(ver_DSP);
-    }
 
-    qApp->processEvents();
-    return(true);
+void MainWindow::clearAlerts()
+{
+    ui->listWidget_alerts->clear();
+    ui->groupBox_drift->setTitle("Drift Alerts");
 }
 
-bool MainWindow::getDacValues()
+
+/*!
+ * @brief starts the calibration of the unit in the fixture as the first queued serial number
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::startNextQueuedUnit()
 {
-    bool sawError = false;
-    double X1, X2;
+    QString serialNumber = ui->listWidget_queue->item(0)->text();
+    ui->lineEdit_serialNumber->setText(serialNumber);
 
-    if (m_serialBuffer.writeLine("led_dac"))
+    if (runCalibration(Origin_Queue))
     {
-        QString response = m_serialBuffer.readString();
-        int index;
-        QString tmpStr;
+        return;
+    }
+    finishQueuedUnit(false, serialNumber);
+}
 
-        bool conversionWasOk = false;
-        tmpStr = response;
-        index = tmpStr.indexOf("led1=");
-        if (index >= 0)
-        {
-            tmpStr.remove(0, index+5);
-            index = tmpStr.indexOf(",");
-            if (index >= 0)
-            {
-                tmpStr.truncate(index);
-                X1 = tmpStr.toDouble(&conversionWasOk);
-            }
-        }
-        if (!conversionWasOk)
-        {
-            sawError = true;
-        }
 
-        conversionWasOk = false;
-        tmpStr = response;
-        index = tmpStr.indexOf("led2=");
-        if (index >= 0)
-        {
-            tmpStr.remove(0, index+5);
-            X2 = tmpStr.toDouble(&conversionWasOk);
-        }
-        if (!conversionWasOk)
+/*!
+ * @brief advances the queue after the calibration of its first unit
+ *
+ * The queue advances when the calibration passes.  On a failure production
+ * mode is paused so the failed unit can not be confused with the next one.
+ *
+ * @param[in] passed - outcome of the calibration
+ * @param[in] serialNumber - the unit
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::finishQueuedUnit(bool passed, QString serialNumber)
+{
+    if (passed)
+    {
+        delete ui->listWidget_queue->takeItem(0);
+
+        m_completionTimes.append(QDateTime::currentMSecsSinceEpoch());
+        while (m_completionTimes.size() > 20)
         {
-            sawError = true;
+            m_completionTimes.removeFirst();
         }
     }
-
-    if (sawError)
-    {
-        ui->lineEdit_dac1->setText("");
-        ui->lineEdit_dac2->setText("");
-    }
     else
     {
-        QString numStr;
-        ui->lineEdit_dac1->setText(numStr.setNum(X1));
-        ui->lineEdit_dac2->setText(numStr.setNum(X2));
+        ui->checkBox_production->setChecked(false);
+        ui->label_status->setText(QString("Production paused: calibration of %1 failed").arg(serialNumber));
     }
 
-    qApp->processEvents();
-    return(!sawError);
-
+    updateProductionStatus();
 }
 
-void MainWindow::clearInfoFields()
-{
-    ui->lineEdit_ver_ARM->clear();
-    ui->lineEdit_ver_DSP->clear();
-    ui->lineEdit_ver_FPGA->clear();
-    ui->lineEdit_LED1_high->clear();
-    ui->lineEdit_LED1_low->clear();
-    ui->lineEdit_LED2_high->clear();
-    ui->lineEdit_LED2_low->clear();
-    ui->lineEdit_amps1->clear();
-    ui->lineEdit_amps2->clear();
-    ui->lineEdit_volts1->clear();
-    ui->lineEdit_volts2->clear();
 
-    clearExposureAndDacFields();
-}
-
-void MainWindow::clearExposureAndDacFields()
+/*!
+ * @brief calibrates the unit in the fixture for the next automation request
+ *
+ * The request is run exactly like a calibration started with the Start
+ * button.  If the calibration could not even be started, e.g. because no
+ * operator name was entered, the job is failed so the client is not left
+ * waiting.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::startNextAutomationJob()
 {
-    ui->lineEdit_em_11->clear();
-    ui->lineEdit_em_12->clear();
-    ui->lineEdit_em_13->clear();
-    ui->lineEdit_em_14->clear();
-    ui->lineEdit_em_15->clear();
-
-    ui->lineEdit_em_21->clear();
-    ui->lineEdit_em_22->clear();
-    ui->lineEdit_em_23->clear();
-    ui->lineEdit_em_24->clear();
-    ui->lineEdit_em_25->clear();
-
-    ui->lineEdit_em_31->clear();
-    ui->lineEdit_em_32->clear();
-    ui->lineEdit_em_33->clear();
-    ui->lineEdit_em_34->clear();
-    ui->lineEdit_em_35->clear();
-
-    ui->lineEdit_em_41->clear();
-    ui->lineEdit_em_42->clear();
-    ui->lineEdit_em_43->clear();
-    ui->lineEdit_em_44->clear();
-    ui->lineEdit_em_45->clear();
+    int id;
+    QString serialNumber;
+    QString operatorName;
+    if (!m_automation->takeNextJob(&id, &serialNumber, &operatorName))
+    {
+        return;
+    }
 
-    ui->lineEdit_em_51->clear();
-    ui->lineEdit_em_52->clear();
-    ui->lineEdit_em_53->clear();
-    ui->lineEdit_em_54->clear();
-    ui->lineEdit_em_55->clear();
+    ui->lineEdit_serialNumber->setText(serialNumber);
+    if (!operatorName.isEmpty())
+    {
+        ui->lineEdit_operator->setText(operatorName);
+    }
 
-    ui->lineEdit_dac1->clear();
-    ui->lineEdit_dac2->clear();
+    if (!runCalibration(Origin_Automation))
+    {
+        CCalibrationResult result;
+        result.m_station = m_serialPortName;
+        result.m_serialNumber = serialNumber;
+        result.m_operator = operatorName;
+        result.m_startTime = QDateTime::currentDateTime();
+        result.m_error = "The calibration could not be started; check the operator name and serial port.";
+        m_automation->jobFinished(result);
+    }
 }
 
 
+/*!
+ * @brief shows the production rate and queue length in the status bar
+ *
+ * The rate is taken over the last (up to) 20 passed units.
+ *
+ * @author agent
+ * @date 10/18/2026
+*/
+void MainWindow::updateProductionStatus()
+{
+    QString msg = QString("%1 queued").arg(ui->listWidget_queue->count());
 
+    int n = m_completionTimes.size();
+    if (n >= 2)
+    {
+        qint64 span = m_completionTimes.last() - m_completionTimes.first();
+        if (span > 0)
+        {
+            double unitsPerHour = (n - 1) * 3600000.0 / span;
+            msg.append(QString(", %1 units/hour").arg(unitsPerHour, 0, 'f', 1));
+        }
+    }
 
-
-
-
+    if (m_productionMode)
+    {
+        msg.prepend("Production: ");
+    }
+    ui->statusBar->showMessage(msg);
+}
@@ -11,6 +11,14 @@
  *  Version | Author       | Date        | Description
  *  :--:    | :-----       | :--:        | :----------
  *   1      | J. Peterson  | 01/12/2015  | initial version
+ *   2      | agent        | 10/18/2026  | calibration moved to CCalibrationEngine, added stations
+ *   3      | agent        | 10/18/2026  | calibration runs without blocking the window
+ *   4      | agent        | 10/18/2026  | reports reloads of the calibration profile
+ *   5      | agent        | 10/18/2026  | readings and thresholds as one value per LED channel
+ *   6      | agent        | 10/18/2026  | engine messages do not block the stations
+ *   7      | agent        | 10/18/2026  | only unattended runs decline confirmations
+ *   8      | agent        | 10/18/2026  | idle monitor reported by the engine's signal
+ *   9      | agent        | 10/18/2026  | primary engine in a real-time thread of its own
  *
 */
 
@@ -18,12 +26,21 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QMutex>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
 #include "Settings.h"
-#include "SerialBuffer.h"
+#include "CalibrationEngine.h"
+#include "StationScheduler.h"
+#include "ReportWriter.h"
+#include "ThroughputStats.h"
+#include "Metrics.h"
+#include "AutomationServer.h"
+#include "RealTime.h"
 
 #define VERSION_STRING "0.6"
 
+class QMessageBox;
 
 namespace Ui
 {
@@ -33,7 +50,7 @@ namespace Ui
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
-    
+
 public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
@@ -42,29 +59,58 @@ private:
     void timerEvent(QTimerEvent *);
     void errorMessage(QString msg);
     bool yesNoMessage(QString msg);
+    void engineMessage(QString msg);
+    bool engineConfirmation(QString msg, bool unattended);
 
     bool checkFields();
     void clearInfoFields();
     void clearExposureAndDacFields();
-
-    bool getFirmwareVersion();
-    bool getCurrentCalibrationValues();
-    bool getDacValues();
-    bool getCurrentAndVoltage();
-    bool getExposure();
-
-    bool establishConnectionToController();
-    bool checkScope();
-    bool findCalibration();
-
-    void updateDACValues();
-    void setDACValues(int dac1, int dac2);
-    void saveCalibration();
+    void initStationTable();
+    bool runCalibration(int origin);
+    void startNextQueuedUnit();
+    void finishQueuedUnit(bool passed, QString serialNumber);
+    void startNextAutomationJob();
+    void updateProductionStatus();
+    void showAlerts(const CCalibrationResult &result);
+    void updateDashboard();
 
 public slots:
     void selectSerialPort();
     void startCalibration();
-    
+    void startStations();
+    void setProductionMode(bool on);
+    void addToQueue();
+    void clearQueue();
+    void clearAlerts();
+
+private slots:
+    void onStatusChanged(QString text);
+    void onErrorOccurred(QString text);
+    void onProfileLoaded(QString name);
+    void onProfileRejected(QString name, QString errors);
+    void onConfirmationRequested(QString text);
+    void onFirmwareVersionChanged(QString arm, QString dsp, QString fpga);
+    void onStoredCalibrationChanged(QVector<int> low, QVector<int> high);
+    void onCurrentAndVoltageChanged(bool valid, QVector<double> V, QVector<double> I);
+    void onExposureChanged(bool valid, QVector<double> means, QVector<double> variances, int frames);
+    void onDacValuesChanged(bool valid, QVector<int> dac);
+    void onNewCalibrationChanged(QVector<int> low, QVector<int> high);
+    void onCalibrationFinished(CCalibrationResult result);
+    void onMonitorStateChanged(int state);
+    void onStationStatusChanged(int station, QString text);
+    void onStationFinished(int station, CCalibrationResult result);
+    void onStationConfirmationRequested(int station, QString text);
+    void onRealTimeModeIncomplete(QString problems);
+
+private:
+    //! who started the calibration on the primary port
+    enum RunOrigin
+    {
+        Origin_Operator,        // Start button
+        Origin_Queue,           // production queue
+        Origin_Automation       // automation job
+    };
+
 private:
     Ui::MainWindow *ui;
 
@@ -72,22 +118,24 @@ private:
     QString       m_serialNumber;
     QString       m_serialPortName;
 
-    CSettings     m_settings;
-    CSerialBuffer m_serialBuffer;
-    int           m_timerID;
-    QMutex        m_mutex;
-
-    int           m_totalExposure;
-    double        m_I1;
-    double        m_I2;
-    double        m_V1;
-    double        m_V2;
-    int           m_calibrationLow_1;
-    int           m_calibrationHigh_1;
-    int           m_calibrationLow_2;
-    int           m_calibrationHigh_2;
-    int           m_dac1;
-    int           m_dac2;
+    CSettings           m_settings;
+    CCalibrationEngine *m_engine;       // engine of the primary port, deleted when its thread finishes
+    CRealTimeThread    *m_engineThread; // thread of m_engine
+    CStationScheduler  *m_scheduler;
+    CReportWriter      *m_reportWriter;
+    CMetricsExporter   *m_metricsExporter;
+    CAutomationServer  *m_automation;   // 0 if the automation API is disabled
+    int                 m_timerID;
+    QMessageBox        *m_engineMessage;    // non-modal box of engine errors, 0 until the first
+
+    bool          m_productionMode;     // auto-start queued units on scope detection
+    bool          m_waitForRemoval;     // unit in the fixture has already been calibrated
+    int           m_runOrigin;          // RunOrigin of the running calibration on the primary port
+    bool          m_engineRunning;      // a calibration is running on the primary port
+    QList<qint64> m_completionTimes;    // msecs since epoch of the last few passed units
+
+    CThroughputStats m_throughput;      // dashboard statistics of all stations
+    QElapsedTimer    m_dashboardRefresh;    // last refresh of the dashboard by the timer
 };
 
 #endif // MAINWINDOW_H
@@ -11,6 +11,7 @@
  *  Version | Author       | Date        | Description
  *  :--:    | :-----       | :--:        | :----------
  *   1      | J. Peterson  | 01/12/2015  | initial version
+ *   2      | agent        | 10/18/2026  | ports probed in parallel and labelled, hotplug
  *
 */
 
@@ -18,6 +19,11 @@
 #define SERIALPORTDIALOG_H
 
 #include <QDialog>
+#include <QMap>
+#include <QList>
+#include <QStringList>
+
+class QThread;
 
 namespace Ui {
 class CSerialPortDialog;
@@ -32,11 +38,29 @@ public:
     ~CSerialPortDialog();
     QString getSelection();
 
-private:
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private slots:
     void refreshSerialPortList();
+    void onProbed(QString portName, int state, QString arm, QString dsp, QString fpga);
+    void onUserSelection(int index);
+
+private:
+    void updatePortList(bool reprobe);
+    void startProbe(QString portName);
+    void fillComboBox();
     
 private:
     Ui::CSerialPortDialog *ui;
+
+    QStringList            m_ports;         // ports present at the last scan
+    QMap<QString, QString> m_labels;        // port name -> description from the probe
+    QMap<QString, QString> m_controllers;   // ports with a controller -> firmware versions
+    QStringList            m_probing;       // ports whose probe is still running
+    QList<QThread *>       m_threads;       // probe threads, waited for on close
+    int                    m_timerID;       // hotplug scan
+    bool                   m_userSelected;  // the operator picked a port, no auto-select
 };
 
 #endif // SERIALPORTDIALOG_H